@@ -6,7 +6,22 @@
 
 #include "Configuration/CommandLineParser.hpp"
 #include "Configuration/CommandLineSpecification.hpp"
+#include "Configuration/CompiledCommandLineSpecification.hpp"
 #include "Configuration/Configuration.hpp"
+#include "Configuration/ConfigurationArena.hpp"
+#include "Configuration/ConfigurationFileWatcher.hpp"
+#include "Configuration/ConfigurationParseError.hpp"
+#include "Configuration/ConfigurationPatch.hpp"
+#include "Configuration/ConfigurationSnapshot.hpp"
+#include "Configuration/ConfigurationStore.hpp"
+#include "Configuration/ConfigurationSubscriptions.hpp"
+#include "Configuration/DefaultedConfiguration.hpp"
+#include "Configuration/EnvironmentParser.hpp"
+#include "Configuration/INIConfigurationParser.hpp"
+#include "Configuration/JSONConfigurationParser.hpp"
+#include "Configuration/LayeredConfiguration.hpp"
+#include "Configuration/MemoryMappedFile.hpp"
+#include "Configuration/PerfectHashIndex.hpp"
 #include "Configuration/linkoptions.hpp"
 
 #endif
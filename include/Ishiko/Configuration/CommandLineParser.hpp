@@ -5,23 +5,100 @@
 #define GUARD_ISHIKO_CPP_CONFIGURATION_COMMANDLINEPARSER_HPP
 
 #include "CommandLineSpecification.hpp"
+#include "CompiledCommandLineSpecification.hpp"
 #include "Configuration.hpp"
+#include <string>
+#include <vector>
 
 namespace Ishiko
 {
+    // The arguments are tokenized in place, memory is only allocated for the names and values that are stored in
+    // the configuration. Positional and short named arguments that don't match the specification are ignored, and so
+    // are positional arguments whose value isn't one of the allowed values of their option. The values of options
+    // that have a value type other than string are converted, the parse functions throw std::invalid_argument if that
+    // fails.
+    //
+    // If response files are enabled an argument of the form @file is replaced by the arguments in the file, which is
+    // how command lines longer than the system allows are passed, and an argument that starts with "@@" is taken as
+    // is with the first '@' removed. They are disabled by default, arguments that start with '@' are then taken as
+    // is. The arguments in the file are separated by whitespace, quotes group characters into a single argument and
+    // a backslash escapes the next character, except inside single quotes where it is literal and inside double
+    // quotes where it only escapes '"' and '\\'. Response files can name other response files, relative paths are
+    // relative to the current directory. The file is mapped in memory and the arguments are parsed as they are read,
+    // without making a copy of them. The parse functions throw std::system_error if a response file can't be read,
+    // which includes files that aren't regular files such as pipes, and ConfigurationParseError if a quote isn't
+    // closed or a response file names itself, directly or through other response files.
+    //
+    // Parsing only reads the specification so any number of threads can parse with the same specification
+    // concurrently, as long as it isn't modified while they do.
     class CommandLineParser
     {
     public:
+        // Whether arguments of the form @file are replaced by the arguments in the file
+        enum class ResponseFiles
+        {
+            disabled,
+            enabled
+        };
+
+        // Parses command lines with the same specification over and over, reusing the same storage. Each parse starts
+        // from the defaults of the specification, which are created once, and the configuration of the previous parse
+        // is reset to them in place. Once the buffers have grown to the size the command lines need, options that
+        // have a default value are parsed without any heap allocation.
+        //
+        // A session is not thread-safe.
+        class Session
+        {
+        public:
+            explicit Session(const CommandLineSpecification& specification,
+                ResponseFiles response_files = ResponseFiles::disabled);
+            explicit Session(const CompiledCommandLineSpecification& specification,
+                ResponseFiles response_files = ResponseFiles::disabled);
+
+            // The returned configuration is reset by the next call to parse, copy it to keep it. The next parse then
+            // can't reuse the storage shared with the copy, and allocates it again.
+            const Configuration& parse(int argc, const char* argv[]);
+            const Configuration& parse(int argc, char* argv[]);
+
+        private:
+            CompiledCommandLineSpecification m_specification;
+            ResponseFiles m_response_files;
+            Configuration m_defaults;
+            Configuration m_configuration;
+            std::string m_lookup_name;
+            std::string m_lookup_value;
+        };
+
         // TODO: document the fact that callers needs to call specification.createDefaultConfiuration to populate
         // configuration with the defaults before calling this function. This is because options may be initialized in
         // several steps so we can't assume creating the default in this function is the right place.
         static void parse(const CommandLineSpecification& specification, int argc, const char* argv[],
-            Configuration& configuration);
+            Configuration& configuration, ResponseFiles response_files = ResponseFiles::disabled);
         // TODO: document the fact that callers needs to call specification.createDefaultConfiuration to populate
         // configuration with the defaults before calling this function. This is because options may be initialized in
         // several steps so we can't assume creating the default in this function is the right place.
         static void parse(const CommandLineSpecification& specification, int argc, char* argv[],
-            Configuration& configuration);
+            Configuration& configuration, ResponseFiles response_files = ResponseFiles::disabled);
+
+        // Same as above but the lookups are done on the compiled specification, an immutable copy of the
+        // specification whose options are found through perfect hash tables. This only pays off for large option
+        // sets, with a few options or a shallow command tree the overloads above are as fast or faster.
+        static void parse(const CompiledCommandLineSpecification& specification, int argc, const char* argv[],
+            Configuration& configuration, ResponseFiles response_files = ResponseFiles::disabled);
+        static void parse(const CompiledCommandLineSpecification& specification, int argc, char* argv[],
+            Configuration& configuration, ResponseFiles response_files = ResponseFiles::disabled);
+
+        // Parses each command line, in argv form, into its own configuration. The command lines are split between
+        // thread_count threads, or one per core if thread_count is 0, and the configurations are returned in the same
+        // order as the command lines. Like parse, the configurations don't include the default values. Response files
+        // are not expanded unless they are enabled: command lines replayed from logs would otherwise open any file
+        // they name.
+        static std::vector<Configuration> parseBatch(const CommandLineSpecification& specification,
+            const std::vector<std::vector<const char*>>& command_lines, size_t thread_count = 0,
+            ResponseFiles response_files = ResponseFiles::disabled);
+        static std::vector<Configuration> parseBatch(const CompiledCommandLineSpecification& specification,
+            const std::vector<std::vector<const char*>>& command_lines, size_t thread_count = 0,
+            ResponseFiles response_files = ResponseFiles::disabled);
     };
 }
 
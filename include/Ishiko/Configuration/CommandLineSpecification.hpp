@@ -6,13 +6,17 @@
 
 #include "Configuration.hpp"
 #include <boost/optional.hpp>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace Ishiko
 {
+    class CompiledCommandLineSpecification;
+
     class CommandLineSpecification
     {
     public:
@@ -23,6 +27,12 @@ namespace Ishiko
             toggle
         };
 
+        enum class CaseSensitivity
+        {
+            sensitive,
+            insensitive
+        };
+
         class OptionDetails
         {
         public:
@@ -31,16 +41,42 @@ namespace Ishiko
             OptionDetails(OptionType type, std::string default_value);
 
             OptionType type() const noexcept;
+            // The type of the values stored in the configuration, values are converted from strings by
+            // createValue. The default is Configuration::Value::Type::string.
+            Configuration::Value::Type valueType() const noexcept;
             const boost::optional<std::string>& defaultValue() const noexcept;
+            // If no restrictions have been set all values are allowed. Otherwise the value is allowed if it is one of
+            // the allowed values, or is an integer in the allowed range, or matches the allowed pattern.
             bool isValueAllowed(const std::string& value) const noexcept;
             void setDefaultValue(const boost::optional<std::string>& value);
             void setDefaultValue(const char* value);
-            void setAllowedValues(const std::vector<std::string>& values);
+            // Only the types that have a text representation can be used, see Configuration::Value::Parse. Throws
+            // std::invalid_argument for Type::string_array and Type::configuration.
+            void setValueType(Configuration::Value::Type type);
+            // Converts the text to the value type of the option. A toggle of type boolean that is given without a
+            // value is true. Throws std::invalid_argument if the text can't be converted.
+            Configuration::Value createValue(boost::string_view text) const;
+            // The values are stored in a hash set so checking a value doesn't depend on the number of allowed values
+            void setAllowedValues(const std::vector<std::string>& values,
+                CaseSensitivity case_sensitivity = CaseSensitivity::sensitive);
+            // Allows integers between minimum and maximum, both included
+            void setAllowedRange(int64_t minimum, int64_t maximum);
+            // Allows values that entirely match the ECMAScript regular expression. The expression is compiled here
+            // and shared between the copies of these details.
+            void setAllowedPattern(const std::string& pattern);
 
         private:
+            // Defined in the source file so that this header doesn't include <regex> and <unordered_set>. They are
+            // immutable once created so the copies of these details share them.
+            class AllowedValueSet;
+            class AllowedPattern;
+
             OptionType m_type;
+            Configuration::Value::Type m_value_type;
             boost::optional<std::string> m_default_value;
-            std::vector<std::string> m_allowed_values;
+            std::shared_ptr<const AllowedValueSet> m_allowed_values;
+            boost::optional<std::pair<int64_t, int64_t>> m_allowed_range;
+            std::shared_ptr<const AllowedPattern> m_allowed_pattern;
         };
 
         class CommandDetails
@@ -48,18 +84,31 @@ namespace Ishiko
         public:
             void addPositionalOption(size_t position, const std::string& name, const OptionDetails& details);
             bool findPositionalOption(size_t position, std::string& name, OptionDetails& details) const;
+            bool findPositionalOption(size_t position, const std::string*& name,
+                const OptionDetails*& details) const noexcept;
 
             CommandDetails& addCommand(const std::string& option_name, const std::string& command_name);
             bool findCommand(const std::string& option_name, const std::string& command_name,
                 CommandDetails& details) const;
+            bool findCommand(const std::string& option_name, const std::string& command_name,
+                const CommandDetails*& details) const noexcept;
 
         private:
+            friend class CompiledCommandLineSpecification;
+
             std::map<size_t, std::pair<std::string, OptionDetails>> m_positional_options;
             std::map<std::string, std::map<std::string, CommandDetails>> m_commands;
         };
 
+        // Throws std::invalid_argument if a default value can't be converted to the value type of its option
         Configuration createDefaultConfiguration() const;
 
+        // Creates an immutable copy of this specification optimized for lookups. Use it when the same specification
+        // is used to parse many command lines. The declaration of CompiledCommandLineSpecification is in
+        // CompiledCommandLineSpecification.hpp. The default values are converted to the value type of their option,
+        // which throws std::invalid_argument if that fails.
+        CompiledCommandLineSpecification compile() const;
+
         CommandDetails& addCommand(const std::string& option_name, const std::string& command_name);
         CommandDetails& addCommand(const std::string& option_name, const std::string& command_name,
             const std::string& subcommand_name);
@@ -69,18 +118,29 @@ namespace Ishiko
         void addNamedOption(const std::string& name, const OptionDetails& details);
         void addNamedOption(const std::string& name, const std::string& short_name, const OptionDetails& details);
 
+        // The overloads returning pointers give access to the details stored in the specification without copying
+        // them. The pointers remain valid until the specification is modified or destroyed.
         bool findCommand(const std::string& option_name, const std::string& command_name,
             CommandDetails& details) const;
+        bool findCommand(const std::string& option_name, const std::string& command_name,
+            const CommandDetails*& details) const noexcept;
 
         bool findPositionalOption(size_t position, std::string& name, OptionDetails& details) const;
+        bool findPositionalOption(size_t position, const std::string*& name,
+            const OptionDetails*& details) const noexcept;
 
         bool findNamedOption(const std::string& name, OptionDetails& details) const;
+        bool findNamedOption(const std::string& name, const OptionDetails*& details) const noexcept;
         bool findShortNamedOption(const std::string& short_name, std::string& name, OptionDetails& details) const;
+        bool findShortNamedOption(const std::string& short_name, const std::string*& name,
+            const OptionDetails*& details) const noexcept;
 
         void setDefaultValue(const std::string& name, const boost::optional<std::string>& value);
         void setDefaultValue(const std::string& name, const char* value);
 
     private:
+        friend class CompiledCommandLineSpecification;
+
         std::map<size_t, std::pair<std::string, OptionDetails>> m_positional_options;
         std::map<std::string, OptionDetails> m_named_options;
         std::map<std::string, std::string> m_short_named_options;
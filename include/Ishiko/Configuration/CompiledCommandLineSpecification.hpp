@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_COMPILEDCOMMANDLINESPECIFICATION_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_COMPILEDCOMMANDLINESPECIFICATION_HPP
+
+#include "CommandLineSpecification.hpp"
+#include "Configuration.hpp"
+#include "PerfectHashIndex.hpp"
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Ishiko
+{
+    // An immutable version of a CommandLineSpecification optimized for lookups. The options and the command tree are
+    // flattened into a few tables so that lookups return pointers into these tables without copying anything and
+    // descending into a subcommand is just following a pointer. Named options, short names and commands are looked up
+    // with perfect hash tables so a lookup costs one hash and one string comparison regardless of the number of
+    // options. Commands with only a few subcommands, the common case, are searched linearly instead since hashing the
+    // names costs more than comparing them.
+    //
+    // Once constructed the object is never modified so it can be shared between threads without synchronization.
+    class CompiledCommandLineSpecification
+    {
+    public:
+        struct Option
+        {
+            std::string name;
+            CommandLineSpecification::OptionDetails details;
+            // The default value converted to the value type once, so that the defaults can be read without copying
+            // or converting them
+            boost::optional<Configuration::Value> default_value;
+        };
+
+        // A node in the command tree. The root node holds the top-level positional options and commands.
+        class Command
+        {
+        private:
+            friend class CompiledCommandLineSpecification;
+
+            size_t m_index;
+            size_t m_positional_options_begin;
+            size_t m_positional_options_end;
+            size_t m_subcommands_begin;
+            size_t m_subcommands_end;
+        };
+
+        CompiledCommandLineSpecification();
+        explicit CompiledCommandLineSpecification(const CommandLineSpecification& specification);
+
+        Configuration createDefaultConfiguration() const;
+
+        const Command& root() const noexcept;
+
+        size_t namedOptionCount() const noexcept;
+        // The named options are in name order
+        const Option& namedOption(size_t index) const noexcept;
+
+        // The returned pointers remain valid for the lifetime of this object
+        const Command* findCommand(const Command& command, boost::string_view option_name,
+            boost::string_view command_name) const noexcept;
+        const Option* findPositionalOption(const Command& command, size_t position) const noexcept;
+        const Option* findNamedOption(boost::string_view name) const noexcept;
+        const Option* findShortNamedOption(boost::string_view short_name) const noexcept;
+        // The default value of the option stored with that name in the configuration of the command: the named options
+        // and the positional options of the root command for the root, the positional options of the command for the
+        // others. This is how a DefaultedConfiguration finds the defaults.
+        const Configuration::Value* findDefaultValue(const Command& command, boost::string_view name) const noexcept;
+
+    private:
+        struct Subcommand
+        {
+            size_t parent;
+            std::string option_name;
+            std::string command_name;
+            size_t command;
+        };
+
+        typedef std::map<size_t, std::pair<std::string, CommandLineSpecification::OptionDetails>>
+            PositionalOptionsMap;
+        typedef std::map<std::string, std::map<std::string, CommandLineSpecification::CommandDetails>> CommandsMap;
+
+        static Option CreateOption(const std::string& name, const CommandLineSpecification::OptionDetails& details);
+        static uint64_t HashSubcommand(size_t parent, boost::string_view option_name, boost::string_view command_name,
+            uint64_t seed) noexcept;
+
+        size_t addCommand(const PositionalOptionsMap& positional_options, const CommandsMap& commands);
+
+        std::vector<Option> m_options;
+        // Indices into m_options sorted by option name
+        std::vector<size_t> m_named_options;
+        PerfectHashIndex m_named_options_index;
+        // Short names with the index of the option in m_options, sorted by short name
+        std::vector<std::pair<std::string, size_t>> m_short_named_options;
+        PerfectHashIndex m_short_named_options_index;
+        // The positional options and subcommands of each command are stored contiguously and referenced by the
+        // ranges in Command. Positional options are sorted by position and subcommands by option and command name.
+        std::vector<Command> m_commands;
+        std::vector<std::pair<size_t, size_t>> m_positional_options;
+        std::vector<Subcommand> m_subcommands;
+        // Hashes the parent command index together with the option and command names
+        PerfectHashIndex m_subcommands_index;
+    };
+}
+
+#endif
@@ -4,18 +4,44 @@
 #ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATION_HPP
 #define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATION_HPP
 
+#include "ConfigurationArena.hpp"
+#include <boost/utility/string_view.hpp>
 #include <boost/variant.hpp>
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Ishiko
 {
+    // The options are stored in a vector sorted by name. Lookups are binary searches that take the name as a
+    // string_view so passing a literal or a std::string doesn't create any temporary, and iterating over the options
+    // always visits them in name order.
+    //
+    // The options are shared between copies and copy-on-write: copying a configuration, or a value holding one, is
+    // O(1) and the first modification of a copy only duplicates the options of that configuration. Modifying a nested
+    // configuration through value(...).asConfiguration() duplicates the configurations on the path to it, and
+    // nothing else. The non-const value functions count as modifications since they give write access to the value.
+    // References returned by the const functions remain valid, pointing to the original options, if a copy that
+    // shared them is modified.
+    //
+    // Copies sharing options can be handed to other threads and each of them read, modified or destroyed there without
+    // locking, like a std::shared_ptr. A single configuration object is not thread-safe though: it must not be
+    // modified while the same object is read or copied on another thread.
     class Configuration
     {
     public:
-        class Value : public boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>>
+        // The alternatives are in the same order as Value::Type
+        typedef boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>, int64_t,
+            double, bool, std::chrono::nanoseconds, uint64_t> ValueBase;
+
+        // Besides strings a value can hold numbers, booleans, durations and sizes. These are usually converted from
+        // strings once, when the value is set, so that reading them doesn't involve any parsing.
+        class Value : public ValueBase
         {
         public:
             enum class Type
@@ -23,6 +49,12 @@ namespace Ishiko
                 string = 0,
                 string_array = 1,
                 configuration = 2,
+                integer = 3,
+                floating_point = 4,
+                boolean = 5,
+                duration = 6,
+                // A number of bytes
+                size = 7
             };
 
             Value() = default;
@@ -30,34 +62,265 @@ namespace Ishiko
             explicit Value(const std::string& value);
             explicit Value(std::string&& value);
             explicit Value(const std::vector<std::string>& value);
+            explicit Value(std::vector<std::string>&& value);
             explicit Value(const Configuration& value);
+            explicit Value(Configuration&& value);
+            explicit Value(int64_t value);
+            explicit Value(double value);
+            explicit Value(bool value);
+            explicit Value(std::chrono::nanoseconds value);
+            explicit Value(uint64_t value);
+            // The other integer types, so that Value(5) or Value(5u) isn't ambiguous. Signed integers are stored as
+            // integers and unsigned ones as sizes, like int64_t and uint64_t.
+            template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value
+                && std::is_signed<T>::value, int>::type = 0>
+            explicit Value(T value);
+            template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value
+                && std::is_unsigned<T>::value, int>::type = 0>
+            explicit Value(T value);
+
+            // Converts text to a value of the given type. Integers and floating point numbers use the C syntax,
+            // booleans are true/false, yes/no, on/off or 1/0 in any case, durations are an integer followed by one
+            // of the units ns, us, ms, s, min or h and sizes are an integer optionally followed by B or one of the
+            // binary units K, M, G or T, or KiB, MiB, GiB or TiB. Returns false if the text is not valid for the type
+            // in which case value is not modified.
+            static bool Parse(boost::string_view text, Type type, Value& value);
 
             Type type() const;
             const std::string& asString() const;
             const std::vector<std::string>& asStringArray() const;
             const Configuration& asConfiguration() const;
             Configuration& asConfiguration();
+            int64_t asInt() const;
+            double asDouble() const;
+            bool asBool() const;
+            std::chrono::nanoseconds asDuration() const;
+            uint64_t asSize() const;
+        };
+
+        // A handle to an option that remembers where the option was found the last time it was used. Lookups with a
+        // key that was already used on the same configuration, or on a copy of it, are an array index instead of a
+        // search. The cached position is discarded as soon as options are added to the configuration and the lookup
+        // then falls back to a search by name.
+        //
+        // The cache is updated atomically so the same key can be used from several threads, for instance as a static
+        // variable.
+        class Key
+        {
+        public:
+            explicit Key(std::string name);
+            Key(const Key& other);
+            Key& operator=(const Key& other);
+
+            const std::string& name() const noexcept;
+
+        private:
+            friend class Configuration;
+
+            std::string m_name;
+            // The layout of the configuration in the high bits and the index of the option in the low bits
+            mutable std::atomic<uint64_t> m_cache;
+        };
+
+        // A sequence of keys to access an option in nested configurations, parsed once from a string like
+        // "server.tls.cert". Lookups with a path walk down the nested configurations in a single pass and, as each
+        // segment is a Key, repeated lookups with the same path are array indexing at each level.
+        class Path
+        {
+        public:
+            explicit Path(boost::string_view path);
+            // For names that contain dots
+            explicit Path(const std::vector<std::string>& names);
+
+            size_t size() const noexcept;
+            const Key& operator[](size_t index) const noexcept;
+
+        private:
+            std::vector<Key> m_keys;
         };
 
+        typedef std::pair<std::string, Value> Entry;
+        typedef std::vector<Entry, ConfigurationArena::Allocator<Entry>>::const_iterator const_iterator;
+
+        // Builds a configuration from options in any order. Setting options one at a time inserts each of them at its
+        // position in the sorted vector, which is quadratic when they are not in name order, for instance when they
+        // come from a file. A builder appends them instead and sorts them once when the configuration is built.
+        class Builder
+        {
+        public:
+            explicit Builder(ConfigurationArena* arena = nullptr);
+
+            void reserve(size_t size);
+            // If the same name is added more than once the last value is kept
+            void add(std::string name, Value value);
+            size_t size() const noexcept;
+            // Leaves the builder empty, ready to build another configuration. The builder keeps its buffer so reusing
+            // it for many configurations, for instance one per nesting level in a parser, doesn't allocate it again.
+            Configuration build();
+
+        private:
+            std::vector<Entry, ConfigurationArena::Allocator<Entry>> m_options;
+            bool m_sorted;
+            std::vector<Entry*> m_order;
+        };
+
+        Configuration() noexcept;
+        // The options, and the options of the nested configurations created by set(const Path&, ...), are allocated
+        // from the arena, or from the heap if it is null. Copies share the options so they must not outlive the
+        // arena either.
+        explicit Configuration(ConfigurationArena* arena) noexcept;
+
         size_t size() const;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        ConfigurationArena* arena() const noexcept;
 
-        const Value& value(const std::string& name) const;
-        Value& value(const std::string& name);
-        const char* valueOrDefault(const std::string& name, const char* default_value) const noexcept;
-        const std::string& valueOrDefault(const std::string& name, const std::string& defaultValue) const noexcept;
-        const std::vector<std::string>& valueOrDefault(const std::string& name,
+        // Makes this configuration equal to the other one. Unlike the assignment operator, which shares the options of
+        // the other configuration, this reuses the storage of this configuration: the values of the options that are
+        // in both are assigned in place so their string buffers and nested options are kept. This is meant to reset a
+        // configuration to the same defaults over and over without allocating.
+        void assign(const Configuration& other);
+        // Returns true if both configurations share their options, which means they are equal. This is O(1) and
+        // returns false for configurations that are equal but don't share their options.
+        bool isSharedWith(const Configuration& other) const noexcept;
+
+        const Value& value(boost::string_view name) const;
+        Value& value(boost::string_view name);
+        // The valueOrDefault overloads return the default value if there is no such option and also if the option
+        // doesn't have the type of the default value, for instance an integer option when the default is a string.
+        const char* valueOrDefault(boost::string_view name, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(boost::string_view name, const std::string& defaultValue) const noexcept;
+        const std::vector<std::string>& valueOrDefault(boost::string_view name,
             const std::vector<std::string>& defaultValue) const noexcept;
-        const Configuration& valueOrDefault(const std::string& name, const Configuration& defaultValue) const noexcept;
-        const Value* valueOrNull(const std::string& name) const noexcept;
+        const Configuration& valueOrDefault(boost::string_view name, const Configuration& defaultValue) const noexcept;
+        const Value* valueOrNull(boost::string_view name) const noexcept;
 
-        void set(const std::string& name, const std::string& value);
-        void set(const std::string& name, const std::vector<std::string>& value);
-        void set(const std::string& name, const Configuration& value);
-        void set(const std::string& name, const Value& value);
+        const Value& value(const Key& key) const;
+        Value& value(const Key& key);
+        const char* valueOrDefault(const Key& key, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(const Key& key, const std::string& defaultValue) const noexcept;
+        const std::vector<std::string>& valueOrDefault(const Key& key,
+            const std::vector<std::string>& defaultValue) const noexcept;
+        const Configuration& valueOrDefault(const Key& key, const Configuration& defaultValue) const noexcept;
+        const Value* valueOrNull(const Key& key) const noexcept;
+
+        const Value& value(const Path& path) const;
+        Value& value(const Path& path);
+        const char* valueOrDefault(const Path& path, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(const Path& path, const std::string& defaultValue) const noexcept;
+        const std::vector<std::string>& valueOrDefault(const Path& path,
+            const std::vector<std::string>& defaultValue) const noexcept;
+        const Configuration& valueOrDefault(const Path& path, const Configuration& defaultValue) const noexcept;
+        const Value* valueOrNull(const Path& path) const noexcept;
+
+        // Setting options in name order is the fastest since the new options are then appended at the end
+        void set(boost::string_view name, const std::string& value);
+        void set(boost::string_view name, const std::vector<std::string>& value);
+        void set(boost::string_view name, const Configuration& value);
+        void set(boost::string_view name, const Value& value);
+        void set(boost::string_view name, std::string&& value);
+        void set(boost::string_view name, std::vector<std::string>&& value);
+        void set(boost::string_view name, Configuration&& value);
+        void set(boost::string_view name, Value&& value);
+        // Numbers and booleans, for instance set("port", 8080), are stored as the corresponding typed value
+        template<typename T>
+        typename std::enable_if<std::is_arithmetic<T>::value>::type set(boost::string_view name, T value);
+        // Constructs a value from the arguments and moves it into the option with that name, replacing the existing
+        // value if there is one. Returns the new value. The reference is invalidated by the next modification of this
+        // configuration.
+        template<typename... Args> Value& emplace(boost::string_view name, Args&&... args);
+        // Same as emplace but does nothing if there is already a value with that name: the arguments are left untouched
+        // and the options stay shared with the copies of this configuration. Returns the value with that name and
+        // whether the new value was inserted.
+        template<typename... Args> std::pair<const Value*, bool> tryEmplace(boost::string_view name, Args&&... args);
+        // Creates the intermediate configurations that don't exist yet. Throws std::invalid_argument if one of the
+        // intermediate options exists but isn't a configuration.
+        void set(const Path& path, const std::string& value);
+        void set(const Path& path, const std::vector<std::string>& value);
+        void set(const Path& path, const Configuration& value);
+        void set(const Path& path, const Value& value);
+        void set(const Path& path, Value&& value);
+        template<typename T>
+        typename std::enable_if<std::is_arithmetic<T>::value>::type set(const Path& path, T value);
+
+        // Return false if there was no option to erase
+        bool erase(boost::string_view name);
+        bool erase(const Path& path);
 
     private:
-        std::map<std::string, Value> m_options;
+        typedef std::vector<Entry, ConfigurationArena::Allocator<Entry>> Options;
+
+        const_iterator find(boost::string_view name) const noexcept;
+        const_iterator find(const Key& key) const noexcept;
+        Value& findOrInsert(boost::string_view name);
+        // Returns the value at the same position in options that are not shared with any other configuration
+        Value& mutableValue(const_iterator it);
+        const Options& options() const noexcept;
+        Options& mutableOptions();
+        // Returns the configuration that holds the last segment of the path, creating it if needed
+        Configuration& findOrInsertParent(const Path& path);
+
+        // Null until the first option is set
+        std::shared_ptr<Options> m_options;
+        // Identifies the set of names in m_options, a new layout is allocated each time a name is added. Copies share
+        // the layout of the original until one of them is modified.
+        uint64_t m_layout;
+        ConfigurationArena* m_arena;
     };
 }
 
+template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value
+    && std::is_signed<T>::value, int>::type>
+Ishiko::Configuration::Value::Value(T value)
+    : ValueBase(static_cast<int64_t>(value))
+{
+}
+
+template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value
+    && std::is_unsigned<T>::value, int>::type>
+Ishiko::Configuration::Value::Value(T value)
+    : ValueBase(static_cast<uint64_t>(value))
+{
+}
+
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type Ishiko::Configuration::set(boost::string_view name,
+    T value)
+{
+    set(name, Value(value));
+}
+
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type Ishiko::Configuration::set(const Path& path, T value)
+{
+    set(path, Value(value));
+}
+
+template<typename... Args>
+Ishiko::Configuration::Value& Ishiko::Configuration::emplace(boost::string_view name, Args&&... args)
+{
+    // The value is constructed first since the arguments may refer to one of our own options
+    Value new_value(std::forward<Args>(args)...);
+    Value& result = findOrInsert(name);
+    result = std::move(new_value);
+    return result;
+}
+
+template<typename... Args>
+std::pair<const Ishiko::Configuration::Value*, bool> Ishiko::Configuration::tryEmplace(boost::string_view name,
+    Args&&... args)
+{
+    const_iterator it = find(name);
+    if (it != options().end())
+    {
+        return std::pair<const Value*, bool>(&it->second, false);
+    }
+
+    // The value is constructed first since the arguments may refer to one of our own options
+    Value new_value(std::forward<Args>(args)...);
+    Value& result = findOrInsert(name);
+    result = std::move(new_value);
+    return std::pair<const Value*, bool>(&result, true);
+}
+
 #endif
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONARENA_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONARENA_HPP
+
+#include <cstddef>
+#include <new>
+
+namespace Ishiko
+{
+    // A monotonic buffer that configurations can allocate their storage from. Allocating is bumping a pointer,
+    // deallocating does nothing and the memory is only given back when the arena is released or destroyed. This is
+    // meant for short-lived configurations, for instance one built for each request, that would otherwise spend most
+    // of their time in the heap allocator.
+    //
+    // An arena is not thread-safe and every object allocated from it must have been destroyed before it is released.
+    class ConfigurationArena
+    {
+    public:
+        // A standard allocator that allocates from an arena, or from the heap if it has no arena
+        template<typename T>
+        class Allocator
+        {
+        public:
+            typedef T value_type;
+
+            Allocator() noexcept;
+            Allocator(ConfigurationArena* arena) noexcept;
+            template<typename U> Allocator(const Allocator<U>& other) noexcept;
+
+            T* allocate(size_t n);
+            void deallocate(T* p, size_t n) noexcept;
+
+            ConfigurationArena* arena() const noexcept;
+
+        private:
+            ConfigurationArena* m_arena;
+        };
+
+        explicit ConfigurationArena(size_t block_size = 4096);
+        ConfigurationArena(const ConfigurationArena& other) = delete;
+        ConfigurationArena& operator=(const ConfigurationArena& other) = delete;
+        ~ConfigurationArena();
+
+        void* allocate(size_t size, size_t alignment);
+        // Makes all the memory available again. The largest block is kept so an arena that is released after each
+        // use stops allocating from the heap once it has grown to the size it needs.
+        void release() noexcept;
+
+        // The number of bytes handed out since the arena was created or last released
+        size_t size() const noexcept;
+        // The number of bytes reserved from the heap
+        size_t capacity() const noexcept;
+
+    private:
+        struct Block
+        {
+            Block* previous;
+            size_t size;
+        };
+
+        void* allocateFromNewBlock(size_t size, size_t alignment);
+
+        Block* m_blocks;
+        char* m_current;
+        char* m_end;
+        size_t m_block_size;
+        size_t m_size;
+        size_t m_capacity;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const ConfigurationArena::Allocator<T>& lhs, const ConfigurationArena::Allocator<U>& rhs) noexcept;
+    template<typename T, typename U>
+    bool operator!=(const ConfigurationArena::Allocator<T>& lhs, const ConfigurationArena::Allocator<U>& rhs) noexcept;
+}
+
+template<typename T>
+Ishiko::ConfigurationArena::Allocator<T>::Allocator() noexcept
+    : m_arena(nullptr)
+{
+}
+
+template<typename T>
+Ishiko::ConfigurationArena::Allocator<T>::Allocator(ConfigurationArena* arena) noexcept
+    : m_arena(arena)
+{
+}
+
+template<typename T>
+template<typename U>
+Ishiko::ConfigurationArena::Allocator<T>::Allocator(const Allocator<U>& other) noexcept
+    : m_arena(other.arena())
+{
+}
+
+template<typename T>
+T* Ishiko::ConfigurationArena::Allocator<T>::allocate(size_t n)
+{
+    if (m_arena)
+    {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    else
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+}
+
+template<typename T>
+void Ishiko::ConfigurationArena::Allocator<T>::deallocate(T* p, size_t) noexcept
+{
+    if (!m_arena)
+    {
+        ::operator delete(p);
+    }
+}
+
+template<typename T>
+Ishiko::ConfigurationArena* Ishiko::ConfigurationArena::Allocator<T>::arena() const noexcept
+{
+    return m_arena;
+}
+
+template<typename T, typename U>
+bool Ishiko::operator==(const ConfigurationArena::Allocator<T>& lhs,
+    const ConfigurationArena::Allocator<U>& rhs) noexcept
+{
+    return (lhs.arena() == rhs.arena());
+}
+
+template<typename T, typename U>
+bool Ishiko::operator!=(const ConfigurationArena::Allocator<T>& lhs,
+    const ConfigurationArena::Allocator<U>& rhs) noexcept
+{
+    return (lhs.arena() != rhs.arena());
+}
+
+#endif
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONFILEWATCHER_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONFILEWATCHER_HPP
+
+#include "Configuration.hpp"
+#include "ConfigurationStore.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Ishiko
+{
+    // Keeps the configuration published by a ConfigurationStore up to date with a set of configuration files.
+    //
+    // Each file is loaded into its own subtree of the published configuration, at the path it was added with. When
+    // files change only those files are loaded again and the other subtrees are shared with the previous snapshot, so
+    // a change to one file out of many costs one load and a copy of the levels above its subtree.
+    //
+    // On Linux the directories of the files are watched with inotify, elsewhere (or if inotify isn't available) the
+    // modification times of the files are polled. In both cases changes are debounced: the files are only loaded once
+    // they haven't changed for the debounce delay, so that a burst of writes causes a single reload.
+    class ConfigurationFileWatcher
+    {
+    public:
+        // Returns the configuration in the file. Exceptions are reported to the error handler and the previous
+        // configuration of the file is kept.
+        typedef std::function<Configuration(const std::string& file_path)> Loader;
+        typedef std::function<void(const std::string& file_path, std::exception_ptr error)> ErrorHandler;
+        // Called with each configuration after it has been published, for instance to update the subscriptions of a
+        // ConfigurationSubscriptions. Calls are serialized. The handlers are called without any lock of the watcher
+        // held so they may call its functions, including reload.
+        typedef std::function<void(const Configuration& configuration)> ReloadHandler;
+
+        ConfigurationFileWatcher(ConfigurationStore& store, std::chrono::milliseconds debounce_delay);
+        ConfigurationFileWatcher(const ConfigurationFileWatcher& other) = delete;
+        ConfigurationFileWatcher& operator=(const ConfigurationFileWatcher& other) = delete;
+        ~ConfigurationFileWatcher();
+
+        // Files must be added before the watcher is started
+        void addFile(const std::string& file_path, const Configuration::Path& path, Loader loader);
+        void setErrorHandler(ErrorHandler handler);
+        void setReloadHandler(ReloadHandler handler);
+
+        // Starts watching the files, then loads all of them, publishes the result and handles the changes on a
+        // background thread
+        void start();
+        void stop();
+
+        // Loads the files that changed since they were last loaded and publishes a new snapshot if any did. Returns
+        // the number of files that were loaded. This is what the background thread calls once changes have settled
+        // and it can be called directly to reload without starting the watcher.
+        size_t reload();
+
+    private:
+        struct FileStamp
+        {
+            bool exists;
+            uint64_t device;
+            uint64_t inode;
+            int64_t size;
+            int64_t modification_time;
+
+            bool operator==(const FileStamp& other) const noexcept;
+            bool operator!=(const FileStamp& other) const noexcept;
+        };
+
+        struct WatchedFile
+        {
+            std::string file_path;
+            Configuration::Path path;
+            Loader loader;
+            FileStamp stamp;
+            bool changed;
+        };
+
+        static FileStamp GetFileStamp(const std::string& file_path);
+
+        // Returns false without watching anything if inotify can't be used, otherwise the events of the directories of
+        // the files are read from fd from then on
+        bool addInotifyWatches(int& fd, std::map<int, std::string>& directories);
+        // Closes fd once stopped
+        void watchWithInotify(int fd, const std::map<int, std::string>& directories);
+        void watchWithPolling();
+        void markChanged(const std::string& directory, const std::string& file_name);
+
+        ConfigurationStore& m_store;
+        std::chrono::milliseconds m_debounce_delay;
+        ErrorHandler m_error_handler;
+        ReloadHandler m_reload_handler;
+        // Serializes the publication of the snapshots and the calls to the handlers
+        std::recursive_mutex m_publish_mutex;
+        // Protects the handlers, the files and the configuration
+        std::mutex m_mutex;
+        std::vector<WatchedFile> m_files;
+        // The last configuration published, the next one is derived from it
+        Configuration m_configuration;
+        std::thread m_thread;
+        std::atomic<bool> m_stop;
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONPARSEERROR_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONPARSEERROR_HPP
+
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace Ishiko
+{
+    // Thrown by the parsers of configuration files. The line and column start at 1, the column counts bytes.
+    class ConfigurationParseError : public std::runtime_error
+    {
+    public:
+        ConfigurationParseError(const std::string& message, size_t line, size_t column);
+        // Computes the line and column of the offset in the text. This is only done once an error has been found so
+        // that the parsers don't have to keep track of the position.
+        static ConfigurationParseError AtOffset(const std::string& message, boost::string_view text, size_t offset);
+
+        size_t line() const noexcept;
+        size_t column() const noexcept;
+
+    private:
+        size_t m_line;
+        size_t m_column;
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONPATCH_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONPATCH_HPP
+
+#include "Configuration.hpp"
+#include <string>
+#include <vector>
+
+namespace Ishiko
+{
+    // The differences between two configurations, as a list of options added, removed or modified. This lets the
+    // users of a configuration find out what changed when a new configuration is loaded and only reconfigure what is
+    // affected.
+    class ConfigurationPatch
+    {
+    public:
+        struct Change
+        {
+            enum class Type
+            {
+                added,
+                removed,
+                modified
+            };
+
+            Type type;
+            // The names of the option and of the configurations it is nested in
+            std::vector<std::string> path;
+            // The new value, empty for removed options
+            Configuration::Value value;
+        };
+
+        ConfigurationPatch() noexcept;
+
+        // The changes are sorted by path. Both configurations are walked side by side, nested configurations that
+        // are in both are compared recursively and skipped in O(1) if they share their options. A nested
+        // configuration that is only in one of them is a single change, the options in it are not listed.
+        static ConfigurationPatch Diff(const Configuration& from, const Configuration& to);
+
+        bool empty() const noexcept;
+        const std::vector<Change>& changes() const noexcept;
+
+        // Applying the patch created by Diff(from, to) to from makes it equal to to
+        void apply(Configuration& configuration) const;
+
+    private:
+        void diff(const Configuration& from, const Configuration& to, std::vector<std::string>& path);
+        void addChange(Change::Type type, const std::vector<std::string>& path, const std::string& name,
+            const Configuration::Value& value);
+
+        std::vector<Change> m_changes;
+    };
+}
+
+#endif
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONSNAPSHOT_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONSNAPSHOT_HPP
+
+#include "Configuration.hpp"
+#include "MemoryMappedFile.hpp"
+#include <boost/utility/string_view.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Ishiko
+{
+    // A configuration compiled to a binary file that is read in place, for instance to avoid parsing a large
+    // configuration each time a service starts.
+    //
+    // The file is made of tables, one for each configuration, that hold the names of their options in name order
+    // followed by a fixed size slot for each value, and of a string table that holds the names and the strings. All
+    // the references between them are offsets. Opening a snapshot maps the file and only checks its header, lookups
+    // are a binary search in the table with the views below pointing into the mapped file, so nothing is parsed or
+    // allocated and only the pages that are used are read.
+    //
+    // The file is trusted: it must have been written by Write on a machine with the same byte order. It must not be
+    // modified while it is open, a new snapshot should be written to another file and renamed over it instead, which
+    // is what Write does. The views are only valid while the snapshot is open.
+    class ConfigurationSnapshot
+    {
+    private:
+        struct StringReference;
+        struct Slot;
+        class Writer;
+
+    public:
+        class Table;
+
+        class StringArray
+        {
+        public:
+            size_t size() const noexcept;
+            boost::string_view operator[](size_t index) const noexcept;
+
+            std::vector<std::string> toVector() const;
+
+        private:
+            friend class ConfigurationSnapshot;
+
+            StringArray(const char* strings, const StringReference* items, size_t size) noexcept;
+
+            const char* m_strings;
+            const StringReference* m_items;
+            size_t m_size;
+        };
+
+        // A value in the snapshot, or a null value if the option wasn't found. The as functions throw boost::bad_get
+        // if the value is of another type, like the functions of Configuration::Value. On a null value type, toValue
+        // and the as functions all throw boost::bad_get.
+        class Value
+        {
+        public:
+            Value() noexcept;
+
+            explicit operator bool() const noexcept;
+
+            Configuration::Value::Type type() const;
+            boost::string_view asString() const;
+            // The strings are null terminated
+            const char* asCString() const;
+            StringArray asStringArray() const;
+            Table asConfiguration() const;
+            int64_t asInt() const;
+            double asDouble() const;
+            bool asBool() const;
+            std::chrono::nanoseconds asDuration() const;
+            uint64_t asSize() const;
+
+            // Copies the value, and the options of a configuration value, out of the snapshot
+            Configuration::Value toValue(ConfigurationArena* arena = nullptr) const;
+
+        private:
+            friend class ConfigurationSnapshot;
+
+            Value(const char* data, const char* strings, const Slot* slot) noexcept;
+
+            void checkType(Configuration::Value::Type type) const;
+
+            const char* m_data;
+            const char* m_strings;
+            const Slot* m_slot;
+        };
+
+        // The options of a configuration in the snapshot
+        class Table
+        {
+        public:
+            size_t size() const noexcept;
+            // The options are in name order
+            boost::string_view nameAt(size_t index) const noexcept;
+            Value valueAt(size_t index) const noexcept;
+
+            // Throws std::out_of_range if there is no option with that name
+            Value value(boost::string_view name) const;
+            // Returns the default value if there is no option with that name or if it isn't a string
+            const char* valueOrDefault(boost::string_view name, const char* default_value) const noexcept;
+            Value valueOrNull(boost::string_view name) const noexcept;
+
+            Value value(const Configuration::Path& path) const;
+            const char* valueOrDefault(const Configuration::Path& path, const char* default_value) const noexcept;
+            Value valueOrNull(const Configuration::Path& path) const noexcept;
+
+            // Copies the options out of the snapshot
+            Configuration toConfiguration(ConfigurationArena* arena = nullptr) const;
+
+        private:
+            friend class ConfigurationSnapshot;
+
+            Table(const char* data, const char* strings, const char* table) noexcept;
+
+            const StringReference* names() const noexcept;
+            const Slot* slots() const noexcept;
+
+            const char* m_data;
+            const char* m_strings;
+            const char* m_table;
+        };
+
+        // Throws std::system_error if the file can't be opened and std::runtime_error if it isn't a snapshot
+        explicit ConfigurationSnapshot(const std::string& file_path);
+        ConfigurationSnapshot(const ConfigurationSnapshot& other) = delete;
+        ConfigurationSnapshot& operator=(const ConfigurationSnapshot& other) = delete;
+
+        // Returns the content of the snapshot file for the configuration
+        static std::string Compile(const Configuration& configuration);
+        // The snapshot is written to file_path with ".tmp" appended and then renamed to file_path, so the processes
+        // that have the previous snapshot open keep reading it. Throws std::runtime_error if the file can't be
+        // written.
+        static void Write(const Configuration& configuration, const std::string& file_path);
+
+        Table root() const noexcept;
+
+        // Same as the functions of the root table
+        Value value(boost::string_view name) const;
+        const char* valueOrDefault(boost::string_view name, const char* default_value) const noexcept;
+        Value valueOrNull(boost::string_view name) const noexcept;
+        Value value(const Configuration::Path& path) const;
+        const char* valueOrDefault(const Configuration::Path& path, const char* default_value) const noexcept;
+        Value valueOrNull(const Configuration::Path& path) const noexcept;
+
+    private:
+        // The offset of a string in the string table, the strings are null terminated but the length doesn't include
+        // the terminator
+        struct StringReference
+        {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        struct Slot
+        {
+            // A Configuration::Value::Type
+            uint32_t type;
+            // The length of a string or the number of strings in an array
+            uint32_t length;
+            // The offset of a string in the string table, the offset in the file of the strings of an array or of a
+            // table, or the bits of the other types
+            uint64_t data;
+        };
+
+        MemoryMappedFile m_file;
+        const char* m_strings;
+        const char* m_root;
+    };
+}
+
+#endif
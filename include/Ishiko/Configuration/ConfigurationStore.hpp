@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONSTORE_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONSTORE_HPP
+
+#include "Configuration.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace Ishiko
+{
+    // Publishes immutable snapshots of a configuration to any number of reader threads, for instance to reload the
+    // configuration of a server while it handles requests.
+    //
+    // Readers get the current snapshot through a read handle. Taking a handle is wait-free and doesn't allocate: it
+    // increments a reader counter and loads the snapshot pointer, releasing it decrements the counter. The counters
+    // are split by epoch and striped across cache lines so readers on different threads rarely touch the same line.
+    // A writer swaps the snapshot pointer, then flips the epoch twice and waits each time for the readers counted in
+    // the previous epoch to release their handles before deleting the old snapshot, like sleepable RCU does.
+    //
+    // Handles should therefore be held briefly since publish waits for them. A reader that needs a snapshot for
+    // longer can copy the configuration, which only shares its options and doesn't block writers. The store must
+    // outlive its handles.
+    class ConfigurationStore
+    {
+    private:
+        struct Snapshot;
+
+    public:
+        class ReadHandle
+        {
+        public:
+            ReadHandle(ReadHandle&& other) noexcept;
+            ReadHandle(const ReadHandle& other) = delete;
+            ReadHandle& operator=(const ReadHandle& other) = delete;
+            ~ReadHandle();
+
+            const Configuration& operator*() const noexcept;
+            const Configuration* operator->() const noexcept;
+            // Starts at 1 for the initial configuration and is incremented by each publish
+            uint64_t version() const noexcept;
+
+        private:
+            friend class ConfigurationStore;
+
+            ReadHandle(std::atomic<size_t>* counter, const Snapshot* snapshot) noexcept;
+
+            std::atomic<size_t>* m_counter;
+            const Snapshot* m_snapshot;
+        };
+
+        explicit ConfigurationStore(Configuration configuration);
+        ConfigurationStore(const ConfigurationStore& other) = delete;
+        ConfigurationStore& operator=(const ConfigurationStore& other) = delete;
+        ~ConfigurationStore();
+
+        ReadHandle read() const noexcept;
+        // Makes the configuration visible to the readers that take a handle from now on and deletes the previous
+        // snapshot once the handles on it have been released. Concurrent writers are serialized.
+        void publish(Configuration configuration);
+
+    private:
+        struct Snapshot
+        {
+            Configuration configuration;
+            uint64_t version;
+        };
+
+        static const size_t StripeCount = 16;
+
+        // Padded so that two counters are never on the same cache line. The array doesn't need to be aligned for
+        // that: values 64 bytes apart always are on different lines. This avoids alignas(64), which operator new
+        // doesn't honor before C++17 for stores allocated on the heap.
+        struct Counter
+        {
+            std::atomic<size_t> value;
+            char padding[64 - sizeof(std::atomic<size_t>)];
+        };
+
+        void waitForReaders(size_t epoch) const;
+
+        std::atomic<Snapshot*> m_snapshot;
+        std::atomic<size_t> m_epoch;
+        mutable Counter m_readers[2][StripeCount];
+        std::mutex m_writer_mutex;
+    };
+}
+
+#endif
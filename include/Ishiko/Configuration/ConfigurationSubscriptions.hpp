@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONSUBSCRIPTIONS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_CONFIGURATIONSUBSCRIPTIONS_HPP
+
+#include "Configuration.hpp"
+#include "ConfigurationPatch.hpp"
+#include <boost/utility/string_view.hpp>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Ishiko
+{
+    // Notifies components when the options they are interested in change between two versions of a configuration.
+    //
+    // A subscription is either to an option, for instance "cache.size", or to all the options under a prefix, for
+    // instance "cache.*" ("*" on its own matches everything). A subscription to a nested configuration by its name
+    // only matches when it is replaced as a whole, use a prefix to be notified of changes to the options in it.
+    //
+    // Each new version of the configuration is diffed against the previous one and every subscriber is called once
+    // with all the changes that match it, so a reload that changes several options a component depends on only
+    // reconfigures it once.
+    //
+    // The subscriptions are indexed in a tree of path segments. Each change is matched by walking down the tree along
+    // its path, so the cost of an update depends on the number of changes and not on the number of subscribers. A
+    // change to a nested configuration as a whole, for instance when it is added or removed, matches the
+    // subscriptions to the options in it.
+    class ConfigurationSubscriptions
+    {
+    public:
+        // The changes point into a patch that is only valid for the duration of the call
+        typedef std::function<void(const Configuration& configuration,
+            const std::vector<const ConfigurationPatch::Change*>& changes)> Callback;
+        typedef uint64_t SubscriptionId;
+
+        explicit ConfigurationSubscriptions(Configuration configuration = Configuration());
+        ConfigurationSubscriptions(const ConfigurationSubscriptions& other) = delete;
+        ConfigurationSubscriptions& operator=(const ConfigurationSubscriptions& other) = delete;
+
+        SubscriptionId subscribe(boost::string_view pattern, Callback callback);
+        // Returns false if there was no such subscription. The callback may still be called once if an update is in
+        // progress on another thread.
+        bool unsubscribe(SubscriptionId id);
+        size_t size() const;
+
+        // Diffs the configuration against the one passed to the previous update, or to the constructor, and calls the
+        // subscribers. Updates are serialized and the callbacks are called on the updating thread, in the order they
+        // subscribed. Callbacks can subscribe and unsubscribe but must not call update.
+        void update(Configuration configuration);
+        // Calls the subscribers that match the changes in the patch
+        void notify(const Configuration& configuration, const ConfigurationPatch& patch);
+
+    private:
+        struct Subscription
+        {
+            SubscriptionId id;
+            std::vector<std::string> segments;
+            bool prefix;
+            Callback callback;
+            // Used during a dispatch to collect the matching changes, only accessed with the dispatch mutex held
+            uint64_t batch;
+            std::vector<const ConfigurationPatch::Change*> changes;
+        };
+
+        struct Node
+        {
+            std::map<std::string, std::unique_ptr<Node>> children;
+            // Subscriptions to the option at this node
+            std::vector<std::shared_ptr<Subscription>> exact;
+            // Subscriptions to all the options below this node
+            std::vector<std::shared_ptr<Subscription>> prefix;
+        };
+
+        void dispatch(const Configuration& configuration, const ConfigurationPatch& patch);
+        void match(const std::vector<std::shared_ptr<Subscription>>& subscriptions,
+            const ConfigurationPatch::Change& change, std::vector<std::shared_ptr<Subscription>>& matches);
+        void matchSubtree(const Node& node, const ConfigurationPatch::Change& change,
+            std::vector<std::shared_ptr<Subscription>>& matches);
+
+        // Serializes updates, it is held while the callbacks are called
+        std::mutex m_dispatch_mutex;
+        Configuration m_configuration;
+        uint64_t m_batch;
+        // Protects the index, it is never held while calling a callback
+        mutable std::mutex m_index_mutex;
+        Node m_root;
+        std::map<SubscriptionId, std::shared_ptr<Subscription>> m_subscriptions;
+        SubscriptionId m_next_id;
+    };
+}
+
+#endif
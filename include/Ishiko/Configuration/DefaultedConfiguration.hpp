@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_DEFAULTEDCONFIGURATION_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_DEFAULTEDCONFIGURATION_HPP
+
+#include "CompiledCommandLineSpecification.hpp"
+#include "Configuration.hpp"
+#include <boost/utility/string_view.hpp>
+#include <string>
+
+namespace Ishiko
+{
+    // A configuration parsed from a command line, with the options that weren't set falling through to the defaults
+    // of the specification. Unlike createDefaultConfiguration nothing is copied: the view holds the parsed
+    // configuration, which shares its options, and a pointer to the specification, so creating it is O(1) whatever
+    // the number of options. The defaults are read from the specification, already converted to their value type.
+    //
+    // The defaults of the named options and of the positional options of the root command are found at the root. The
+    // defaults of the positional options of a command are found in the configuration of that command, if that
+    // command was selected on the command line, for instance "command.option" if the command is selected by the
+    // "command" option.
+    //
+    // The specification must outlive the view.
+    class DefaultedConfiguration
+    {
+    public:
+        // The configuration should be parsed with the same specification, without calling createDefaultConfiguration
+        // first
+        DefaultedConfiguration(const CompiledCommandLineSpecification& specification, Configuration configuration);
+
+        const Configuration& parsedConfiguration() const noexcept;
+
+        // The parsed value or the default value
+        const Configuration::Value& value(boost::string_view name) const;
+        // The valueOrDefault overloads also return the default value if the option, or its default in the
+        // specification, isn't a string
+        const char* valueOrDefault(boost::string_view name, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(boost::string_view name, const std::string& defaultValue) const noexcept;
+        const Configuration::Value* valueOrNull(boost::string_view name) const noexcept;
+
+        const Configuration::Value& value(const Configuration::Path& path) const;
+        const char* valueOrDefault(const Configuration::Path& path, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(const Configuration::Path& path,
+            const std::string& defaultValue) const noexcept;
+        const Configuration::Value* valueOrNull(const Configuration::Path& path) const noexcept;
+
+    private:
+        const CompiledCommandLineSpecification* m_specification;
+        Configuration m_configuration;
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_ENVIRONMENTPARSER_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_ENVIRONMENTPARSER_HPP
+
+#include "CompiledCommandLineSpecification.hpp"
+#include "Configuration.hpp"
+#include "PerfectHashIndex.hpp"
+#include <boost/utility/string_view.hpp>
+#include <string>
+#include <vector>
+
+namespace Ishiko
+{
+    // Reads the named options of a specification from environment variables. The name of the variable is the name
+    // of the option in upper case with the prefix in front, a double underscore for each dot and an underscore for
+    // each dash: with the prefix "APP_" the option "server.port" is read from APP_SERVER__PORT and stored at the path
+    // "server.port", the option "log-level" is read from APP_LOG_LEVEL. The values are converted to the value type
+    // of the options.
+    //
+    // The variable names are indexed with a perfect hash when the parser is constructed, so parsing is a single pass
+    // over the environment with one hash per variable that has the prefix, instead of a getenv for each option which
+    // searches the whole environment each time. If several options have the same variable name only the first one
+    // in name order is read.
+    //
+    // The specification must outlive the parser.
+    class EnvironmentParser
+    {
+    public:
+        EnvironmentParser(const CompiledCommandLineSpecification& specification, boost::string_view prefix);
+
+        // Returns the name of the variable for the option
+        static std::string VariableName(boost::string_view prefix, boost::string_view option_name);
+
+        // Reads the environment of the process. Throws std::invalid_argument if a value can't be converted to the
+        // value type of its option, or if a variable sets a value at a path where another one set a value that isn't
+        // a configuration, see Configuration::set.
+        void parse(Configuration& configuration) const;
+        // The environment is a null terminated array of "NAME=value" strings, like environ or the envp argument of
+        // main
+        void parse(const char* const* environment, Configuration& configuration) const;
+
+    private:
+        struct Variable
+        {
+            // Without the prefix
+            std::string name;
+            Configuration::Path path;
+            const CompiledCommandLineSpecification::Option* option;
+        };
+
+        std::string m_prefix;
+        std::vector<Variable> m_variables;
+        PerfectHashIndex m_index;
+    };
+}
+
+#endif
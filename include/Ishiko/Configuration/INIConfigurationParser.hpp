@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_INICONFIGURATIONPARSER_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_INICONFIGURATIONPARSER_HPP
+
+#include "Configuration.hpp"
+#include "ConfigurationParseError.hpp"
+#include <boost/utility/string_view.hpp>
+#include <string>
+
+namespace Ishiko
+{
+    // Reads sectioned key=value files, the common subset of INI and TOML:
+    //
+    //     # Comments start with # or ; at the beginning of a line, or after whitespace following an unquoted value
+    //     name = value
+    //     [server]
+    //     host = "localhost"          # basic string, with \", \\, \n, \r and \t escapes
+    //     path = 'C:\server'          # literal string, no escapes
+    //     [server.tls]
+    //     ciphers = ["a", "b"]        # array of strings on one line
+    //     alias = one
+    //     alias = two
+    //
+    // Sections, including the dotted ones, become nested configurations and keys can be dotted too. A key that is
+    // repeated in a section, or an array, becomes a string array. All other values are strings, Value::Parse can
+    // convert them to other types. A section can be opened more than once, its keys are merged.
+    //
+    // The text is read in a single pass that only records where the names and values are. The configuration is built
+    // at the end, once the keys of each section are known, so that each nested configuration is created with its
+    // options in order. Errors are reported by throwing a ConfigurationParseError with the line and column of the
+    // error.
+    class INIConfigurationParser
+    {
+    public:
+        // The sections and keys are added to the configuration and replace the options with the same name. The nested
+        // configurations are allocated from the arena of the configuration.
+        static void parse(boost::string_view text, Configuration& configuration);
+        // The file is memory mapped rather than read into a buffer. Throws std::system_error if the file can't be
+        // read.
+        static void parseFile(const std::string& file_path, Configuration& configuration);
+    };
+}
+
+#endif
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_JSONCONFIGURATIONPARSER_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_JSONCONFIGURATIONPARSER_HPP
+
+#include "Configuration.hpp"
+#include "ConfigurationParseError.hpp"
+#include <boost/utility/string_view.hpp>
+#include <string>
+
+namespace Ishiko
+{
+    // Builds a configuration from JSON as it is tokenized, without an intermediate document. Objects become nested
+    // configurations, strings, numbers and booleans become values of the corresponding type and arrays of strings,
+    // numbers or booleans become string arrays. Members that are null are skipped. Arrays of objects or arrays are
+    // not supported. If a name appears more than once in an object the last value is kept.
+    //
+    // Strings are scanned 16 bytes at a time with SSE2 when it is available, for the quote, backslash and control
+    // characters that end the fast path, and copied to the configuration in one go if they don't contain escapes.
+    // Whitespace is skipped the same way.
+    //
+    // Floating point numbers are converted with std::strtod, which uses the decimal separator of the current C locale,
+    // so the C locale (the default unless the program calls setlocale) is required to parse them correctly.
+    //
+    // Errors are reported by throwing a ConfigurationParseError with the line and column of the error. Numbers too
+    // large for a double are errors, numbers too small for one become subnormals or 0.
+    class JSONConfigurationParser
+    {
+    public:
+        // The text must be an object, its members are added to the configuration and replace the options with the
+        // same name. The nested configurations are allocated from the arena of the configuration.
+        static void parse(boost::string_view text, Configuration& configuration);
+        // The file is memory mapped rather than read into a buffer. Throws std::system_error if the file can't be
+        // read.
+        static void parseFile(const std::string& file_path, Configuration& configuration);
+    };
+}
+
+#endif
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_LAYEREDCONFIGURATION_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_LAYEREDCONFIGURATION_HPP
+
+#include "Configuration.hpp"
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Ishiko
+{
+    // A stack of configurations where the options of the higher layers override the options of the lower ones, for
+    // instance the defaults, then the configuration files, the environment and the command line.
+    //
+    // Nothing is merged up front: a lookup searches the layers from the highest down and returns the first value it
+    // finds. Nested configurations are merged with the ones at the same path in the lower layers, and a value that
+    // isn't a configuration hides everything under that path in the lower layers. The layers are copies that share
+    // their options with the configurations they were created from, so adding a layer, for instance the overrides of
+    // a single request on top of a shared base, costs the size of the layer and not the size of the base.
+    class LayeredConfiguration
+    {
+    public:
+        LayeredConfiguration() noexcept;
+        // The layers are from the lowest priority to the highest
+        explicit LayeredConfiguration(std::vector<Configuration> layers);
+
+        // Adds a layer above the existing ones
+        void push(Configuration layer);
+        // Removes the highest layer
+        void pop();
+        size_t layerCount() const noexcept;
+        // The layer at the given index, 0 is the lowest
+        const Configuration& layer(size_t index) const;
+
+        // The value of the option in the highest layer that has it. If that value is a configuration it is the one of
+        // that layer only, use subtree to see the options of the configurations below it too.
+        const Configuration::Value& value(boost::string_view name) const;
+        // The valueOrDefault overloads also return the default value if the option isn't a string
+        const char* valueOrDefault(boost::string_view name, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(boost::string_view name, const std::string& defaultValue) const noexcept;
+        const Configuration::Value* valueOrNull(boost::string_view name) const noexcept;
+
+        const Configuration::Value& value(const Configuration::Path& path) const;
+        const char* valueOrDefault(const Configuration::Path& path, const char* default_value) const noexcept;
+        const std::string& valueOrDefault(const Configuration::Path& path,
+            const std::string& defaultValue) const noexcept;
+        const Configuration::Value* valueOrNull(const Configuration::Path& path) const noexcept;
+
+        // The layers of the nested configuration at the path, merged the same way. The result has no layers if
+        // there is no configuration at that path.
+        LayeredConfiguration subtree(boost::string_view name) const;
+        LayeredConfiguration subtree(const Configuration::Path& path) const;
+
+        // Merges the layers into a single configuration in one pass: the options of each nested configuration are
+        // merge-joined across the layers in name order. The nested configurations that are only in one layer are
+        // shared with it rather than copied.
+        Configuration flatten(ConfigurationArena* arena = nullptr) const;
+
+    private:
+        std::vector<Configuration> m_layers;
+    };
+}
+
+#endif
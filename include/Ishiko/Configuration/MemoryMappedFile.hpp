@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_MEMORYMAPPEDFILE_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_MEMORYMAPPEDFILE_HPP
+
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <string>
+
+namespace Ishiko
+{
+    // A read-only view of the content of a file mapped in memory. The parsers read configuration files through it so
+    // that large files are not copied into a buffer first, the pages are read from the file as they are accessed.
+    class MemoryMappedFile
+    {
+    public:
+        // A hint to the operating system about how the pages will be read
+        enum class Access
+        {
+            // The parsers read the files from start to end
+            sequential,
+            // Lookups in a ConfigurationSnapshot only touch the pages they need
+            random
+        };
+
+        // Throws std::system_error if the file can't be opened or mapped, or if it isn't a regular file since pipes and
+        // devices can't be mapped
+        explicit MemoryMappedFile(const std::string& file_path, Access access = Access::sequential);
+        MemoryMappedFile(const MemoryMappedFile& other) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile& other) = delete;
+        ~MemoryMappedFile();
+
+        const char* data() const noexcept;
+        size_t size() const noexcept;
+        boost::string_view view() const noexcept;
+
+    private:
+        const char* m_data;
+        size_t m_size;
+#if defined(_WIN32)
+        void* m_file;
+        void* m_mapping;
+#endif
+    };
+}
+
+#endif
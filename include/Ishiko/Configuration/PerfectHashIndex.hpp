@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_PERFECTHASHINDEX_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_PERFECTHASHINDEX_HPP
+
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Ishiko
+{
+    // A minimal perfect hash over a fixed set of keys, built with the hash and displace algorithm. Each key is mapped
+    // to its own slot so a lookup is one hash, a couple of table reads and a single comparison by the caller.
+    //
+    // The index doesn't store the keys. It maps a key hash to the index of the only key that can match it and the
+    // caller is responsible for comparing the key at that index with the key it is looking for.
+    class PerfectHashIndex
+    {
+    public:
+        // Returns the hash of the key with the given index for the given seed. If the keys can't be separated with a
+        // seed the index is rebuilt with another one so the hash must depend on the seed.
+        typedef std::function<uint64_t(size_t index, uint64_t seed)> KeyHash;
+
+        static const size_t npos = static_cast<size_t>(-1);
+
+        PerfectHashIndex() noexcept;
+        // The keys must be distinct
+        PerfectHashIndex(size_t key_count, const KeyHash& key_hash);
+
+        static uint64_t Hash(boost::string_view key, uint64_t seed) noexcept;
+        // Used to hash keys made of several parts
+        static uint64_t Hash(boost::string_view key, uint64_t seed, uint64_t previous_hash) noexcept;
+
+        uint64_t seed() const noexcept;
+        // Returns the index of the key that has this hash if it is part of the set, otherwise returns an arbitrary
+        // index or npos
+        size_t find(uint64_t hash) const noexcept;
+
+    private:
+        bool build(size_t key_count, const KeyHash& key_hash, uint64_t seed);
+
+        uint64_t m_seed;
+        std::vector<uint32_t> m_displacements;
+        std::vector<size_t> m_slots;
+    };
+}
+
+#endif
@@ -2,135 +2,673 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "CommandLineParser.hpp"
-#include <Ishiko/Text.hpp>
+#include "ConfigurationParseError.hpp"
+#include "MemoryMappedFile.hpp"
+#include <boost/utility/string_view.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
 
 using namespace Ishiko;
 
-void CommandLineParser::parse(const CommandLineSpecification& specification, int argc, const char* argv[],
-    Configuration& configuration)
+namespace
+{
+
+enum class ArgumentType
 {
-    CommandLineSpecification::CommandDetails command_details;
-    Configuration* current_command_configuration = &configuration;
+    named,
+    short_named,
+    positional
+};
 
-    // The first argument is the executable so we ignore it
-    size_t positional_option = 0;
-    for (int i = 1; i < argc; ++i)
+// Splits an argument into its name and value without copying anything, the views point into the argv string
+ArgumentType TokenizeArgument(boost::string_view argument, boost::string_view& name, boost::string_view& value)
+{
+    ArgumentType result;
+    size_t prefix_length;
+    if (argument.starts_with("--"))
     {
-        const char* arg = argv[i];
-        std::string option_name;
-        std::string option_value;
-        bool current_command_option = false;
-        if (CString::StartsWith(arg, "--"))
+        result = ArgumentType::named;
+        prefix_length = 2;
+    }
+    else if (argument.starts_with('-'))
+    {
+        result = ArgumentType::short_named;
+        prefix_length = 1;
+    }
+    else
+    {
+        name.clear();
+        value = argument;
+        return ArgumentType::positional;
+    }
+
+    size_t pos = argument.find('=');
+    if (pos != boost::string_view::npos)
+    {
+        // Empty names and values are not errors. "--=value" is stored under an empty name like any named option that
+        // isn't in the specification and "-=value" is ignored like an unknown short name. "--name=" gives the option
+        // an empty value, which is converted like any other value.
+        name = argument.substr(prefix_length, pos - prefix_length);
+        value = argument.substr(pos + 1);
+    }
+    else
+    {
+        // Without a value a toggle of type boolean is set to true by OptionDetails::createValue, other options are
+        // given an empty value
+        name = argument.substr(prefix_length);
+        value.clear();
+    }
+
+    return result;
+}
+
+// Adapts a CommandLineSpecification to the interface used by ParseArguments. The map based lookups of the
+// specification need std::string keys so the names are copied to a buffer that is reused for every argument, once it
+// is large enough (or if the names fit in the small string buffer) no allocation happens.
+class SpecificationLookup
+{
+public:
+    typedef const CommandLineSpecification::CommandDetails* Command;
+
+    SpecificationLookup(const CommandLineSpecification& specification)
+        : m_specification(specification)
+    {
+    }
+
+    Command root() const
+    {
+        return nullptr;
+    }
+
+    const std::string* findNamedOption(boost::string_view name, const CommandLineSpecification::OptionDetails*& details)
+    {
+        // Named options are stored even if they are not part of the specification
+        m_lookup_name.assign(name.data(), name.size());
+        m_specification.findNamedOption(m_lookup_name, details);
+        return &m_lookup_name;
+    }
+
+    const std::string* findShortNamedOption(boost::string_view short_name,
+        const CommandLineSpecification::OptionDetails*& details)
+    {
+        m_lookup_name.assign(short_name.data(), short_name.size());
+        const std::string* name = nullptr;
+        m_specification.findShortNamedOption(m_lookup_name, name, details);
+        return name;
+    }
+
+    bool findPositionalOption(Command command, size_t position, const std::string*& name,
+        const CommandLineSpecification::OptionDetails*& details, bool& command_option) const
+    {
+        command_option = (command && command->findPositionalOption(position, name, details));
+        return (command_option || m_specification.findPositionalOption(position, name, details));
+    }
+
+    bool findCommand(Command command, const std::string& option_name, const std::string& command_name,
+        Command& subcommand) const
+    {
+        return ((command && command->findCommand(option_name, command_name, subcommand))
+            || m_specification.findCommand(option_name, command_name, subcommand));
+    }
+
+private:
+    const CommandLineSpecification& m_specification;
+    std::string m_lookup_name;
+};
+
+// Adapts a CompiledCommandLineSpecification to the interface used by ParseArguments. The names of the named options
+// that are not in the specification are copied to the lookup_name buffer.
+class CompiledSpecificationLookup
+{
+public:
+    typedef const CompiledCommandLineSpecification::Command* Command;
+
+    CompiledSpecificationLookup(const CompiledCommandLineSpecification& specification, std::string& lookup_name)
+        : m_specification(specification), m_lookup_name(lookup_name)
+    {
+    }
+
+    Command root() const
+    {
+        return &m_specification.root();
+    }
+
+    const std::string* findNamedOption(boost::string_view name, const CommandLineSpecification::OptionDetails*& details)
+    {
+        const CompiledCommandLineSpecification::Option* option = m_specification.findNamedOption(name);
+        if (option)
+        {
+            details = &option->details;
+            return &option->name;
+        }
+        else
+        {
+            // Named options are stored even if they are not part of the specification
+            m_lookup_name.assign(name.data(), name.size());
+            return &m_lookup_name;
+        }
+    }
+
+    const std::string* findShortNamedOption(boost::string_view short_name,
+        const CommandLineSpecification::OptionDetails*& details) const
+    {
+        const CompiledCommandLineSpecification::Option* option = m_specification.findShortNamedOption(short_name);
+        if (option)
+        {
+            details = &option->details;
+            return &option->name;
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    bool findPositionalOption(Command command, size_t position, const std::string*& name,
+        const CommandLineSpecification::OptionDetails*& details, bool& command_option) const
+    {
+        const CompiledCommandLineSpecification::Option* option = nullptr;
+        if (command != root())
+        {
+            option = m_specification.findPositionalOption(*command, position);
+        }
+        command_option = (option != nullptr);
+        if (!option)
+        {
+            option = m_specification.findPositionalOption(m_specification.root(), position);
+        }
+        if (option)
+        {
+            name = &option->name;
+            details = &option->details;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    bool findCommand(Command command, const std::string& option_name, const std::string& command_name,
+        Command& subcommand) const
+    {
+        subcommand = m_specification.findCommand(*command, option_name, command_name);
+        if (!subcommand && (command != root()))
+        {
+            subcommand = m_specification.findCommand(m_specification.root(), option_name, command_name);
+        }
+        return (subcommand != nullptr);
+    }
+
+private:
+    const CompiledCommandLineSpecification& m_specification;
+    std::string& m_lookup_name;
+};
+
+// Returns the absolute path of the file with the symbolic links resolved, so that a response file that is read again
+// through a different path is still recognized. On Windows the path is only made absolute.
+std::string CanonicalPath(const std::string& file_path)
+{
+#if defined(_WIN32)
+    char* canonical_path = _fullpath(nullptr, file_path.c_str(), 0);
+#else
+    char* canonical_path = realpath(file_path.c_str(), nullptr);
+#endif
+    if (!canonical_path)
+    {
+        throw std::system_error(errno, std::generic_category(),
+            "CommandLineParser: failed to open response file " + file_path);
+    }
+    std::string result(canonical_path);
+    std::free(canonical_path);
+    return result;
+}
+
+bool IsWhitespace(char c)
+{
+    return ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\v') || (c == '\f'));
+}
+
+// Splits the content of a response file into arguments. The arguments are separated by whitespace. A backslash
+// escapes the next character and quotes group characters, including whitespace, into a single argument. Backslashes
+// are literal inside single quotes, inside double quotes they only escape '"' and '\\'.
+//
+// An argument without quotes or backslashes, which is the common case, is returned as a view of the text. The others
+// are unescaped into the buffer, which is overwritten by the next argument.
+class ResponseFileTokenizer
+{
+public:
+    ResponseFileTokenizer(const std::string& file_path, boost::string_view text, std::string& buffer)
+        : m_file_path(file_path), m_text(text), m_position(text.data()), m_buffer(buffer)
+    {
+    }
+
+    // Returns false once all the arguments have been read
+    bool next(boost::string_view& argument)
+    {
+        const char* end = m_text.data() + m_text.size();
+        while ((m_position != end) && IsWhitespace(*m_position))
         {
-            size_t pos = CString::Find(arg, "=");
-            if (pos != std::string::npos)
+            ++m_position;
+        }
+        if (m_position == end)
+        {
+            return false;
+        }
+
+        const char* begin = m_position;
+        while ((m_position != end) && !IsWhitespace(*m_position) && (*m_position != '\\') && (*m_position != '"')
+            && (*m_position != '\''))
+        {
+            ++m_position;
+        }
+        if ((m_position == end) || IsWhitespace(*m_position))
+        {
+            argument = boost::string_view(begin, m_position - begin);
+            return true;
+        }
+
+        m_buffer.assign(begin, m_position - begin);
+        while ((m_position != end) && !IsWhitespace(*m_position))
+        {
+            char c = *m_position++;
+            if (c == '\\')
             {
-                if (pos == 2)
+                if (m_position != end)
                 {
-                    // TODO: error
+                    m_buffer += *m_position++;
+                }
+                else
+                {
+                    // A backslash at the end of the file has nothing to escape
+                    m_buffer += c;
                 }
-                option_name = CString::Substring(arg, 2, pos);
-                // TODO: what if value is empty, maybe that is valid?
-                option_value = CString::Substring(arg, pos + 1);
             }
-            else
+            else if (c == '\'')
             {
-                option_name = CString::Substring(arg, 2);
-                // TODO: use spec to find value to assign
-                option_value = "";
+                const char* quote = static_cast<const char*>(std::memchr(m_position, '\'', end - m_position));
+                if (!quote)
+                {
+                    fail("unterminated quote", m_position - 1);
+                }
+                m_buffer.append(m_position, quote - m_position);
+                m_position = quote + 1;
             }
-        }
-        else if (CString::StartsWith(arg, "-"))
-        {
-            std::string short_name;
-            size_t pos = CString::Find(arg, "=");
-            if (pos != std::string::npos)
+            else if (c == '"')
             {
-                if (pos == 1)
+                const char* quote = m_position - 1;
+                while ((m_position != end) && (*m_position != '"'))
                 {
-                    // TODO: error
+                    if ((*m_position == '\\') && ((m_position + 1) != end)
+                        && ((m_position[1] == '"') || (m_position[1] == '\\')))
+                    {
+                        ++m_position;
+                    }
+                    m_buffer += *m_position++;
                 }
-                short_name = CString::Substring(arg, 1, pos);
-                option_value = CString::Substring(arg, pos + 1);
+                if (m_position == end)
+                {
+                    fail("unterminated quote", quote);
+                }
+                ++m_position;
             }
             else
             {
-                short_name = CString::Substring(arg, 1);
-                option_value = "";
+                m_buffer += c;
+            }
+        }
+        argument = m_buffer;
+        return true;
+    }
+
+    [[noreturn]] void fail(const std::string& message, const char* position) const
+    {
+        throw ConfigurationParseError::AtOffset("response file " + m_file_path + ": " + message, m_text,
+            static_cast<size_t>(position - m_text.data()));
+    }
+
+    // The position of the start of the next argument, or of the whitespace before it
+    const char* position() const noexcept
+    {
+        return m_position;
+    }
+
+private:
+    const std::string& m_file_path;
+    boost::string_view m_text;
+    const char* m_position;
+    std::string& m_buffer;
+};
+
+// The parsing logic shared by both kinds of specification. The Specification parameter is one of the adapters above.
+// The lookup_value buffer is reused for every argument so once it is large enough no allocation happens.
+template<typename Specification>
+class ArgumentParser
+{
+public:
+    ArgumentParser(Specification& specification, Configuration& configuration, std::string& lookup_value,
+        CommandLineParser::ResponseFiles response_files)
+        : m_specification(specification), m_command(specification.root()), m_configuration(configuration),
+        m_positional_option(0), m_lookup_value(lookup_value),
+        m_expand_response_files(response_files == CommandLineParser::ResponseFiles::enabled)
+    {
+    }
+
+    void parse(int argc, const char* argv[])
+    {
+        // The first argument is the executable so we ignore it
+        for (int i = 1; i < argc; ++i)
+        {
+            boost::string_view argument = argv[i];
+            if (!m_expand_response_files)
+            {
+                parseArgument(argument);
+            }
+            else if (IsResponseFile(argument))
+            {
+                std::string file_path(argument.data() + 1, argument.size() - 1);
+                std::string canonical_path = CanonicalPath(file_path);
+                parseResponseFile(file_path, std::move(canonical_path));
             }
-            CommandLineSpecification::OptionDetails details;
-            if (specification.findShortNamedOption(short_name, option_name, details))
+            else
             {
-                // TODO: what if value is empty, maybe that is valid?
+                parseArgument(RemoveEscape(argument));
             }
         }
-        else
+    }
+
+private:
+    // When response files are expanded an argument that starts with "@@" stands for the same argument with a single
+    // '@' instead of a response file
+    static bool IsResponseFile(boost::string_view argument)
+    {
+        return ((argument.size() > 1) && (argument[0] == '@') && (argument[1] != '@'));
+    }
+
+    static boost::string_view RemoveEscape(boost::string_view argument)
+    {
+        return (argument.starts_with("@@") ? argument.substr(1) : argument);
+    }
+
+    // The arguments in the file are parsed as if they were on the command line in place of the @file argument. The
+    // file is mapped in memory and the arguments are parsed as they are tokenized, so even a file with a very large
+    // number of arguments isn't copied.
+    void parseResponseFile(const std::string& file_path, std::string canonical_path)
+    {
+        MemoryMappedFile file(canonical_path);
+        m_response_files.push_back(std::move(canonical_path));
+        ResponseFileTokenizer tokenizer(file_path, file.view(), m_unescaped_argument);
+        boost::string_view argument;
+        while (tokenizer.next(argument))
         {
-            ++positional_option;
-            
-            CommandLineSpecification::OptionDetails details;
-            if (command_details.findPositionalOption(positional_option, option_name, details))
+            // A quoted or escaped argument is never a response file, and is taken as is
+            if (argument.data() == m_unescaped_argument.data())
             {
-                if (details.isValueAllowed(arg))
-                {
-                    option_value = arg;
-                    current_command_option = true;
-                }
-                else
-                {
-                    // TODO: error
-                }
+                parseArgument(argument);
             }
-            else if (specification.findPositionalOption(positional_option, option_name, details))
+            else if (IsResponseFile(argument))
             {
-                if (details.isValueAllowed(arg))
-                {
-                    option_value = arg;
-                }
-                else
+                std::string nested_file_path(argument.data() + 1, argument.size() - 1);
+                std::string nested_canonical_path = CanonicalPath(nested_file_path);
+                if (std::find(m_response_files.begin(), m_response_files.end(), nested_canonical_path)
+                    != m_response_files.end())
                 {
-                    // TODO: error
+                    tokenizer.fail(nested_file_path + " is already being read", argument.data());
                 }
+                parseResponseFile(nested_file_path, std::move(nested_canonical_path));
             }
             else
             {
-                // TODO
+                parseArgument(RemoveEscape(argument));
             }
         }
+        m_response_files.pop_back();
+    }
+
+    void parseArgument(boost::string_view argument)
+    {
+        boost::string_view argument_name;
+        boost::string_view option_value;
+        ArgumentType argument_type = TokenizeArgument(argument, argument_name, option_value);
 
-        CommandLineSpecification::CommandDetails new_command_details;
-        if (command_details.findCommand(option_name, option_value, new_command_details))
+        const std::string* option_name = nullptr;
+        // Null for named options that are not part of the specification
+        const CommandLineSpecification::OptionDetails* details = nullptr;
+        bool current_command_option = false;
+        switch (argument_type)
         {
-            Configuration command_configuration;
-            command_configuration.set("name", option_value);
-            current_command_configuration->set(option_name, command_configuration);
-            current_command_configuration = &current_command_configuration->value(option_name).asConfiguration();
-            command_details = new_command_details;
+        case ArgumentType::named:
+            option_name = m_specification.findNamedOption(argument_name, details);
+            break;
+
+        case ArgumentType::short_named:
+            option_name = m_specification.findShortNamedOption(argument_name, details);
+            break;
+
+        case ArgumentType::positional:
+            ++m_positional_option;
+            if (m_specification.findPositionalOption(m_command, m_positional_option, option_name, details,
+                current_command_option))
+            {
+                m_lookup_value.assign(option_value.data(), option_value.size());
+                if (!details->isValueAllowed(m_lookup_value))
+                {
+                    // The argument is ignored but still takes its position, the next positional argument is
+                    // matched against the next positional option
+                    option_name = nullptr;
+                }
+            }
+            break;
         }
-        else if (specification.findCommand(option_name, option_value, new_command_details))
+
+        if (!option_name)
+        {
+            // The argument doesn't match anything in the specification, or its value isn't allowed, so it is ignored
+            return;
+        }
+
+        m_lookup_value.assign(option_value.data(), option_value.size());
+        typename Specification::Command new_command = nullptr;
+        if (m_specification.findCommand(m_command, *option_name, m_lookup_value, new_command))
         {
-            Configuration command_configuration;
-            command_configuration.set("name", option_value);
-            current_command_configuration->set(option_name, command_configuration);
-            current_command_configuration = &current_command_configuration->value(option_name).asConfiguration();
-            command_details = new_command_details;
+            // The nested configuration is constructed in place rather than built separately and copied
+            Configuration& parent_configuration = currentCommandConfiguration();
+            Configuration& command_configuration =
+                parent_configuration.emplace(*option_name,
+                    Configuration(parent_configuration.arena())).asConfiguration();
+            command_configuration.set("name", m_lookup_value);
+            m_command_path.push_back(Configuration::Key(*option_name));
+            m_command = new_command;
         }
         else
         {
-            if (current_command_option)
+            Configuration& option_configuration =
+                (current_command_option ? currentCommandConfiguration() : m_configuration);
+            if (details && (details->valueType() != Configuration::Value::Type::string))
             {
-                current_command_configuration->set(option_name, option_value);
+                option_configuration.set(*option_name, details->createValue(option_value));
             }
             else
             {
-                configuration.set(option_name, option_value);
+                option_configuration.set(*option_name, m_lookup_value);
             }
         }
     }
+
+    // The configuration of the command is looked up again each time rather than kept, since setting an option in one
+    // of its parents moves it. The lookups use keys so each level is an array index unless an option was added there
+    // since the previous lookup.
+    Configuration& currentCommandConfiguration()
+    {
+        Configuration* result = &m_configuration;
+        for (const Configuration::Key& key : m_command_path)
+        {
+            result = &result->value(key).asConfiguration();
+        }
+        return *result;
+    }
+
+    Specification& m_specification;
+    typename Specification::Command m_command;
+    Configuration& m_configuration;
+    // The options that selected the commands, from the root to the current command
+    std::vector<Configuration::Key> m_command_path;
+    size_t m_positional_option;
+    std::string& m_lookup_value;
+    bool m_expand_response_files;
+    // The response files that are being read, a file that is already in the list would be read forever
+    std::vector<std::string> m_response_files;
+    std::string m_unescaped_argument;
+};
+
+template<typename Specification>
+void ParseArguments(Specification& specification, int argc, const char* argv[], Configuration& configuration,
+    std::string& lookup_value, CommandLineParser::ResponseFiles response_files)
+{
+    ArgumentParser<Specification> parser(specification, configuration, lookup_value, response_files);
+    parser.parse(argc, argv);
+}
+
+}
+
+void CommandLineParser::parse(const CommandLineSpecification& specification, int argc, const char* argv[],
+    Configuration& configuration, ResponseFiles response_files)
+{
+    SpecificationLookup lookup(specification);
+    std::string lookup_value;
+    ParseArguments(lookup, argc, argv, configuration, lookup_value, response_files);
 }
 
 void CommandLineParser::parse(const CommandLineSpecification& specification, int argc, char* argv[],
-    Configuration& configuration)
+    Configuration& configuration, ResponseFiles response_files)
+{
+    parse(specification, argc, (const char**)(argv), configuration, response_files);
+}
+
+void CommandLineParser::parse(const CompiledCommandLineSpecification& specification, int argc, const char* argv[],
+    Configuration& configuration, ResponseFiles response_files)
+{
+    std::string lookup_name;
+    CompiledSpecificationLookup lookup(specification, lookup_name);
+    std::string lookup_value;
+    ParseArguments(lookup, argc, argv, configuration, lookup_value, response_files);
+}
+
+void CommandLineParser::parse(const CompiledCommandLineSpecification& specification, int argc, char* argv[],
+    Configuration& configuration, ResponseFiles response_files)
+{
+    parse(specification, argc, (const char**)(argv), configuration, response_files);
+}
+
+std::vector<Configuration> CommandLineParser::parseBatch(const CommandLineSpecification& specification,
+    const std::vector<std::vector<const char*>>& command_lines, size_t thread_count, ResponseFiles response_files)
+{
+    return parseBatch(specification.compile(), command_lines, thread_count, response_files);
+}
+
+std::vector<Configuration> CommandLineParser::parseBatch(const CompiledCommandLineSpecification& specification,
+    const std::vector<std::vector<const char*>>& command_lines, size_t thread_count, ResponseFiles response_files)
+{
+    std::vector<Configuration> result(command_lines.size());
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    // The threads take the command lines by chunks so that they don't contend on the counter
+    const size_t chunk_size = 64;
+    thread_count = std::min(thread_count, (command_lines.size() + chunk_size - 1) / chunk_size);
+
+    std::atomic<size_t> next_chunk(0);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto worker = [&]()
+    {
+        // Each thread has its own lookup buffers
+        std::string lookup_name;
+        std::string lookup_value;
+        CompiledSpecificationLookup lookup(specification, lookup_name);
+        try
+        {
+            for (size_t begin = (next_chunk++ * chunk_size); begin < command_lines.size();
+                begin = (next_chunk++ * chunk_size))
+            {
+                size_t end = std::min(begin + chunk_size, command_lines.size());
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const std::vector<const char*>& argv = command_lines[i];
+                    ParseArguments(lookup, static_cast<int>(argv.size()), const_cast<const char**>(argv.data()),
+                        result[i], lookup_value, response_files);
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            // Makes the other threads stop after their current chunk
+            next_chunk = command_lines.size();
+        }
+    };
+
+    // The calling thread is one of the workers
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i)
+    {
+        try
+        {
+            threads.emplace_back(worker);
+        }
+        catch (const std::system_error&)
+        {
+            // The threads that could be created take up the work
+            break;
+        }
+    }
+    worker();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+CommandLineParser::Session::Session(const CommandLineSpecification& specification, ResponseFiles response_files)
+    : Session(CompiledCommandLineSpecification(specification), response_files)
+{
+}
+
+CommandLineParser::Session::Session(const CompiledCommandLineSpecification& specification,
+    ResponseFiles response_files)
+    : m_specification(specification), m_response_files(response_files),
+    m_defaults(specification.createDefaultConfiguration())
+{
+}
+
+const Configuration& CommandLineParser::Session::parse(int argc, const char* argv[])
+{
+    m_configuration.assign(m_defaults);
+    CompiledSpecificationLookup lookup(m_specification, m_lookup_name);
+    ParseArguments(lookup, argc, argv, m_configuration, m_lookup_value, m_response_files);
+    return m_configuration;
+}
+
+const Configuration& CommandLineParser::Session::parse(int argc, char* argv[])
 {
-    parse(specification, argc, (const char**)(argv), configuration);
+    return parse(argc, (const char**)(argv));
 }
@@ -2,22 +2,151 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "CommandLineSpecification.hpp"
-#include <algorithm>
+#include "CompiledCommandLineSpecification.hpp"
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <regex>
+#include <stdexcept>
+#include <unordered_set>
 
 using namespace Ishiko;
 
+namespace
+{
+
+// Only ASCII letters are folded so the result doesn't depend on the current locale
+char ToLowerASCII(char c) noexcept
+{
+    return (((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c);
+}
+
+// Hash and equality for the allowed values set, they ignore the case of ASCII letters if requested
+class AllowedValueHash
+{
+public:
+    explicit AllowedValueHash(CommandLineSpecification::CaseSensitivity case_sensitivity) noexcept
+        : m_case_sensitivity(case_sensitivity)
+    {
+    }
+
+    size_t operator()(const std::string& value) const noexcept
+    {
+        if (m_case_sensitivity == CommandLineSpecification::CaseSensitivity::sensitive)
+        {
+            return std::hash<std::string>()(value);
+        }
+
+        // FNV-1a on the lower case characters so that no temporary string is needed
+        size_t result = static_cast<size_t>(2166136261U);
+        for (char c : value)
+        {
+            result ^= static_cast<unsigned char>(ToLowerASCII(c));
+            result *= static_cast<size_t>(16777619U);
+        }
+        return result;
+    }
+
+private:
+    CommandLineSpecification::CaseSensitivity m_case_sensitivity;
+};
+
+class AllowedValueEqual
+{
+public:
+    explicit AllowedValueEqual(CommandLineSpecification::CaseSensitivity case_sensitivity) noexcept
+        : m_case_sensitivity(case_sensitivity)
+    {
+    }
+
+    bool operator()(const std::string& lhs, const std::string& rhs) const noexcept
+    {
+        if (m_case_sensitivity == CommandLineSpecification::CaseSensitivity::sensitive)
+        {
+            return (lhs == rhs);
+        }
+
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.size(); ++i)
+        {
+            if (ToLowerASCII(lhs[i]) != ToLowerASCII(rhs[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    CommandLineSpecification::CaseSensitivity m_case_sensitivity;
+};
+
+}
+
+class CommandLineSpecification::OptionDetails::AllowedValueSet
+{
+public:
+    AllowedValueSet(const std::vector<std::string>& values, CaseSensitivity case_sensitivity)
+        : m_values(values.begin(), values.end(), values.size(), AllowedValueHash(case_sensitivity),
+            AllowedValueEqual(case_sensitivity))
+    {
+    }
+
+    bool empty() const noexcept
+    {
+        return m_values.empty();
+    }
+
+    bool contains(const std::string& value) const noexcept
+    {
+        return (m_values.find(value) != m_values.end());
+    }
+
+private:
+    std::unordered_set<std::string, AllowedValueHash, AllowedValueEqual> m_values;
+};
+
+class CommandLineSpecification::OptionDetails::AllowedPattern
+{
+public:
+    explicit AllowedPattern(const std::string& pattern)
+        : m_regex(pattern, std::regex::ECMAScript | std::regex::optimize)
+    {
+    }
+
+    bool matches(const std::string& value) const noexcept
+    {
+        try
+        {
+            return std::regex_match(value, m_regex);
+        }
+        catch (...)
+        {
+            // The only error regex_match can report is that the expression is too complex to match this value
+            return false;
+        }
+    }
+
+private:
+    std::regex m_regex;
+};
+
 CommandLineSpecification::OptionDetails::OptionDetails()
-    : m_type(OptionType::uninitialized)
+    : m_type(OptionType::uninitialized), m_value_type(Configuration::Value::Type::string)
 {
 }
 
 CommandLineSpecification::OptionDetails::OptionDetails(OptionType type)
-    : m_type(type)
+    : m_type(type), m_value_type(Configuration::Value::Type::string)
 {
 }
 
 CommandLineSpecification::OptionDetails::OptionDetails(OptionType type, std::string default_value)
-    : m_type(type), m_default_value(std::move(default_value))
+    : m_type(type), m_value_type(Configuration::Value::Type::string), m_default_value(std::move(default_value))
 {
 }
 
@@ -26,6 +155,11 @@ CommandLineSpecification::OptionType CommandLineSpecification::OptionDetails::ty
     return m_type;
 }
 
+Configuration::Value::Type CommandLineSpecification::OptionDetails::valueType() const noexcept
+{
+    return m_value_type;
+}
+
 const boost::optional<std::string>& CommandLineSpecification::OptionDetails::defaultValue() const noexcept
 {
     return m_default_value;
@@ -33,14 +167,34 @@ const boost::optional<std::string>& CommandLineSpecification::OptionDetails::def
 
 bool CommandLineSpecification::OptionDetails::isValueAllowed(const std::string& value) const noexcept
 {
-    if (m_allowed_values.empty())
+    if ((!m_allowed_values || m_allowed_values->empty()) && !m_allowed_range && !m_allowed_pattern)
     {
         return true;
     }
-    else
+
+    if (m_allowed_values && m_allowed_values->contains(value))
     {
-        return (std::find(m_allowed_values.begin(), m_allowed_values.end(), value) != m_allowed_values.end());
+        return true;
     }
+
+    if (m_allowed_range && !value.empty())
+    {
+        errno = 0;
+        char* end = nullptr;
+        long long number = std::strtoll(value.c_str(), &end, 10);
+        if ((errno == 0) && (*end == 0) && !std::isspace(static_cast<unsigned char>(value[0]))
+            && (number >= m_allowed_range->first) && (number <= m_allowed_range->second))
+        {
+            return true;
+        }
+    }
+
+    if (m_allowed_pattern)
+    {
+        return m_allowed_pattern->matches(value);
+    }
+
+    return false;
 }
 
 void CommandLineSpecification::OptionDetails::setDefaultValue(const boost::optional<std::string>& value)
@@ -60,11 +214,47 @@ void CommandLineSpecification::OptionDetails::setDefaultValue(const char* value)
     }
 }
 
-void CommandLineSpecification::OptionDetails::setAllowedValues(const std::vector<std::string>& values)
+void CommandLineSpecification::OptionDetails::setValueType(Configuration::Value::Type type)
+{
+    if ((type == Configuration::Value::Type::string_array) || (type == Configuration::Value::Type::configuration))
+    {
+        throw std::invalid_argument("OptionDetails::setValueType: the type has no text representation");
+    }
+    m_value_type = type;
+}
+
+Configuration::Value CommandLineSpecification::OptionDetails::createValue(boost::string_view text) const
+{
+    if ((m_type == OptionType::toggle) && text.empty() && (m_value_type == Configuration::Value::Type::boolean))
+    {
+        // The toggle is set by its name alone
+        return Configuration::Value(true);
+    }
+
+    Configuration::Value result;
+    if (!Configuration::Value::Parse(text, m_value_type, result))
+    {
+        throw std::invalid_argument("OptionDetails::createValue: \"" + std::string(text.data(), text.size())
+            + "\" can't be converted to the value type of the option");
+    }
+    return result;
+}
+
+void CommandLineSpecification::OptionDetails::setAllowedValues(const std::vector<std::string>& values,
+    CaseSensitivity case_sensitivity)
+{
+    m_allowed_values = std::make_shared<const AllowedValueSet>(values, case_sensitivity);
+}
+
+void CommandLineSpecification::OptionDetails::setAllowedRange(int64_t minimum, int64_t maximum)
 {
-    m_allowed_values = values;
+    m_allowed_range = std::make_pair(minimum, maximum);
 }
 
+void CommandLineSpecification::OptionDetails::setAllowedPattern(const std::string& pattern)
+{
+    m_allowed_pattern = std::make_shared<const AllowedPattern>(pattern);
+}
 
 void CommandLineSpecification::CommandDetails::addPositionalOption(size_t position, const std::string& name,
     const OptionDetails& details)
@@ -74,12 +264,29 @@ void CommandLineSpecification::CommandDetails::addPositionalOption(size_t positi
 
 bool CommandLineSpecification::CommandDetails::findPositionalOption(size_t position, std::string& name,
     OptionDetails& details) const
+{
+    const std::string* found_name = nullptr;
+    const OptionDetails* found_details = nullptr;
+    if (findPositionalOption(position, found_name, found_details))
+    {
+        name = *found_name;
+        details = *found_details;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool CommandLineSpecification::CommandDetails::findPositionalOption(size_t position, const std::string*& name,
+    const OptionDetails*& details) const noexcept
 {
     std::map<size_t, std::pair<std::string, OptionDetails>>::const_iterator it = m_positional_options.find(position);
     if (it != m_positional_options.end())
     {
-        name = it->second.first;
-        details = it->second.second;
+        name = &it->second.first;
+        details = &it->second.second;
         return true;
     }
     else
@@ -97,6 +304,18 @@ CommandLineSpecification::CommandDetails& CommandLineSpecification::CommandDetai
 
 bool CommandLineSpecification::CommandDetails::findCommand(const std::string& option_name,
     const std::string& command_name, CommandDetails& details) const
+{
+    const CommandDetails* found_details = nullptr;
+    if (findCommand(option_name, command_name, found_details))
+    {
+        details = *found_details;
+        return true;
+    }
+    return false;
+}
+
+bool CommandLineSpecification::CommandDetails::findCommand(const std::string& option_name,
+    const std::string& command_name, const CommandDetails*& details) const noexcept
 {
     std::map<std::string, std::map<std::string, CommandDetails>>::const_iterator option_it = m_commands.find(option_name);
     if (option_it != m_commands.end())
@@ -104,7 +323,7 @@ bool CommandLineSpecification::CommandDetails::findCommand(const std::string& op
         std::map<std::string, CommandDetails>::const_iterator command_it = option_it->second.find(command_name);
         if (command_it != option_it->second.end())
         {
-            details = command_it->second;
+            details = &command_it->second;
             return true;
         }
     }
@@ -120,13 +339,18 @@ Configuration CommandLineSpecification::createDefaultConfiguration() const
         boost::optional<std::string> defaultValue = option.second.defaultValue();
         if (defaultValue.has_value())
         {
-            result.set(option.first, *defaultValue);
+            result.set(option.first, option.second.createValue(*defaultValue));
         }
     }
 
     return result;
 }
 
+CompiledCommandLineSpecification CommandLineSpecification::compile() const
+{
+    return CompiledCommandLineSpecification(*this);
+}
+
 CommandLineSpecification::CommandDetails& CommandLineSpecification::addCommand(const std::string& option_name,
     const std::string& command_name)
 {
@@ -162,6 +386,18 @@ void CommandLineSpecification::addNamedOption(const std::string& name, const std
 
 bool CommandLineSpecification::findCommand(const std::string& option_name, const std::string& command_name,
     CommandDetails& details) const
+{
+    const CommandDetails* found_details = nullptr;
+    if (findCommand(option_name, command_name, found_details))
+    {
+        details = *found_details;
+        return true;
+    }
+    return false;
+}
+
+bool CommandLineSpecification::findCommand(const std::string& option_name, const std::string& command_name,
+    const CommandDetails*& details) const noexcept
 {
     std::map<std::string, std::map<std::string, CommandDetails>>::const_iterator option_it = m_commands.find(option_name);
     if (option_it != m_commands.end())
@@ -169,7 +405,7 @@ bool CommandLineSpecification::findCommand(const std::string& option_name, const
         std::map<std::string, CommandDetails>::const_iterator command_it = option_it->second.find(command_name);
         if (command_it != option_it->second.end())
         {
-            details = command_it->second;
+            details = &command_it->second;
             return true;
         }
     }
@@ -177,12 +413,29 @@ bool CommandLineSpecification::findCommand(const std::string& option_name, const
 }
 
 bool CommandLineSpecification::findPositionalOption(size_t position, std::string& name, OptionDetails& details) const
+{
+    const std::string* found_name = nullptr;
+    const OptionDetails* found_details = nullptr;
+    if (findPositionalOption(position, found_name, found_details))
+    {
+        name = *found_name;
+        details = *found_details;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool CommandLineSpecification::findPositionalOption(size_t position, const std::string*& name,
+    const OptionDetails*& details) const noexcept
 {
     std::map<size_t, std::pair<std::string, OptionDetails>>::const_iterator it = m_positional_options.find(position);
     if (it != m_positional_options.end())
     {
-        name = it->second.first;
-        details = it->second.second;
+        name = &it->second.first;
+        details = &it->second.second;
         return true;
     }
     else
@@ -192,11 +445,25 @@ bool CommandLineSpecification::findPositionalOption(size_t position, std::string
 }
 
 bool CommandLineSpecification::findNamedOption(const std::string& name, OptionDetails& details) const
+{
+    const OptionDetails* found_details = nullptr;
+    if (findNamedOption(name, found_details))
+    {
+        details = *found_details;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool CommandLineSpecification::findNamedOption(const std::string& name, const OptionDetails*& details) const noexcept
 {
     std::map<std::string, OptionDetails>::const_iterator it = m_named_options.find(name);
     if (it != m_named_options.end())
     {
-        details = it->second;
+        details = &it->second;
         return true;
     }
     else
@@ -207,12 +474,29 @@ bool CommandLineSpecification::findNamedOption(const std::string& name, OptionDe
 
 bool CommandLineSpecification::findShortNamedOption(const std::string& short_name, std::string& name,
     OptionDetails& details) const
+{
+    const std::string* found_name = nullptr;
+    const OptionDetails* found_details = nullptr;
+    if (findShortNamedOption(short_name, found_name, found_details))
+    {
+        name = *found_name;
+        details = *found_details;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool CommandLineSpecification::findShortNamedOption(const std::string& short_name, const std::string*& name,
+    const OptionDetails*& details) const noexcept
 {
     std::map<std::string, std::string>::const_iterator name_it = m_short_named_options.find(short_name);
     if (name_it != m_short_named_options.end())
     {
-        name = name_it->second;
-        return findNamedOption(name, details);
+        name = &name_it->second;
+        return findNamedOption(name_it->second, details);
     }
     else
     {
@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CompiledCommandLineSpecification.hpp"
+#include <algorithm>
+#include <cstdint>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// Up to this number of subcommands findCommand compares the names of all the subcommands instead of looking them up
+// in the perfect hash table
+const size_t MaxLinearSearchSubcommands = 8;
+
+}
+
+CompiledCommandLineSpecification::CompiledCommandLineSpecification()
+    : CompiledCommandLineSpecification(CommandLineSpecification())
+{
+}
+
+CompiledCommandLineSpecification::CompiledCommandLineSpecification(const CommandLineSpecification& specification)
+{
+    for (const std::pair<const std::string, CommandLineSpecification::OptionDetails>& option :
+        specification.m_named_options)
+    {
+        // The map is sorted by name so the indices end up sorted by name as well
+        m_named_options.push_back(m_options.size());
+        m_options.push_back(CreateOption(option.first, option.second));
+    }
+
+    m_named_options_index = PerfectHashIndex(m_named_options.size(),
+        [this](size_t index, uint64_t seed)
+        {
+            return PerfectHashIndex::Hash(m_options[m_named_options[index]].name, seed);
+        });
+
+    for (const std::pair<const std::string, std::string>& short_name : specification.m_short_named_options)
+    {
+        const Option* option = findNamedOption(short_name.second);
+        if (option)
+        {
+            m_short_named_options.emplace_back(short_name.first, option - m_options.data());
+        }
+    }
+    m_short_named_options_index = PerfectHashIndex(m_short_named_options.size(),
+        [this](size_t index, uint64_t seed)
+        {
+            return PerfectHashIndex::Hash(m_short_named_options[index].first, seed);
+        });
+
+    addCommand(specification.m_positional_options, specification.m_commands);
+    m_subcommands_index = PerfectHashIndex(m_subcommands.size(),
+        [this](size_t index, uint64_t seed)
+        {
+            const Subcommand& subcommand = m_subcommands[index];
+            return HashSubcommand(subcommand.parent, subcommand.option_name, subcommand.command_name, seed);
+        });
+}
+
+Configuration CompiledCommandLineSpecification::createDefaultConfiguration() const
+{
+    Configuration result;
+
+    for (size_t index : m_named_options)
+    {
+        const Option& option = m_options[index];
+        if (option.default_value)
+        {
+            result.set(option.name, *option.default_value);
+        }
+    }
+
+    return result;
+}
+
+const CompiledCommandLineSpecification::Command& CompiledCommandLineSpecification::root() const noexcept
+{
+    return m_commands.front();
+}
+
+size_t CompiledCommandLineSpecification::namedOptionCount() const noexcept
+{
+    return m_named_options.size();
+}
+
+const CompiledCommandLineSpecification::Option& CompiledCommandLineSpecification::namedOption(
+    size_t index) const noexcept
+{
+    return m_options[m_named_options[index]];
+}
+
+const CompiledCommandLineSpecification::Command* CompiledCommandLineSpecification::findCommand(
+    const Command& command, boost::string_view option_name, boost::string_view command_name) const noexcept
+{
+    // Most commands only have a few subcommands, comparing the names directly is then cheaper than hashing them
+    if ((command.m_subcommands_end - command.m_subcommands_begin) <= MaxLinearSearchSubcommands)
+    {
+        for (size_t i = command.m_subcommands_begin; i < command.m_subcommands_end; ++i)
+        {
+            const Subcommand& subcommand = m_subcommands[i];
+            if ((subcommand.command_name == command_name) && (subcommand.option_name == option_name))
+            {
+                return &m_commands[subcommand.command];
+            }
+        }
+        return nullptr;
+    }
+
+    size_t index = m_subcommands_index.find(
+        HashSubcommand(command.m_index, option_name, command_name, m_subcommands_index.seed()));
+    if (index != PerfectHashIndex::npos)
+    {
+        const Subcommand& subcommand = m_subcommands[index];
+        if ((subcommand.parent == command.m_index) && (subcommand.option_name == option_name)
+            && (subcommand.command_name == command_name))
+        {
+            return &m_commands[subcommand.command];
+        }
+    }
+    return nullptr;
+}
+
+const CompiledCommandLineSpecification::Option* CompiledCommandLineSpecification::findPositionalOption(
+    const Command& command, size_t position) const noexcept
+{
+    std::vector<std::pair<size_t, size_t>>::const_iterator begin =
+        m_positional_options.begin() + command.m_positional_options_begin;
+    std::vector<std::pair<size_t, size_t>>::const_iterator end =
+        m_positional_options.begin() + command.m_positional_options_end;
+    std::vector<std::pair<size_t, size_t>>::const_iterator it = std::lower_bound(begin, end, position,
+        [](const std::pair<size_t, size_t>& option, size_t position)
+        {
+            return (option.first < position);
+        });
+    if ((it != end) && (it->first == position))
+    {
+        return &m_options[it->second];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+const CompiledCommandLineSpecification::Option* CompiledCommandLineSpecification::findNamedOption(
+    boost::string_view name) const noexcept
+{
+    size_t index = m_named_options_index.find(PerfectHashIndex::Hash(name, m_named_options_index.seed()));
+    if ((index != PerfectHashIndex::npos) && (m_options[m_named_options[index]].name == name))
+    {
+        return &m_options[m_named_options[index]];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+const CompiledCommandLineSpecification::Option* CompiledCommandLineSpecification::findShortNamedOption(
+    boost::string_view short_name) const noexcept
+{
+    size_t index = m_short_named_options_index.find(
+        PerfectHashIndex::Hash(short_name, m_short_named_options_index.seed()));
+    if ((index != PerfectHashIndex::npos) && (m_short_named_options[index].first == short_name))
+    {
+        return &m_options[m_short_named_options[index].second];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+const Configuration::Value* CompiledCommandLineSpecification::findDefaultValue(const Command& command,
+    boost::string_view name) const noexcept
+{
+    const Option* option = nullptr;
+    if (&command == &root())
+    {
+        option = findNamedOption(name);
+    }
+    if (!option)
+    {
+        // Commands only have a few positional options so they are searched linearly
+        for (size_t i = command.m_positional_options_begin; i < command.m_positional_options_end; ++i)
+        {
+            const Option& positional_option = m_options[m_positional_options[i].second];
+            if (positional_option.name == name)
+            {
+                option = &positional_option;
+                break;
+            }
+        }
+    }
+    return ((option && option->default_value) ? &*option->default_value : nullptr);
+}
+
+CompiledCommandLineSpecification::Option CompiledCommandLineSpecification::CreateOption(const std::string& name,
+    const CommandLineSpecification::OptionDetails& details)
+{
+    Option result;
+    result.name = name;
+    result.details = details;
+    if (details.defaultValue())
+    {
+        result.default_value = details.createValue(*details.defaultValue());
+    }
+    return result;
+}
+
+uint64_t CompiledCommandLineSpecification::HashSubcommand(size_t parent, boost::string_view option_name,
+    boost::string_view command_name, uint64_t seed) noexcept
+{
+    return PerfectHashIndex::Hash(command_name, seed, PerfectHashIndex::Hash(option_name, seed, parent));
+}
+
+size_t CompiledCommandLineSpecification::addCommand(const PositionalOptionsMap& positional_options,
+    const CommandsMap& commands)
+{
+    size_t result = m_commands.size();
+    m_commands.push_back(Command());
+    m_commands[result].m_index = result;
+
+    // The entries of this command are appended before recursing so that they are contiguous
+    m_commands[result].m_positional_options_begin = m_positional_options.size();
+    for (const PositionalOptionsMap::value_type& option : positional_options)
+    {
+        m_positional_options.emplace_back(option.first, m_options.size());
+        m_options.push_back(CreateOption(option.second.first, option.second.second));
+    }
+    m_commands[result].m_positional_options_end = m_positional_options.size();
+
+    m_commands[result].m_subcommands_begin = m_subcommands.size();
+    for (const CommandsMap::value_type& option : commands)
+    {
+        for (const std::pair<const std::string, CommandLineSpecification::CommandDetails>& command : option.second)
+        {
+            m_subcommands.push_back({result, option.first, command.first, 0});
+        }
+    }
+    m_commands[result].m_subcommands_end = m_subcommands.size();
+
+    size_t subcommand_index = m_commands[result].m_subcommands_begin;
+    for (const CommandsMap::value_type& option : commands)
+    {
+        for (const std::pair<const std::string, CommandLineSpecification::CommandDetails>& command : option.second)
+        {
+            size_t command_index = addCommand(command.second.m_positional_options, command.second.m_commands);
+            m_subcommands[subcommand_index++].command = command_index;
+        }
+    }
+
+    return result;
+}
@@ -2,34 +2,352 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "Configuration.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
 
 using namespace Ishiko;
 
+namespace
+{
+
+// Layout of the cache of Configuration::Key
+const int KeyIndexBits = 24;
+const uint64_t KeyIndexMask = ((uint64_t(1) << KeyIndexBits) - 1);
+const uint64_t KeyLayoutMask = ((uint64_t(1) << (64 - KeyIndexBits)) - 1);
+// Layout 0 is never returned by NewLayout, only configurations without options have it, so a key with this cache is
+// always looked up by name
+const uint64_t InvalidKeyCache = 0;
+
+std::atomic<uint64_t> g_last_layout(0);
+
+uint64_t NewLayout() noexcept
+{
+    // This wraps after 2^40 layout changes, at which point a stale key could in theory match a reused layout. The
+    // bounds check on the index makes sure this can't cause an invalid access.
+    uint64_t result;
+    do
+    {
+        result = ((g_last_layout.fetch_add(1, std::memory_order_relaxed) + 1) & KeyLayoutMask);
+    } while (result == 0);
+    return result;
+}
+
+bool IsSpace(char c) noexcept
+{
+    return ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\f') || (c == '\v'));
+}
+
+bool EqualsIgnoreCase(boost::string_view text, boost::string_view lower_case_text) noexcept
+{
+    if (text.size() != lower_case_text.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if ((c >= 'A') && (c <= 'Z'))
+        {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (c != lower_case_text[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parses a decimal integer with an optional sign, the whole text must be used
+bool ParseInteger(boost::string_view text, int64_t& value) noexcept
+{
+    size_t i = 0;
+    bool negative = false;
+    if ((i < text.size()) && ((text[i] == '-') || (text[i] == '+')))
+    {
+        negative = (text[i] == '-');
+        ++i;
+    }
+    if (i == text.size())
+    {
+        return false;
+    }
+
+    // Accumulate as a negative number since the range of negative numbers is larger
+    int64_t result = 0;
+    for (; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if ((c < '0') || (c > '9'))
+        {
+            return false;
+        }
+        int digit = (c - '0');
+        if (result < ((INT64_MIN + digit) / 10))
+        {
+            return false;
+        }
+        result = ((result * 10) - digit);
+    }
+    if (!negative)
+    {
+        if (result == INT64_MIN)
+        {
+            return false;
+        }
+        result = -result;
+    }
+    value = result;
+    return true;
+}
+
+// Returns the position of the unit suffix of a duration or size
+size_t FindUnit(boost::string_view text) noexcept
+{
+    size_t result = text.size();
+    while ((result > 0) && (((text[result - 1] >= 'a') && (text[result - 1] <= 'z'))
+        || ((text[result - 1] >= 'A') && (text[result - 1] <= 'Z'))))
+    {
+        --result;
+    }
+    return result;
+}
+
+// Returns the number of nanoseconds in the unit or 0 if the unit is not valid
+int64_t DurationUnit(boost::string_view unit) noexcept
+{
+    if (unit == "ns")
+    {
+        return 1;
+    }
+    else if (unit == "us")
+    {
+        return 1000;
+    }
+    else if (unit == "ms")
+    {
+        return 1000000;
+    }
+    else if (unit == "s")
+    {
+        return 1000000000;
+    }
+    else if (unit == "min")
+    {
+        return 60 * int64_t(1000000000);
+    }
+    else if (unit == "h")
+    {
+        return 3600 * int64_t(1000000000);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// Returns the number of bytes in the unit or 0 if the unit is not valid
+uint64_t SizeUnit(boost::string_view unit) noexcept
+{
+    if (unit.empty() || (unit == "B"))
+    {
+        return 1;
+    }
+    else if ((unit == "K") || (unit == "KiB"))
+    {
+        return (uint64_t(1) << 10);
+    }
+    else if ((unit == "M") || (unit == "MiB"))
+    {
+        return (uint64_t(1) << 20);
+    }
+    else if ((unit == "G") || (unit == "GiB"))
+    {
+        return (uint64_t(1) << 30);
+    }
+    else if ((unit == "T") || (unit == "TiB"))
+    {
+        return (uint64_t(1) << 40);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// Assigns the source value to the target, reusing the string buffers and the options of the target where possible
+void AssignValue(Configuration::Value& target, const Configuration::Value& source)
+{
+    if ((target.type() == Configuration::Value::Type::configuration)
+        && (source.type() == Configuration::Value::Type::configuration))
+    {
+        target.asConfiguration().assign(source.asConfiguration());
+    }
+    else
+    {
+        // When both values have the same type the variant assigns the contents directly
+        target = source;
+    }
+}
+
+}
+
 Configuration::Value::Value(const char* value)
-    : boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>>(value)
+    // Without the explicit conversion the variant would hold the bool alternative
+    : ValueBase(std::string(value))
 {
 }
 
 Configuration::Value::Value(const std::string& value)
-    : boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>>(value)
+    : ValueBase(value)
 {
 }
 
 Configuration::Value::Value(std::string&& value)
-    : boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>>(value)
+    : ValueBase(std::move(value))
 {
 }
 
 Configuration::Value::Value(const std::vector<std::string>& value)
-    : boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>>(value)
+    : ValueBase(value)
+{
+}
+
+Configuration::Value::Value(std::vector<std::string>&& value)
+    : ValueBase(std::move(value))
 {
 }
 
 Configuration::Value::Value(const Configuration& value)
-    : boost::variant<std::string, std::vector<std::string>, boost::recursive_wrapper<Configuration>>(value)
+    : ValueBase(value)
+{
+}
+
+Configuration::Value::Value(Configuration&& value)
+    : ValueBase(std::move(value))
+{
+}
+
+Configuration::Value::Value(int64_t value)
+    : ValueBase(value)
+{
+}
+
+Configuration::Value::Value(double value)
+    : ValueBase(value)
+{
+}
+
+Configuration::Value::Value(bool value)
+    : ValueBase(value)
 {
 }
 
+Configuration::Value::Value(std::chrono::nanoseconds value)
+    : ValueBase(value)
+{
+}
+
+Configuration::Value::Value(uint64_t value)
+    : ValueBase(value)
+{
+}
+
+bool Configuration::Value::Parse(boost::string_view text, Type type, Value& value)
+{
+    switch (type)
+    {
+    case Type::string:
+        value = Value(std::string(text.data(), text.size()));
+        return true;
+
+    case Type::integer:
+        {
+            int64_t number;
+            if (ParseInteger(text, number))
+            {
+                value = Value(number);
+                return true;
+            }
+        }
+        break;
+
+    case Type::floating_point:
+        {
+            // strtod needs a null terminated string
+            std::string buffer(text.data(), text.size());
+            if (!buffer.empty() && !IsSpace(buffer[0]))
+            {
+                errno = 0;
+                char* end = nullptr;
+                double number = std::strtod(buffer.c_str(), &end);
+                // ERANGE is also reported for numbers too small to be normalized, only overflows are rejected
+                bool overflow = ((errno == ERANGE) && (std::fabs(number) == HUGE_VAL));
+                if (!overflow && (*end == 0))
+                {
+                    value = Value(number);
+                    return true;
+                }
+            }
+        }
+        break;
+
+    case Type::boolean:
+        if (EqualsIgnoreCase(text, "true") || EqualsIgnoreCase(text, "yes") || EqualsIgnoreCase(text, "on")
+            || (text == "1"))
+        {
+            value = Value(true);
+            return true;
+        }
+        else if (EqualsIgnoreCase(text, "false") || EqualsIgnoreCase(text, "no") || EqualsIgnoreCase(text, "off")
+            || (text == "0"))
+        {
+            value = Value(false);
+            return true;
+        }
+        break;
+
+    case Type::duration:
+        {
+            size_t unit_begin = FindUnit(text);
+            int64_t count;
+            int64_t nanoseconds_per_unit = DurationUnit(text.substr(unit_begin));
+            if ((nanoseconds_per_unit != 0) && ParseInteger(text.substr(0, unit_begin), count)
+                && (count <= (INT64_MAX / nanoseconds_per_unit)) && (count >= (INT64_MIN / nanoseconds_per_unit)))
+            {
+                value = Value(std::chrono::nanoseconds(count * nanoseconds_per_unit));
+                return true;
+            }
+        }
+        break;
+
+    case Type::size:
+        {
+            size_t unit_begin = FindUnit(text);
+            int64_t count;
+            uint64_t bytes_per_unit = SizeUnit(text.substr(unit_begin));
+            if ((bytes_per_unit != 0) && ParseInteger(text.substr(0, unit_begin), count) && (count >= 0)
+                && (static_cast<uint64_t>(count) <= (UINT64_MAX / bytes_per_unit)))
+            {
+                value = Value(static_cast<uint64_t>(count) * bytes_per_unit);
+                return true;
+            }
+        }
+        break;
+
+    case Type::string_array:
+    case Type::configuration:
+        // These have no text representation
+        break;
+    }
+
+    return false;
+}
+
 Configuration::Value::Type Configuration::Value::type() const
 {
     return static_cast<Configuration::Value::Type>(which());
@@ -55,26 +373,297 @@ Configuration& Configuration::Value::asConfiguration()
     return boost::get<Configuration>(*this);
 }
 
-size_t Configuration::size() const
+int64_t Configuration::Value::asInt() const
+{
+    return boost::get<int64_t>(*this);
+}
+
+double Configuration::Value::asDouble() const
+{
+    return boost::get<double>(*this);
+}
+
+bool Configuration::Value::asBool() const
+{
+    return boost::get<bool>(*this);
+}
+
+std::chrono::nanoseconds Configuration::Value::asDuration() const
+{
+    return boost::get<std::chrono::nanoseconds>(*this);
+}
+
+uint64_t Configuration::Value::asSize() const
+{
+    return boost::get<uint64_t>(*this);
+}
+
+Configuration::Key::Key(std::string name)
+    : m_name(std::move(name)), m_cache(InvalidKeyCache)
+{
+}
+
+Configuration::Key::Key(const Key& other)
+    : m_name(other.m_name), m_cache(other.m_cache.load(std::memory_order_relaxed))
+{
+}
+
+Configuration::Key& Configuration::Key::operator=(const Key& other)
+{
+    m_name = other.m_name;
+    m_cache.store(other.m_cache.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+const std::string& Configuration::Key::name() const noexcept
+{
+    return m_name;
+}
+
+Configuration::Path::Path(boost::string_view path)
+{
+    size_t begin = 0;
+    while (begin < path.size())
+    {
+        size_t end = path.find('.', begin);
+        if (end == boost::string_view::npos)
+        {
+            end = path.size();
+        }
+        boost::string_view segment = path.substr(begin, end - begin);
+        m_keys.emplace_back(std::string(segment.data(), segment.size()));
+        begin = (end + 1);
+    }
+}
+
+Configuration::Path::Path(const std::vector<std::string>& names)
+{
+    m_keys.reserve(names.size());
+    for (const std::string& name : names)
+    {
+        m_keys.emplace_back(name);
+    }
+}
+
+size_t Configuration::Path::size() const noexcept
+{
+    return m_keys.size();
+}
+
+const Configuration::Key& Configuration::Path::operator[](size_t index) const noexcept
+{
+    return m_keys[index];
+}
+
+Configuration::Builder::Builder(ConfigurationArena* arena)
+    : m_options(ConfigurationArena::Allocator<Entry>(arena)), m_sorted(true)
+{
+}
+
+void Configuration::Builder::reserve(size_t size)
+{
+    m_options.reserve(size);
+}
+
+void Configuration::Builder::add(std::string name, Value value)
+{
+    // The options only need to be sorted if they were not added in strictly increasing name order
+    if (m_sorted && !m_options.empty() && (m_options.back().first >= name))
+    {
+        m_sorted = false;
+    }
+    m_options.emplace_back(std::move(name), std::move(value));
+}
+
+size_t Configuration::Builder::size() const noexcept
 {
     return m_options.size();
 }
 
-const Configuration::Value& Configuration::value(const std::string& name) const
+Configuration Configuration::Builder::build()
+{
+    // The values can't be moved when a vector grows since the move constructor of a variant holding a
+    // recursive_wrapper may throw, so the options are moved to a vector of the right size instead. If they are not
+    // sorted pointers to them are sorted first, which is cheaper than moving the options around, and the options are
+    // moved in that order. The buffers of the builder are kept for the next configuration.
+    ConfigurationArena::Allocator<Entry> allocator = m_options.get_allocator();
+    Configuration result(allocator.arena());
+    if (!m_options.empty())
+    {
+        Options options(allocator);
+        if (m_sorted)
+        {
+            options.reserve(m_options.size());
+            for (Entry& entry : m_options)
+            {
+                options.emplace_back(std::move(entry));
+            }
+        }
+        else
+        {
+            m_order.clear();
+            for (Entry& entry : m_options)
+            {
+                m_order.push_back(&entry);
+            }
+            // The sort is stable so of several options with the same name the last one added is the last of its run
+            std::stable_sort(m_order.begin(), m_order.end(),
+                [](const Entry* lhs, const Entry* rhs)
+                {
+                    return (lhs->first < rhs->first);
+                });
+            size_t size = 0;
+            for (size_t i = 0; i < m_order.size(); ++i)
+            {
+                if (((i + 1) == m_order.size()) || (m_order[i]->first != m_order[i + 1]->first))
+                {
+                    ++size;
+                }
+            }
+            options.reserve(size);
+            for (size_t i = 0; i < m_order.size(); ++i)
+            {
+                if (((i + 1) == m_order.size()) || (m_order[i]->first != m_order[i + 1]->first))
+                {
+                    options.emplace_back(std::move(*m_order[i]));
+                }
+            }
+        }
+        result.m_options = std::allocate_shared<Options>(allocator, std::move(options));
+        result.m_layout = NewLayout();
+    }
+    m_options.clear();
+    m_sorted = true;
+    return result;
+}
+
+Configuration::Configuration() noexcept
+    : m_layout(0), m_arena(nullptr)
+{
+}
+
+Configuration::Configuration(ConfigurationArena* arena) noexcept
+    : m_layout(0), m_arena(arena)
+{
+}
+
+size_t Configuration::size() const
+{
+    return options().size();
+}
+
+Configuration::const_iterator Configuration::begin() const noexcept
+{
+    return options().begin();
+}
+
+Configuration::const_iterator Configuration::end() const noexcept
+{
+    return options().end();
+}
+
+ConfigurationArena* Configuration::arena() const noexcept
+{
+    return m_arena;
+}
+
+bool Configuration::isSharedWith(const Configuration& other) const noexcept
+{
+    return (m_options == other.m_options);
+}
+
+void Configuration::assign(const Configuration& other)
 {
-    return m_options.at(name);
+    if (m_options == other.m_options)
+    {
+        return;
+    }
+    if (!m_options || (m_options.use_count() > 1))
+    {
+        // There is no storage to reuse, or it is shared with copies that must not see the changes
+        m_options = other.m_options;
+        m_layout = other.m_layout;
+        return;
+    }
+    // Same as in mutableOptions, the options may only just have stopped being shared with another thread
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    Options& options = *m_options;
+    const Options& source = other.options();
+    bool names_changed = false;
+
+    // Assigns the options that are in both configurations in place and removes the others
+    size_t kept = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < options.size(); ++i)
+    {
+        while ((j < source.size()) && (source[j].first < options[i].first))
+        {
+            ++j;
+        }
+        if ((j < source.size()) && (source[j].first == options[i].first))
+        {
+            if (kept != i)
+            {
+                options[kept] = std::move(options[i]);
+            }
+            AssignValue(options[kept].second, source[j].second);
+            ++kept;
+            ++j;
+        }
+        else
+        {
+            names_changed = true;
+        }
+    }
+    options.erase(options.begin() + kept, options.end());
+
+    // Inserts the options that are only in the other configuration
+    if (options.size() != source.size())
+    {
+        names_changed = true;
+        size_t i = 0;
+        for (const Entry& entry : source)
+        {
+            if ((i == options.size()) || (options[i].first != entry.first))
+            {
+                options.insert(options.begin() + i, entry);
+            }
+            ++i;
+        }
+    }
+
+    // The names are now the same as the names of the other configuration so its layout can be reused
+    if (names_changed)
+    {
+        m_layout = other.m_layout;
+    }
 }
 
-Configuration::Value& Configuration::value(const std::string& name)
+const Configuration::Value& Configuration::value(boost::string_view name) const
 {
-    return m_options.at(name);
+    const_iterator it = find(name);
+    if (it == options().end())
+    {
+        throw std::out_of_range("Configuration::value: option not found");
+    }
+    return it->second;
 }
 
-const char* Configuration::valueOrDefault(const std::string& name,
-    const char* default_value) const noexcept
+Configuration::Value& Configuration::value(boost::string_view name)
 {
-    std::map<std::string, Value>::const_iterator it = m_options.find(name);
-    if (it != m_options.end())
+    const_iterator it = find(name);
+    if (it == options().end())
+    {
+        throw std::out_of_range("Configuration::value: option not found");
+    }
+    return mutableValue(it);
+}
+
+const char* Configuration::valueOrDefault(boost::string_view name, const char* default_value) const noexcept
+{
+    const_iterator it = find(name);
+    if ((it != options().end()) && (it->second.type() == Value::Type::string))
     {
         return it->second.asString().c_str();
     }
@@ -84,11 +673,11 @@ const char* Configuration::valueOrDefault(const std::string& name,
     }
 }
 
-const std::string& Configuration::valueOrDefault(const std::string& name,
+const std::string& Configuration::valueOrDefault(boost::string_view name,
     const std::string& defaultValue) const noexcept
 {
-    std::map<std::string, Value>::const_iterator it = m_options.find(name);
-    if (it != m_options.end())
+    const_iterator it = find(name);
+    if ((it != options().end()) && (it->second.type() == Value::Type::string))
     {
         return it->second.asString();
     }
@@ -98,11 +687,11 @@ const std::string& Configuration::valueOrDefault(const std::string& name,
     }
 }
 
-const std::vector<std::string>& Configuration::valueOrDefault(const std::string& name,
+const std::vector<std::string>& Configuration::valueOrDefault(boost::string_view name,
     const std::vector<std::string>& defaultValue) const noexcept
 {
-    std::map<std::string, Value>::const_iterator it = m_options.find(name);
-    if (it != m_options.end())
+    const_iterator it = find(name);
+    if ((it != options().end()) && (it->second.type() == Value::Type::string_array))
     {
         return it->second.asStringArray();
     }
@@ -112,11 +701,11 @@ const std::vector<std::string>& Configuration::valueOrDefault(const std::string&
     }
 }
 
-const Configuration& Configuration::valueOrDefault(const std::string& name,
+const Configuration& Configuration::valueOrDefault(boost::string_view name,
     const Configuration& defaultValue) const noexcept
 {
-    std::map<std::string, Value>::const_iterator it = m_options.find(name);
-    if (it != m_options.end())
+    const_iterator it = find(name);
+    if ((it != options().end()) && (it->second.type() == Value::Type::configuration))
     {
         return it->second.asConfiguration();
     }
@@ -126,10 +715,68 @@ const Configuration& Configuration::valueOrDefault(const std::string& name,
     }
 }
 
-const Configuration::Value* Configuration::valueOrNull(const std::string& name) const noexcept
+const Configuration::Value* Configuration::valueOrNull(boost::string_view name) const noexcept
+{
+    const_iterator it = find(name);
+    if (it != options().end())
+    {
+        return &it->second;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+const Configuration::Value& Configuration::value(const Key& key) const
+{
+    const_iterator it = find(key);
+    if (it == options().end())
+    {
+        throw std::out_of_range("Configuration::value: option not found");
+    }
+    return it->second;
+}
+
+Configuration::Value& Configuration::value(const Key& key)
+{
+    const_iterator it = find(key);
+    if (it == options().end())
+    {
+        throw std::out_of_range("Configuration::value: option not found");
+    }
+    return mutableValue(it);
+}
+
+const char* Configuration::valueOrDefault(const Key& key, const char* default_value) const noexcept
+{
+    const Value* result = valueOrNull(key);
+    return ((result && (result->type() == Value::Type::string)) ? result->asString().c_str() : default_value);
+}
+
+const std::string& Configuration::valueOrDefault(const Key& key, const std::string& defaultValue) const noexcept
+{
+    const Value* result = valueOrNull(key);
+    return ((result && (result->type() == Value::Type::string)) ? result->asString() : defaultValue);
+}
+
+const std::vector<std::string>& Configuration::valueOrDefault(const Key& key,
+    const std::vector<std::string>& defaultValue) const noexcept
+{
+    const Value* result = valueOrNull(key);
+    return ((result && (result->type() == Value::Type::string_array)) ? result->asStringArray() : defaultValue);
+}
+
+const Configuration& Configuration::valueOrDefault(const Key& key, const Configuration& defaultValue) const noexcept
+{
+    const Value* result = valueOrNull(key);
+    return ((result && (result->type() == Value::Type::configuration)) ? result->asConfiguration() : defaultValue);
+}
+
+const Configuration::Value* Configuration::valueOrNull(const Key& key) const noexcept
 {
-    std::map<std::string, Value>::const_iterator it = m_options.find(name);
-    if (it != m_options.end())
+    const_iterator it = find(key);
+    if (it != options().end())
     {
         return &it->second;
     }
@@ -139,22 +786,328 @@ const Configuration::Value* Configuration::valueOrNull(const std::string& name)
     }
 }
 
-void Configuration::set(const std::string& name, const std::string& value)
+const Configuration::Value& Configuration::value(const Path& path) const
+{
+    const Value* result = valueOrNull(path);
+    if (!result)
+    {
+        throw std::out_of_range("Configuration::value: option not found");
+    }
+    return *result;
+}
+
+Configuration::Value& Configuration::value(const Path& path)
 {
-    m_options[name] = Value(value);
+    if (path.size() == 0)
+    {
+        throw std::out_of_range("Configuration::value: option not found");
+    }
+
+    // Each configuration on the path is detached from the configurations it shares its options with
+    Configuration* current = this;
+    for (size_t i = 0; (i + 1) < path.size(); ++i)
+    {
+        Value& value = current->value(path[i]);
+        if (value.type() != Value::Type::configuration)
+        {
+            throw std::out_of_range("Configuration::value: option not found");
+        }
+        current = &value.asConfiguration();
+    }
+    return current->value(path[path.size() - 1]);
 }
 
-void Configuration::set(const std::string& name, const std::vector<std::string>& value)
+const char* Configuration::valueOrDefault(const Path& path, const char* default_value) const noexcept
 {
-    m_options[name] = Value(value);
+    const Value* result = valueOrNull(path);
+    return ((result && (result->type() == Value::Type::string)) ? result->asString().c_str() : default_value);
+}
+
+const std::string& Configuration::valueOrDefault(const Path& path, const std::string& defaultValue) const noexcept
+{
+    const Value* result = valueOrNull(path);
+    return ((result && (result->type() == Value::Type::string)) ? result->asString() : defaultValue);
+}
+
+const std::vector<std::string>& Configuration::valueOrDefault(const Path& path,
+    const std::vector<std::string>& defaultValue) const noexcept
+{
+    const Value* result = valueOrNull(path);
+    return ((result && (result->type() == Value::Type::string_array)) ? result->asStringArray() : defaultValue);
+}
+
+const Configuration& Configuration::valueOrDefault(const Path& path, const Configuration& defaultValue) const noexcept
+{
+    const Value* result = valueOrNull(path);
+    return ((result && (result->type() == Value::Type::configuration)) ? result->asConfiguration() : defaultValue);
+}
+
+const Configuration::Value* Configuration::valueOrNull(const Path& path) const noexcept
+{
+    const Configuration* current = this;
+    const Value* result = nullptr;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        if (result)
+        {
+            if (result->type() != Value::Type::configuration)
+            {
+                return nullptr;
+            }
+            current = &result->asConfiguration();
+        }
+        result = current->valueOrNull(path[i]);
+        if (!result)
+        {
+            return nullptr;
+        }
+    }
+    return result;
+}
+
+// The set overloads, including the ones that take a path, build the new value before inserting the option since the
+// argument may be a reference to one of our own options, which inserting would move.
+void Configuration::set(boost::string_view name, const std::string& value)
+{
+    const_iterator it = find(name);
+    if ((it != options().end()) && (it->second.type() == Value::Type::string))
+    {
+        // Assigning to the existing string reuses its buffer
+        boost::get<std::string>(mutableValue(it)) = value;
+    }
+    else
+    {
+        Value new_value(value);
+        findOrInsert(name) = std::move(new_value);
+    }
 }
 
-void Configuration::set(const std::string& name, const Configuration& value)
+void Configuration::set(boost::string_view name, const std::vector<std::string>& value)
 {
-    m_options[name] = Value(value);
+    Value new_value(value);
+    findOrInsert(name) = std::move(new_value);
 }
 
-void Configuration::set(const std::string& name, const Value& value)
+void Configuration::set(boost::string_view name, const Configuration& value)
 {
-    m_options[name] = value;
+    Value new_value(value);
+    findOrInsert(name) = std::move(new_value);
+}
+
+void Configuration::set(boost::string_view name, const Value& value)
+{
+    Value new_value(value);
+    findOrInsert(name) = std::move(new_value);
+}
+
+void Configuration::set(boost::string_view name, std::string&& value)
+{
+    Value new_value(std::move(value));
+    findOrInsert(name) = std::move(new_value);
+}
+
+void Configuration::set(boost::string_view name, std::vector<std::string>&& value)
+{
+    Value new_value(std::move(value));
+    findOrInsert(name) = std::move(new_value);
+}
+
+void Configuration::set(boost::string_view name, Configuration&& value)
+{
+    Value new_value(std::move(value));
+    findOrInsert(name) = std::move(new_value);
+}
+
+void Configuration::set(boost::string_view name, Value&& value)
+{
+    Value new_value(std::move(value));
+    findOrInsert(name) = std::move(new_value);
+}
+
+void Configuration::set(const Path& path, const std::string& value)
+{
+    Value new_value(value);
+    findOrInsertParent(path).findOrInsert(path[path.size() - 1].name()) = std::move(new_value);
+}
+
+void Configuration::set(const Path& path, const std::vector<std::string>& value)
+{
+    Value new_value(value);
+    findOrInsertParent(path).findOrInsert(path[path.size() - 1].name()) = std::move(new_value);
+}
+
+void Configuration::set(const Path& path, const Configuration& value)
+{
+    Value new_value(value);
+    findOrInsertParent(path).findOrInsert(path[path.size() - 1].name()) = std::move(new_value);
+}
+
+void Configuration::set(const Path& path, const Value& value)
+{
+    Value new_value(value);
+    findOrInsertParent(path).findOrInsert(path[path.size() - 1].name()) = std::move(new_value);
+}
+
+Configuration::const_iterator Configuration::find(boost::string_view name) const noexcept
+{
+    const_iterator it = std::lower_bound(options().begin(), options().end(), name,
+        [](const Entry& entry, boost::string_view name)
+        {
+            return (boost::string_view(entry.first) < name);
+        });
+    if ((it != options().end()) && (it->first == name))
+    {
+        return it;
+    }
+    else
+    {
+        return options().end();
+    }
+}
+
+Configuration::const_iterator Configuration::find(const Key& key) const noexcept
+{
+    uint64_t cache = key.m_cache.load(std::memory_order_relaxed);
+    size_t index = static_cast<size_t>(cache & KeyIndexMask);
+    // The bounds check protects against a moved-from configuration that kept its layout
+    if (((cache >> KeyIndexBits) == m_layout) && (index < options().size()))
+    {
+        return (options().begin() + index);
+    }
+
+    const_iterator result = find(key.m_name);
+    index = static_cast<size_t>(result - options().begin());
+    if ((result != options().end()) && (index <= KeyIndexMask))
+    {
+        key.m_cache.store(((m_layout << KeyIndexBits) | index), std::memory_order_relaxed);
+    }
+    return result;
+}
+
+Configuration::Value& Configuration::findOrInsert(boost::string_view name)
+{
+    Options& options = mutableOptions();
+
+    // Fast path for options set in name order, for instance when copying from another configuration
+    if (options.empty() || (boost::string_view(options.back().first) < name))
+    {
+        options.emplace_back(std::string(name.data(), name.size()), Value());
+        m_layout = NewLayout();
+        return options.back().second;
+    }
+
+    Options::iterator it = std::lower_bound(options.begin(), options.end(), name,
+        [](const Entry& entry, boost::string_view name)
+        {
+            return (boost::string_view(entry.first) < name);
+        });
+    if ((it == options.end()) || (it->first != name))
+    {
+        it = options.emplace(it, std::string(name.data(), name.size()), Value());
+        m_layout = NewLayout();
+    }
+    return it->second;
+}
+
+Configuration::Value& Configuration::mutableValue(const_iterator it)
+{
+    size_t index = static_cast<size_t>(it - options().begin());
+    return mutableOptions()[index].second;
+}
+
+const Configuration::Options& Configuration::options() const noexcept
+{
+    static const Options empty_options;
+    return (m_options ? *m_options : empty_options);
+}
+
+Configuration::Options& Configuration::mutableOptions()
+{
+    // The shared_ptr control block is allocated together with the vector, from the arena if there is one
+    ConfigurationArena::Allocator<Options> allocator(m_arena);
+    if (!m_options)
+    {
+        m_options = std::allocate_shared<Options>(allocator, allocator);
+    }
+    else if (m_options.use_count() > 1)
+    {
+        // Only this level is copied, the nested configurations in the copy still share their options
+        m_options = std::allocate_shared<Options>(allocator, m_options->begin(), m_options->end(), allocator);
+    }
+    else
+    {
+        // use_count() is a relaxed load. The last copy may just have been destroyed on another thread, after reading
+        // the options, so this orders our writes after its reads.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *m_options;
+}
+
+void Configuration::set(const Path& path, Value&& value)
+{
+    Value new_value(std::move(value));
+    findOrInsertParent(path).findOrInsert(path[path.size() - 1].name()) = std::move(new_value);
+}
+
+bool Configuration::erase(boost::string_view name)
+{
+    const_iterator it = find(name);
+    if (it == options().end())
+    {
+        return false;
+    }
+
+    size_t index = static_cast<size_t>(it - options().begin());
+    Options& options = mutableOptions();
+    options.erase(options.begin() + index);
+    // The options after the erased one have moved so the keys that cached their positions must not match anymore
+    m_layout = NewLayout();
+    return true;
+}
+
+bool Configuration::erase(const Path& path)
+{
+    // Checked first so that nothing is modified, and the options are not duplicated, if there is nothing to erase
+    if ((path.size() == 0) || !valueOrNull(path))
+    {
+        return false;
+    }
+
+    Configuration* parent = this;
+    for (size_t i = 0; (i + 1) < path.size(); ++i)
+    {
+        parent = &parent->value(path[i]).asConfiguration();
+    }
+    return parent->erase(path[path.size() - 1].name());
+}
+
+Configuration& Configuration::findOrInsertParent(const Path& path)
+{
+    if (path.size() == 0)
+    {
+        throw std::invalid_argument("Configuration::set: empty path");
+    }
+
+    Configuration* result = this;
+    for (size_t i = 0; (i + 1) < path.size(); ++i)
+    {
+        const Value* existing_value = result->valueOrNull(path[i]);
+        Value* value = nullptr;
+        if (!existing_value)
+        {
+            value = &result->findOrInsert(path[i].name());
+            *value = Value(Configuration(result->m_arena));
+        }
+        else if (existing_value->type() == Value::Type::configuration)
+        {
+            // Makes sure the options are not shared with another configuration before modifying them
+            value = &result->value(path[i]);
+        }
+        else
+        {
+            throw std::invalid_argument("Configuration::set: " + path[i].name() + " is not a configuration");
+        }
+        result = &value->asConfiguration();
+    }
+    return *result;
 }
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationArena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+using namespace Ishiko;
+
+namespace
+{
+
+char* AlignUp(char* p, size_t alignment) noexcept
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(p);
+    return reinterpret_cast<char*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+}
+
+ConfigurationArena::ConfigurationArena(size_t block_size)
+    : m_blocks(nullptr), m_current(nullptr), m_end(nullptr), m_block_size(block_size), m_size(0), m_capacity(0)
+{
+}
+
+ConfigurationArena::~ConfigurationArena()
+{
+    while (m_blocks)
+    {
+        Block* previous = m_blocks->previous;
+        ::operator delete(m_blocks);
+        m_blocks = previous;
+    }
+}
+
+void* ConfigurationArena::allocate(size_t size, size_t alignment)
+{
+    char* result = AlignUp(m_current, alignment);
+    if (!m_current || (result > m_end) || (size_t(m_end - result) < size))
+    {
+        return allocateFromNewBlock(size, alignment);
+    }
+    m_current = result + size;
+    m_size += size;
+    return result;
+}
+
+void ConfigurationArena::release() noexcept
+{
+    Block* largest = m_blocks;
+    for (Block* block = m_blocks; block; block = block->previous)
+    {
+        if (block->size > largest->size)
+        {
+            largest = block;
+        }
+    }
+
+    while (m_blocks)
+    {
+        Block* previous = m_blocks->previous;
+        if (m_blocks != largest)
+        {
+            ::operator delete(m_blocks);
+        }
+        m_blocks = previous;
+    }
+
+    m_size = 0;
+    if (largest)
+    {
+        largest->previous = nullptr;
+        m_blocks = largest;
+        m_current = reinterpret_cast<char*>(largest + 1);
+        m_end = reinterpret_cast<char*>(largest) + largest->size;
+        m_capacity = largest->size;
+    }
+    else
+    {
+        m_current = nullptr;
+        m_end = nullptr;
+        m_capacity = 0;
+    }
+}
+
+size_t ConfigurationArena::size() const noexcept
+{
+    return m_size;
+}
+
+size_t ConfigurationArena::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+void* ConfigurationArena::allocateFromNewBlock(size_t size, size_t alignment)
+{
+    // Blocks double in size so the number of heap allocations is logarithmic in the total size
+    size_t block_size = std::max(m_block_size, sizeof(Block) + alignment + size);
+    m_block_size = (2 * block_size);
+
+    Block* block = static_cast<Block*>(::operator new(block_size));
+    block->previous = m_blocks;
+    block->size = block_size;
+    m_blocks = block;
+    m_capacity += block_size;
+
+    char* result = AlignUp(reinterpret_cast<char*>(block + 1), alignment);
+    m_current = result + size;
+    m_end = reinterpret_cast<char*>(block) + block_size;
+    m_size += size;
+    return result;
+}
@@ -0,0 +1,386 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationFileWatcher.hpp"
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/types.h>
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace Ishiko;
+
+namespace
+{
+
+// The directory and the name of the file, the directory is "." if the path doesn't have one
+void SplitFilePath(const std::string& file_path, std::string& directory, std::string& file_name)
+{
+    size_t pos = file_path.find_last_of("/\\");
+    if (pos == std::string::npos)
+    {
+        directory = ".";
+        file_name = file_path;
+    }
+    else
+    {
+        directory = file_path.substr(0, (pos == 0) ? 1 : pos);
+        file_name = file_path.substr(pos + 1);
+    }
+}
+
+// Closes the file descriptor on destruction unless it was released
+class InotifyDescriptorGuard
+{
+public:
+    explicit InotifyDescriptorGuard(int fd) noexcept
+        : m_fd(fd)
+    {
+    }
+
+    InotifyDescriptorGuard(const InotifyDescriptorGuard& other) = delete;
+    InotifyDescriptorGuard& operator=(const InotifyDescriptorGuard& other) = delete;
+
+    ~InotifyDescriptorGuard()
+    {
+#if defined(__linux__)
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+        }
+#endif
+    }
+
+    void release() noexcept
+    {
+        m_fd = -1;
+    }
+
+private:
+    int m_fd;
+};
+
+}
+
+bool ConfigurationFileWatcher::FileStamp::operator==(const FileStamp& other) const noexcept
+{
+    return ((exists == other.exists) && (device == other.device) && (inode == other.inode) && (size == other.size)
+        && (modification_time == other.modification_time));
+}
+
+bool ConfigurationFileWatcher::FileStamp::operator!=(const FileStamp& other) const noexcept
+{
+    return !(*this == other);
+}
+
+ConfigurationFileWatcher::ConfigurationFileWatcher(ConfigurationStore& store, std::chrono::milliseconds debounce_delay)
+    : m_store(store), m_debounce_delay(debounce_delay), m_configuration(*store.read()), m_stop(false)
+{
+}
+
+ConfigurationFileWatcher::~ConfigurationFileWatcher()
+{
+    stop();
+}
+
+void ConfigurationFileWatcher::addFile(const std::string& file_path, const Configuration::Path& path, Loader loader)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileStamp stamp = {false, 0, 0, 0, 0};
+    m_files.push_back({file_path, path, std::move(loader), stamp, true});
+}
+
+void ConfigurationFileWatcher::setErrorHandler(ErrorHandler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_error_handler = std::move(handler);
+}
+
+void ConfigurationFileWatcher::setReloadHandler(ReloadHandler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_reload_handler = std::move(handler);
+}
+
+void ConfigurationFileWatcher::start()
+{
+    if (m_thread.joinable())
+    {
+        return;
+    }
+
+    // The directories are watched before the files are loaded, a change made in between would be missed otherwise
+    int inotify_fd = -1;
+    std::map<int, std::string> directories;
+    bool inotify = addInotifyWatches(inotify_fd, directories);
+    // Closes the inotify descriptor if the initial load or starting the thread throws, the thread owns it afterwards
+    InotifyDescriptorGuard inotify_fd_guard(inotify_fd);
+
+    reload();
+
+    m_stop = false;
+    m_thread = std::thread(
+        [this, inotify, inotify_fd, directories]()
+        {
+            if (inotify)
+            {
+                watchWithInotify(inotify_fd, directories);
+            }
+            else
+            {
+                watchWithPolling();
+            }
+        });
+    inotify_fd_guard.release();
+}
+
+void ConfigurationFileWatcher::stop()
+{
+    m_stop = true;
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+size_t ConfigurationFileWatcher::reload()
+{
+    // Taken before m_mutex and kept while publishing so that snapshots are published, and the handlers called, in the
+    // order they were built. It is recursive so that a handler can call reload.
+    std::lock_guard<std::recursive_mutex> publish_lock(m_publish_mutex);
+
+    size_t result = 0;
+    std::vector<std::pair<std::string, std::exception_ptr>> errors;
+    Configuration configuration;
+    ErrorHandler error_handler;
+    ReloadHandler reload_handler;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (WatchedFile& file : m_files)
+        {
+            FileStamp stamp = GetFileStamp(file.file_path);
+            if (!file.changed && (stamp == file.stamp))
+            {
+                continue;
+            }
+            file.changed = false;
+            file.stamp = stamp;
+            if (!stamp.exists)
+            {
+                // The file may be in the middle of being replaced, the previous configuration is kept until it is
+                // back
+                continue;
+            }
+
+            try
+            {
+                // The other subtrees keep sharing their options with the previous snapshot
+                m_configuration.set(file.path, Configuration::Value(file.loader(file.file_path)));
+                ++result;
+            }
+            catch (...)
+            {
+                errors.emplace_back(file.file_path, std::current_exception());
+            }
+        }
+
+        // The handlers are called without the lock held so that they can call back into the watcher
+        if (result != 0)
+        {
+            configuration = m_configuration;
+        }
+        error_handler = m_error_handler;
+        reload_handler = m_reload_handler;
+    }
+
+    if (error_handler)
+    {
+        for (const std::pair<std::string, std::exception_ptr>& error : errors)
+        {
+            error_handler(error.first, error.second);
+        }
+    }
+
+    if (result != 0)
+    {
+        m_store.publish(configuration);
+        if (reload_handler)
+        {
+            reload_handler(configuration);
+        }
+    }
+    return result;
+}
+
+ConfigurationFileWatcher::FileStamp ConfigurationFileWatcher::GetFileStamp(const std::string& file_path)
+{
+    FileStamp result = {false, 0, 0, 0, 0};
+    struct stat status;
+    if (stat(file_path.c_str(), &status) == 0)
+    {
+        result.exists = true;
+        result.device = status.st_dev;
+        result.inode = status.st_ino;
+        result.size = status.st_size;
+#if defined(__linux__)
+        result.modification_time = ((int64_t(status.st_mtim.tv_sec) * 1000000000) + status.st_mtim.tv_nsec);
+#else
+        result.modification_time = status.st_mtime;
+#endif
+    }
+    return result;
+}
+
+bool ConfigurationFileWatcher::addInotifyWatches(int& fd, std::map<int, std::string>& directories)
+{
+#if defined(__linux__)
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Editors often replace the file rather than write to it so the directories are watched instead of the files
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const WatchedFile& file : m_files)
+    {
+        std::string directory;
+        std::string file_name;
+        SplitFilePath(file.file_path, directory, file_name);
+        int wd = inotify_add_watch(fd, directory.c_str(),
+            IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_ATTRIB);
+        if (wd < 0)
+        {
+            close(fd);
+            fd = -1;
+            directories.clear();
+            return false;
+        }
+        directories[wd] = directory;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)directories;
+    return false;
+#endif
+}
+
+void ConfigurationFileWatcher::watchWithInotify(int fd, const std::map<int, std::string>& directories)
+{
+#if defined(__linux__)
+    bool pending = false;
+    std::chrono::steady_clock::time_point deadline;
+    alignas(struct inotify_event) char buffer[4096];
+    while (!m_stop)
+    {
+        // Wakes up regularly to check whether we have been asked to stop
+        std::chrono::milliseconds timeout(100);
+        if (pending)
+        {
+            timeout = std::min(timeout, std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()));
+            timeout = std::max(timeout, std::chrono::milliseconds(0));
+        }
+
+        struct pollfd poll_fd = {fd, POLLIN, 0};
+        int ready = poll(&poll_fd, 1, static_cast<int>(timeout.count()));
+        if (ready > 0)
+        {
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+            {
+                for (char* p = buffer; p < (buffer + length);)
+                {
+                    const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+                    if (event->len > 0)
+                    {
+                        std::map<int, std::string>::const_iterator directory = directories.find(event->wd);
+                        if (directory != directories.end())
+                        {
+                            markChanged(directory->second, event->name);
+                        }
+                    }
+                    p += (sizeof(struct inotify_event) + event->len);
+                }
+            }
+            // Every new event pushes the reload back, until the writes settle
+            pending = true;
+            deadline = (std::chrono::steady_clock::now() + m_debounce_delay);
+        }
+        else if (pending && (std::chrono::steady_clock::now() >= deadline))
+        {
+            pending = false;
+            reload();
+        }
+    }
+
+    close(fd);
+#else
+    // Never called since addInotifyWatches fails
+    (void)fd;
+    (void)directories;
+#endif
+}
+
+void ConfigurationFileWatcher::watchWithPolling()
+{
+    std::vector<FileStamp> last_stamps;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const WatchedFile& file : m_files)
+        {
+            last_stamps.push_back(file.stamp);
+        }
+    }
+
+    // A file is only reloaded once its stamp is the same at two consecutive checks, a debounce delay apart
+    bool pending = false;
+    while (!m_stop)
+    {
+        std::chrono::steady_clock::time_point wake_up = (std::chrono::steady_clock::now() + m_debounce_delay);
+        while (!m_stop && (std::chrono::steady_clock::now() < wake_up))
+        {
+            std::this_thread::sleep_for(std::min(std::chrono::milliseconds(100), m_debounce_delay));
+        }
+
+        bool changed = false;
+        for (size_t i = 0; i < last_stamps.size(); ++i)
+        {
+            FileStamp stamp = GetFileStamp(m_files[i].file_path);
+            if (stamp != last_stamps[i])
+            {
+                last_stamps[i] = stamp;
+                changed = true;
+            }
+        }
+        if (changed)
+        {
+            pending = true;
+        }
+        else if (pending)
+        {
+            pending = false;
+            reload();
+        }
+    }
+}
+
+void ConfigurationFileWatcher::markChanged(const std::string& directory, const std::string& file_name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (WatchedFile& file : m_files)
+    {
+        std::string file_directory;
+        std::string name;
+        SplitFilePath(file.file_path, file_directory, name);
+        if ((file_directory == directory) && (name == file_name))
+        {
+            file.changed = true;
+        }
+    }
+}
@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationParseError.hpp"
+#include <algorithm>
+
+using namespace Ishiko;
+
+ConfigurationParseError::ConfigurationParseError(const std::string& message, size_t line, size_t column)
+    : std::runtime_error("line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message),
+    m_line(line), m_column(column)
+{
+}
+
+ConfigurationParseError ConfigurationParseError::AtOffset(const std::string& message, boost::string_view text,
+    size_t offset)
+{
+    offset = std::min(offset, text.size());
+    size_t line = (1 + std::count(text.begin(), text.begin() + offset, '\n'));
+    size_t line_start = text.substr(0, offset).rfind('\n');
+    size_t column = ((line_start == boost::string_view::npos) ? (offset + 1) : (offset - line_start));
+    return ConfigurationParseError(message, line, column);
+}
+
+size_t ConfigurationParseError::line() const noexcept
+{
+    return m_line;
+}
+
+size_t ConfigurationParseError::column() const noexcept
+{
+    return m_column;
+}
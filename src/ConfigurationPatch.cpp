@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationPatch.hpp"
+
+using namespace Ishiko;
+
+namespace
+{
+
+// Nested configurations are not compared here, the caller recurses into them
+bool EqualValues(const Configuration::Value& lhs, const Configuration::Value& rhs)
+{
+    if (lhs.type() != rhs.type())
+    {
+        return false;
+    }
+
+    switch (lhs.type())
+    {
+    case Configuration::Value::Type::string:
+        return (lhs.asString() == rhs.asString());
+
+    case Configuration::Value::Type::string_array:
+        return (lhs.asStringArray() == rhs.asStringArray());
+
+    case Configuration::Value::Type::integer:
+        return (lhs.asInt() == rhs.asInt());
+
+    case Configuration::Value::Type::floating_point:
+        return (lhs.asDouble() == rhs.asDouble());
+
+    case Configuration::Value::Type::boolean:
+        return (lhs.asBool() == rhs.asBool());
+
+    case Configuration::Value::Type::duration:
+        return (lhs.asDuration() == rhs.asDuration());
+
+    case Configuration::Value::Type::size:
+        return (lhs.asSize() == rhs.asSize());
+
+    default:
+        return false;
+    }
+}
+
+}
+
+ConfigurationPatch::ConfigurationPatch() noexcept
+{
+}
+
+ConfigurationPatch ConfigurationPatch::Diff(const Configuration& from, const Configuration& to)
+{
+    ConfigurationPatch result;
+    std::vector<std::string> path;
+    result.diff(from, to, path);
+    return result;
+}
+
+bool ConfigurationPatch::empty() const noexcept
+{
+    return m_changes.empty();
+}
+
+const std::vector<ConfigurationPatch::Change>& ConfigurationPatch::changes() const noexcept
+{
+    return m_changes;
+}
+
+void ConfigurationPatch::apply(Configuration& configuration) const
+{
+    for (const Change& change : m_changes)
+    {
+        Configuration::Path path(change.path);
+        if (change.type == Change::Type::removed)
+        {
+            configuration.erase(path);
+        }
+        else
+        {
+            configuration.set(path, change.value);
+        }
+    }
+}
+
+void ConfigurationPatch::diff(const Configuration& from, const Configuration& to, std::vector<std::string>& path)
+{
+    if (from.isSharedWith(to))
+    {
+        return;
+    }
+
+    // The options are sorted by name so this is a merge join
+    Configuration::const_iterator from_it = from.begin();
+    Configuration::const_iterator to_it = to.begin();
+    while ((from_it != from.end()) || (to_it != to.end()))
+    {
+        if ((to_it == to.end()) || ((from_it != from.end()) && (from_it->first < to_it->first)))
+        {
+            addChange(Change::Type::removed, path, from_it->first, Configuration::Value());
+            ++from_it;
+        }
+        else if ((from_it == from.end()) || (to_it->first < from_it->first))
+        {
+            addChange(Change::Type::added, path, to_it->first, to_it->second);
+            ++to_it;
+        }
+        else
+        {
+            const Configuration::Value& from_value = from_it->second;
+            const Configuration::Value& to_value = to_it->second;
+            if ((from_value.type() == Configuration::Value::Type::configuration)
+                && (to_value.type() == Configuration::Value::Type::configuration))
+            {
+                path.push_back(from_it->first);
+                diff(from_value.asConfiguration(), to_value.asConfiguration(), path);
+                path.pop_back();
+            }
+            else if (!EqualValues(from_value, to_value))
+            {
+                addChange(Change::Type::modified, path, to_it->first, to_value);
+            }
+            ++from_it;
+            ++to_it;
+        }
+    }
+}
+
+void ConfigurationPatch::addChange(Change::Type type, const std::vector<std::string>& path, const std::string& name,
+    const Configuration::Value& value)
+{
+    m_changes.push_back({type, path, value});
+    m_changes.back().path.push_back(name);
+}
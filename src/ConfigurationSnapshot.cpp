@@ -0,0 +1,565 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationSnapshot.hpp"
+#include <boost/variant/get.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace Ishiko;
+
+namespace
+{
+
+const char Magic[8] = { 'I', 'S', 'H', 'K', 'C', 'F', 'G', 'S' };
+const uint32_t Version = 1;
+// Written in the byte order of the machine, a snapshot read on a machine with another byte order doesn't match it
+const uint32_t ByteOrderMark = 0x01020304;
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order_mark;
+    uint64_t size;
+    // The offsets of the root table and of the string table
+    uint64_t root;
+    uint64_t strings;
+};
+
+template<typename T>
+T Load(const char* p) noexcept
+{
+    T result;
+    std::memcpy(&result, p, sizeof(T));
+    return result;
+}
+
+template<typename T>
+void Store(std::string& output, size_t offset, const T& value) noexcept
+{
+    std::memcpy(&output[offset], &value, sizeof(T));
+}
+
+}
+
+// A table is its number of options followed by the references to their names and by their slots. All of them are
+// multiples of 8 bytes so everything in the file stays aligned.
+class ConfigurationSnapshot::Writer
+{
+public:
+    std::string write(const Configuration& configuration)
+    {
+        m_output.assign(sizeof(Header), '\0');
+        uint64_t root = writeTable(configuration);
+
+        Header header;
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.byte_order_mark = ByteOrderMark;
+        header.strings = m_output.size();
+        header.root = root;
+        m_output.append(m_strings);
+        header.size = m_output.size();
+        Store(m_output, 0, header);
+        return std::move(m_output);
+    }
+
+private:
+    uint64_t writeTable(const Configuration& configuration)
+    {
+        size_t offset = m_output.size();
+        uint64_t count = configuration.size();
+        m_output.append(sizeof(uint64_t) + (count * (sizeof(StringReference) + sizeof(Slot))), '\0');
+        Store(m_output, offset, count);
+
+        // The names of a table are not shared with other strings so that they are next to each other and a binary
+        // search only touches a few pages
+        size_t name_offset = (offset + sizeof(uint64_t));
+        for (const Configuration::Entry& entry : configuration)
+        {
+            Store(m_output, name_offset, addString(entry.first));
+            name_offset += sizeof(StringReference);
+        }
+
+        // Writing a nested table appends to the output so the slots are written one at a time once they are ready
+        size_t slot_offset = name_offset;
+        for (const Configuration::Entry& entry : configuration)
+        {
+            Slot slot = createSlot(entry.second);
+            Store(m_output, slot_offset, slot);
+            slot_offset += sizeof(Slot);
+        }
+
+        return offset;
+    }
+
+    Slot createSlot(const Configuration::Value& value)
+    {
+        Slot result;
+        result.type = static_cast<uint32_t>(value.type());
+        result.length = 0;
+        result.data = 0;
+        switch (value.type())
+        {
+        case Configuration::Value::Type::string:
+            {
+                StringReference reference = addSharedString(value.asString());
+                result.length = reference.length;
+                result.data = reference.offset;
+            }
+            break;
+
+        case Configuration::Value::Type::string_array:
+            {
+                const std::vector<std::string>& strings = value.asStringArray();
+                checkLength(strings.size());
+                size_t offset = m_output.size();
+                m_output.append(strings.size() * sizeof(StringReference), '\0');
+                for (size_t i = 0; i < strings.size(); ++i)
+                {
+                    Store(m_output, offset + (i * sizeof(StringReference)), addSharedString(strings[i]));
+                }
+                result.length = static_cast<uint32_t>(strings.size());
+                result.data = offset;
+            }
+            break;
+
+        case Configuration::Value::Type::configuration:
+            result.data = writeTable(value.asConfiguration());
+            break;
+
+        case Configuration::Value::Type::integer:
+            {
+                int64_t integer = value.asInt();
+                std::memcpy(&result.data, &integer, sizeof(integer));
+            }
+            break;
+
+        case Configuration::Value::Type::floating_point:
+            {
+                double floating_point = value.asDouble();
+                std::memcpy(&result.data, &floating_point, sizeof(floating_point));
+            }
+            break;
+
+        case Configuration::Value::Type::boolean:
+            result.data = (value.asBool() ? 1 : 0);
+            break;
+
+        case Configuration::Value::Type::duration:
+            {
+                int64_t nanoseconds = value.asDuration().count();
+                std::memcpy(&result.data, &nanoseconds, sizeof(nanoseconds));
+            }
+            break;
+
+        case Configuration::Value::Type::size:
+            result.data = value.asSize();
+            break;
+        }
+        return result;
+    }
+
+    StringReference addString(boost::string_view text)
+    {
+        checkLength(m_strings.size() + text.size() + 1);
+        StringReference result;
+        result.offset = static_cast<uint32_t>(m_strings.size());
+        result.length = static_cast<uint32_t>(text.size());
+        m_strings.append(text.data(), text.size());
+        m_strings.push_back('\0');
+        return result;
+    }
+
+    // The string values are stored once however many options have them
+    StringReference addSharedString(const std::string& text)
+    {
+        std::unordered_map<std::string, StringReference>::const_iterator it = m_shared_strings.find(text);
+        if (it != m_shared_strings.end())
+        {
+            return it->second;
+        }
+        StringReference result = addString(text);
+        m_shared_strings.emplace(text, result);
+        return result;
+    }
+
+    static void checkLength(size_t length)
+    {
+        if (length > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::length_error("ConfigurationSnapshot::Compile: the configuration is too large");
+        }
+    }
+
+    std::string m_output;
+    std::string m_strings;
+    std::unordered_map<std::string, StringReference> m_shared_strings;
+};
+
+size_t ConfigurationSnapshot::StringArray::size() const noexcept
+{
+    return m_size;
+}
+
+boost::string_view ConfigurationSnapshot::StringArray::operator[](size_t index) const noexcept
+{
+    return boost::string_view(m_strings + m_items[index].offset, m_items[index].length);
+}
+
+std::vector<std::string> ConfigurationSnapshot::StringArray::toVector() const
+{
+    std::vector<std::string> result;
+    result.reserve(m_size);
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        result.emplace_back(m_strings + m_items[i].offset, m_items[i].length);
+    }
+    return result;
+}
+
+ConfigurationSnapshot::StringArray::StringArray(const char* strings, const StringReference* items,
+    size_t size) noexcept
+    : m_strings(strings), m_items(items), m_size(size)
+{
+}
+
+ConfigurationSnapshot::Value::Value() noexcept
+    : m_data(nullptr), m_strings(nullptr), m_slot(nullptr)
+{
+}
+
+ConfigurationSnapshot::Value::Value(const char* data, const char* strings, const Slot* slot) noexcept
+    : m_data(data), m_strings(strings), m_slot(slot)
+{
+}
+
+ConfigurationSnapshot::Value::operator bool() const noexcept
+{
+    return (m_slot != nullptr);
+}
+
+Configuration::Value::Type ConfigurationSnapshot::Value::type() const
+{
+    if (!m_slot)
+    {
+        throw boost::bad_get();
+    }
+    return static_cast<Configuration::Value::Type>(m_slot->type);
+}
+
+boost::string_view ConfigurationSnapshot::Value::asString() const
+{
+    checkType(Configuration::Value::Type::string);
+    return boost::string_view(m_strings + m_slot->data, m_slot->length);
+}
+
+const char* ConfigurationSnapshot::Value::asCString() const
+{
+    checkType(Configuration::Value::Type::string);
+    return (m_strings + m_slot->data);
+}
+
+ConfigurationSnapshot::StringArray ConfigurationSnapshot::Value::asStringArray() const
+{
+    checkType(Configuration::Value::Type::string_array);
+    return StringArray(m_strings, reinterpret_cast<const StringReference*>(m_data + m_slot->data), m_slot->length);
+}
+
+ConfigurationSnapshot::Table ConfigurationSnapshot::Value::asConfiguration() const
+{
+    checkType(Configuration::Value::Type::configuration);
+    return Table(m_data, m_strings, m_data + m_slot->data);
+}
+
+int64_t ConfigurationSnapshot::Value::asInt() const
+{
+    checkType(Configuration::Value::Type::integer);
+    return Load<int64_t>(reinterpret_cast<const char*>(&m_slot->data));
+}
+
+double ConfigurationSnapshot::Value::asDouble() const
+{
+    checkType(Configuration::Value::Type::floating_point);
+    return Load<double>(reinterpret_cast<const char*>(&m_slot->data));
+}
+
+bool ConfigurationSnapshot::Value::asBool() const
+{
+    checkType(Configuration::Value::Type::boolean);
+    return (m_slot->data != 0);
+}
+
+std::chrono::nanoseconds ConfigurationSnapshot::Value::asDuration() const
+{
+    checkType(Configuration::Value::Type::duration);
+    return std::chrono::nanoseconds(Load<int64_t>(reinterpret_cast<const char*>(&m_slot->data)));
+}
+
+uint64_t ConfigurationSnapshot::Value::asSize() const
+{
+    checkType(Configuration::Value::Type::size);
+    return m_slot->data;
+}
+
+Configuration::Value ConfigurationSnapshot::Value::toValue(ConfigurationArena* arena) const
+{
+    switch (type())
+    {
+    case Configuration::Value::Type::string:
+        return Configuration::Value(asString().to_string());
+
+    case Configuration::Value::Type::string_array:
+        return Configuration::Value(asStringArray().toVector());
+
+    case Configuration::Value::Type::configuration:
+        return Configuration::Value(asConfiguration().toConfiguration(arena));
+
+    case Configuration::Value::Type::integer:
+        return Configuration::Value(asInt());
+
+    case Configuration::Value::Type::floating_point:
+        return Configuration::Value(asDouble());
+
+    case Configuration::Value::Type::boolean:
+        return Configuration::Value(asBool());
+
+    case Configuration::Value::Type::duration:
+        return Configuration::Value(asDuration());
+
+    case Configuration::Value::Type::size:
+        return Configuration::Value(asSize());
+    }
+    return Configuration::Value();
+}
+
+void ConfigurationSnapshot::Value::checkType(Configuration::Value::Type type) const
+{
+    if (!m_slot || (m_slot->type != static_cast<uint32_t>(type)))
+    {
+        throw boost::bad_get();
+    }
+}
+
+ConfigurationSnapshot::Table::Table(const char* data, const char* strings, const char* table) noexcept
+    : m_data(data), m_strings(strings), m_table(table)
+{
+}
+
+size_t ConfigurationSnapshot::Table::size() const noexcept
+{
+    return static_cast<size_t>(Load<uint64_t>(m_table));
+}
+
+boost::string_view ConfigurationSnapshot::Table::nameAt(size_t index) const noexcept
+{
+    const StringReference& name = names()[index];
+    return boost::string_view(m_strings + name.offset, name.length);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::Table::valueAt(size_t index) const noexcept
+{
+    return Value(m_data, m_strings, slots() + index);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::Table::value(boost::string_view name) const
+{
+    Value result = valueOrNull(name);
+    if (!result)
+    {
+        throw std::out_of_range("ConfigurationSnapshot::value: option not found");
+    }
+    return result;
+}
+
+const char* ConfigurationSnapshot::Table::valueOrDefault(boost::string_view name,
+    const char* default_value) const noexcept
+{
+    Value result = valueOrNull(name);
+    return ((result && (result.type() == Configuration::Value::Type::string)) ? result.asCString() : default_value);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::Table::valueOrNull(boost::string_view name) const noexcept
+{
+    const StringReference* begin = names();
+    const StringReference* end = (begin + size());
+    const char* strings = m_strings;
+    const StringReference* it = std::lower_bound(begin, end, name,
+        [strings](const StringReference& lhs, boost::string_view rhs)
+        {
+            return (boost::string_view(strings + lhs.offset, lhs.length) < rhs);
+        });
+    if ((it != end) && (boost::string_view(strings + it->offset, it->length) == name))
+    {
+        return Value(m_data, m_strings, slots() + (it - begin));
+    }
+    else
+    {
+        return Value();
+    }
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::Table::value(const Configuration::Path& path) const
+{
+    Value result = valueOrNull(path);
+    if (!result)
+    {
+        throw std::out_of_range("ConfigurationSnapshot::value: option not found");
+    }
+    return result;
+}
+
+const char* ConfigurationSnapshot::Table::valueOrDefault(const Configuration::Path& path,
+    const char* default_value) const noexcept
+{
+    Value result = valueOrNull(path);
+    return ((result && (result.type() == Configuration::Value::Type::string)) ? result.asCString() : default_value);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::Table::valueOrNull(const Configuration::Path& path) const noexcept
+{
+    Value result;
+    Table current = *this;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        result = current.valueOrNull(path[i].name());
+        if (!result || ((i + 1) == path.size()))
+        {
+            break;
+        }
+        if (result.type() != Configuration::Value::Type::configuration)
+        {
+            return Value();
+        }
+        current = result.asConfiguration();
+    }
+    return result;
+}
+
+Configuration ConfigurationSnapshot::Table::toConfiguration(ConfigurationArena* arena) const
+{
+    // The options are already in name order so the builder doesn't need to sort them
+    Configuration::Builder builder(arena);
+    size_t count = size();
+    builder.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        builder.add(nameAt(i).to_string(), valueAt(i).toValue(arena));
+    }
+    return builder.build();
+}
+
+const ConfigurationSnapshot::StringReference* ConfigurationSnapshot::Table::names() const noexcept
+{
+    return reinterpret_cast<const StringReference*>(m_table + sizeof(uint64_t));
+}
+
+const ConfigurationSnapshot::Slot* ConfigurationSnapshot::Table::slots() const noexcept
+{
+    return reinterpret_cast<const Slot*>(m_table + sizeof(uint64_t) + (size() * sizeof(StringReference)));
+}
+
+ConfigurationSnapshot::ConfigurationSnapshot(const std::string& file_path)
+    : m_file(file_path, MemoryMappedFile::Access::random), m_strings(nullptr), m_root(nullptr)
+{
+    if (m_file.size() < sizeof(Header))
+    {
+        throw std::runtime_error("ConfigurationSnapshot: " + file_path + " is not a configuration snapshot");
+    }
+    Header header = Load<Header>(m_file.data());
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+    {
+        throw std::runtime_error("ConfigurationSnapshot: " + file_path + " is not a configuration snapshot");
+    }
+    if ((header.version != Version) || (header.byte_order_mark != ByteOrderMark))
+    {
+        throw std::runtime_error("ConfigurationSnapshot: " + file_path
+            + " was written by another version or on a machine with another byte order");
+    }
+    if ((header.size != m_file.size()) || (header.root < sizeof(Header)) || (header.root >= header.strings)
+        || (header.strings > header.size))
+    {
+        throw std::runtime_error("ConfigurationSnapshot: " + file_path + " is truncated or corrupted");
+    }
+    m_strings = (m_file.data() + header.strings);
+    m_root = (m_file.data() + header.root);
+}
+
+std::string ConfigurationSnapshot::Compile(const Configuration& configuration)
+{
+    Writer writer;
+    return writer.write(configuration);
+}
+
+void ConfigurationSnapshot::Write(const Configuration& configuration, const std::string& file_path)
+{
+    std::string content = Compile(configuration);
+
+    // Truncating the file in place would make the processes that have it mapped crash when they read past its new
+    // end, the new snapshot is written next to it and renamed over it instead
+    std::string temporary_file_path = file_path + ".tmp";
+    std::ofstream file(temporary_file_path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+    file.close();
+    if (!file)
+    {
+        std::remove(temporary_file_path.c_str());
+        throw std::runtime_error("ConfigurationSnapshot::Write: failed to write " + temporary_file_path);
+    }
+
+#if defined(_WIN32)
+    bool renamed = (MoveFileExA(temporary_file_path.c_str(), file_path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+    bool renamed = (std::rename(temporary_file_path.c_str(), file_path.c_str()) == 0);
+#endif
+    if (!renamed)
+    {
+        std::remove(temporary_file_path.c_str());
+        throw std::runtime_error("ConfigurationSnapshot::Write: failed to replace " + file_path);
+    }
+}
+
+ConfigurationSnapshot::Table ConfigurationSnapshot::root() const noexcept
+{
+    return Table(m_file.data(), m_strings, m_root);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::value(boost::string_view name) const
+{
+    return root().value(name);
+}
+
+const char* ConfigurationSnapshot::valueOrDefault(boost::string_view name, const char* default_value) const noexcept
+{
+    return root().valueOrDefault(name, default_value);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::valueOrNull(boost::string_view name) const noexcept
+{
+    return root().valueOrNull(name);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::value(const Configuration::Path& path) const
+{
+    return root().value(path);
+}
+
+const char* ConfigurationSnapshot::valueOrDefault(const Configuration::Path& path,
+    const char* default_value) const noexcept
+{
+    return root().valueOrDefault(path, default_value);
+}
+
+ConfigurationSnapshot::Value ConfigurationSnapshot::valueOrNull(const Configuration::Path& path) const noexcept
+{
+    return root().valueOrNull(path);
+}
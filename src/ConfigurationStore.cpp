@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationStore.hpp"
+#include <thread>
+
+using namespace Ishiko;
+
+namespace
+{
+
+std::atomic<size_t> g_next_stripe(0);
+
+// Threads are assigned stripes round robin the first time they read
+size_t CurrentThreadStripe() noexcept
+{
+    static thread_local size_t stripe = g_next_stripe.fetch_add(1, std::memory_order_relaxed);
+    return stripe;
+}
+
+}
+
+ConfigurationStore::ReadHandle::ReadHandle(ReadHandle&& other) noexcept
+    : m_counter(other.m_counter), m_snapshot(other.m_snapshot)
+{
+    other.m_counter = nullptr;
+}
+
+ConfigurationStore::ReadHandle::~ReadHandle()
+{
+    if (m_counter)
+    {
+        // Makes our reads of the snapshot happen before the writer that sees the counter drop deletes it
+        m_counter->fetch_sub(1, std::memory_order_release);
+    }
+}
+
+const Configuration& ConfigurationStore::ReadHandle::operator*() const noexcept
+{
+    return m_snapshot->configuration;
+}
+
+const Configuration* ConfigurationStore::ReadHandle::operator->() const noexcept
+{
+    return &m_snapshot->configuration;
+}
+
+uint64_t ConfigurationStore::ReadHandle::version() const noexcept
+{
+    return m_snapshot->version;
+}
+
+ConfigurationStore::ReadHandle::ReadHandle(std::atomic<size_t>* counter, const Snapshot* snapshot) noexcept
+    : m_counter(counter), m_snapshot(snapshot)
+{
+}
+
+ConfigurationStore::ConfigurationStore(Configuration configuration)
+    : m_snapshot(new Snapshot{std::move(configuration), 1}), m_epoch(0)
+{
+    for (Counter (&epoch_readers)[StripeCount] : m_readers)
+    {
+        for (Counter& readers : epoch_readers)
+        {
+            readers.value = 0;
+        }
+    }
+}
+
+ConfigurationStore::~ConfigurationStore()
+{
+    delete m_snapshot.load();
+}
+
+ConfigurationStore::ReadHandle ConfigurationStore::read() const noexcept
+{
+    // All the operations on the epoch, the counters and the snapshot pointer are sequentially consistent. If the
+    // writer saw our counter at zero after flipping the epoch, the increment comes after the writer swapped the
+    // pointer and we load the new snapshot.
+    size_t epoch = m_epoch.load();
+    std::atomic<size_t>& counter = m_readers[epoch % 2][CurrentThreadStripe() % StripeCount].value;
+    counter.fetch_add(1);
+    return ReadHandle(&counter, m_snapshot.load());
+}
+
+void ConfigurationStore::publish(Configuration configuration)
+{
+    Snapshot* new_snapshot = new Snapshot{std::move(configuration), 0};
+
+    std::lock_guard<std::mutex> lock(m_writer_mutex);
+
+    Snapshot* old_snapshot = m_snapshot.load();
+    new_snapshot->version = (old_snapshot->version + 1);
+    m_snapshot.store(new_snapshot);
+
+    // A reader can load the epoch before a flip and only increment the counter of that epoch after the writer has
+    // waited for it. Its snapshot is then the one published by that writer but it is counted in the other epoch,
+    // which is why the epoch is flipped twice: the second wait covers it, and the epoch is back to where it started
+    // for the next writer.
+    size_t epoch = m_epoch.load();
+    m_epoch.store(epoch + 1);
+    waitForReaders(epoch);
+    m_epoch.store(epoch + 2);
+    waitForReaders(epoch + 1);
+
+    delete old_snapshot;
+}
+
+void ConfigurationStore::waitForReaders(size_t epoch) const
+{
+    for (Counter& readers : m_readers[epoch % 2])
+    {
+        while (readers.value.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationSubscriptions.hpp"
+#include <algorithm>
+
+using namespace Ishiko;
+
+namespace
+{
+
+void SplitPattern(boost::string_view pattern, std::vector<std::string>& segments, bool& prefix)
+{
+    Configuration::Path path(pattern);
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        segments.push_back(path[i].name());
+    }
+    prefix = (!segments.empty() && (segments.back() == "*"));
+    if (prefix)
+    {
+        segments.pop_back();
+    }
+}
+
+template<typename T>
+bool EraseSubscription(std::vector<std::shared_ptr<T>>& subscriptions, const T* subscription)
+{
+    for (size_t i = 0; i < subscriptions.size(); ++i)
+    {
+        if (subscriptions[i].get() == subscription)
+        {
+            subscriptions.erase(subscriptions.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+ConfigurationSubscriptions::ConfigurationSubscriptions(Configuration configuration)
+    : m_configuration(std::move(configuration)), m_batch(0), m_next_id(1)
+{
+}
+
+ConfigurationSubscriptions::SubscriptionId ConfigurationSubscriptions::subscribe(boost::string_view pattern,
+    Callback callback)
+{
+    std::shared_ptr<Subscription> subscription = std::make_shared<Subscription>();
+    SplitPattern(pattern, subscription->segments, subscription->prefix);
+    subscription->callback = std::move(callback);
+    subscription->batch = 0;
+
+    std::lock_guard<std::mutex> lock(m_index_mutex);
+    subscription->id = m_next_id++;
+    Node* node = &m_root;
+    for (const std::string& segment : subscription->segments)
+    {
+        std::unique_ptr<Node>& child = node->children[segment];
+        if (!child)
+        {
+            child.reset(new Node());
+        }
+        node = child.get();
+    }
+    (subscription->prefix ? node->prefix : node->exact).push_back(subscription);
+    m_subscriptions[subscription->id] = subscription;
+    return subscription->id;
+}
+
+bool ConfigurationSubscriptions::unsubscribe(SubscriptionId id)
+{
+    std::lock_guard<std::mutex> lock(m_index_mutex);
+
+    std::map<SubscriptionId, std::shared_ptr<Subscription>>::iterator it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end())
+    {
+        return false;
+    }
+    std::shared_ptr<Subscription> subscription = it->second;
+    m_subscriptions.erase(it);
+
+    std::vector<Node*> nodes(1, &m_root);
+    for (const std::string& segment : subscription->segments)
+    {
+        nodes.push_back(nodes.back()->children[segment].get());
+    }
+    Node* node = nodes.back();
+    EraseSubscription(subscription->prefix ? node->prefix : node->exact, subscription.get());
+
+    // Removes the nodes that no longer lead to any subscription so that the index doesn't grow with patterns that
+    // are no longer used
+    for (size_t i = subscription->segments.size(); i > 0; --i)
+    {
+        node = nodes[i];
+        if (!node->children.empty() || !node->exact.empty() || !node->prefix.empty())
+        {
+            break;
+        }
+        nodes[i - 1]->children.erase(subscription->segments[i - 1]);
+    }
+
+    return true;
+}
+
+size_t ConfigurationSubscriptions::size() const
+{
+    std::lock_guard<std::mutex> lock(m_index_mutex);
+    return m_subscriptions.size();
+}
+
+void ConfigurationSubscriptions::update(Configuration configuration)
+{
+    std::lock_guard<std::mutex> lock(m_dispatch_mutex);
+    // The subtrees the new configuration shares with the previous one are skipped by the diff
+    ConfigurationPatch patch = ConfigurationPatch::Diff(m_configuration, configuration);
+    m_configuration = std::move(configuration);
+    dispatch(m_configuration, patch);
+}
+
+void ConfigurationSubscriptions::notify(const Configuration& configuration, const ConfigurationPatch& patch)
+{
+    std::lock_guard<std::mutex> lock(m_dispatch_mutex);
+    dispatch(configuration, patch);
+}
+
+void ConfigurationSubscriptions::dispatch(const Configuration& configuration, const ConfigurationPatch& patch)
+{
+    if (patch.empty())
+    {
+        return;
+    }
+
+    // Each subscription is added to the matches the first time a change of this batch matches it, the following
+    // changes are only appended to its list
+    ++m_batch;
+    std::vector<std::shared_ptr<Subscription>> matches;
+    {
+        std::lock_guard<std::mutex> lock(m_index_mutex);
+        for (const ConfigurationPatch::Change& change : patch.changes())
+        {
+            const Node* node = &m_root;
+            for (const std::string& segment : change.path)
+            {
+                match(node->prefix, change, matches);
+                std::map<std::string, std::unique_ptr<Node>>::const_iterator it = node->children.find(segment);
+                if (it == node->children.end())
+                {
+                    node = nullptr;
+                    break;
+                }
+                node = it->second.get();
+            }
+            if (node)
+            {
+                matchSubtree(*node, change, matches);
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(),
+        [](const std::shared_ptr<Subscription>& lhs, const std::shared_ptr<Subscription>& rhs)
+        {
+            return (lhs->id < rhs->id);
+        });
+    for (const std::shared_ptr<Subscription>& subscription : matches)
+    {
+        subscription->callback(configuration, subscription->changes);
+        subscription->changes.clear();
+    }
+}
+
+void ConfigurationSubscriptions::match(const std::vector<std::shared_ptr<Subscription>>& subscriptions,
+    const ConfigurationPatch::Change& change, std::vector<std::shared_ptr<Subscription>>& matches)
+{
+    for (const std::shared_ptr<Subscription>& subscription : subscriptions)
+    {
+        if (subscription->batch != m_batch)
+        {
+            subscription->batch = m_batch;
+            subscription->changes.clear();
+            matches.push_back(subscription);
+        }
+        subscription->changes.push_back(&change);
+    }
+}
+
+void ConfigurationSubscriptions::matchSubtree(const Node& node, const ConfigurationPatch::Change& change,
+    std::vector<std::shared_ptr<Subscription>>& matches)
+{
+    match(node.exact, change, matches);
+    match(node.prefix, change, matches);
+    for (const std::pair<const std::string, std::unique_ptr<Node>>& child : node.children)
+    {
+        matchSubtree(*child.second, change, matches);
+    }
+}
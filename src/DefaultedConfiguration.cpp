@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "DefaultedConfiguration.hpp"
+#include <stdexcept>
+#include <utility>
+
+using namespace Ishiko;
+
+DefaultedConfiguration::DefaultedConfiguration(const CompiledCommandLineSpecification& specification,
+    Configuration configuration)
+    : m_specification(&specification), m_configuration(std::move(configuration))
+{
+}
+
+const Configuration& DefaultedConfiguration::parsedConfiguration() const noexcept
+{
+    return m_configuration;
+}
+
+const Configuration::Value& DefaultedConfiguration::value(boost::string_view name) const
+{
+    const Configuration::Value* result = valueOrNull(name);
+    if (!result)
+    {
+        throw std::out_of_range("DefaultedConfiguration::value: option not found");
+    }
+    return *result;
+}
+
+const char* DefaultedConfiguration::valueOrDefault(boost::string_view name, const char* default_value) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(name);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString().c_str()
+        : default_value);
+}
+
+const std::string& DefaultedConfiguration::valueOrDefault(boost::string_view name,
+    const std::string& defaultValue) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(name);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString()
+        : defaultValue);
+}
+
+const Configuration::Value* DefaultedConfiguration::valueOrNull(boost::string_view name) const noexcept
+{
+    const Configuration::Value* result = m_configuration.valueOrNull(name);
+    if (!result)
+    {
+        result = m_specification->findDefaultValue(m_specification->root(), name);
+    }
+    return result;
+}
+
+const Configuration::Value& DefaultedConfiguration::value(const Configuration::Path& path) const
+{
+    const Configuration::Value* result = valueOrNull(path);
+    if (!result)
+    {
+        throw std::out_of_range("DefaultedConfiguration::value: option not found");
+    }
+    return *result;
+}
+
+const char* DefaultedConfiguration::valueOrDefault(const Configuration::Path& path,
+    const char* default_value) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(path);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString().c_str()
+        : default_value);
+}
+
+const std::string& DefaultedConfiguration::valueOrDefault(const Configuration::Path& path,
+    const std::string& defaultValue) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(path);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString()
+        : defaultValue);
+}
+
+const Configuration::Value* DefaultedConfiguration::valueOrNull(const Configuration::Path& path) const noexcept
+{
+    if (path.size() == 0)
+    {
+        return nullptr;
+    }
+
+    // Follows the commands selected on the command line, the same way the parser descended into them, so that the
+    // defaults of the command at the end of the path can be found
+    const Configuration* current = &m_configuration;
+    const CompiledCommandLineSpecification::Command* command = &m_specification->root();
+    for (size_t i = 0; (i + 1) < path.size(); ++i)
+    {
+        const Configuration::Value* value = current->valueOrNull(path[i]);
+        if (!value || (value->type() != Configuration::Value::Type::configuration))
+        {
+            return nullptr;
+        }
+        current = &value->asConfiguration();
+
+        if (command)
+        {
+            const Configuration::Value* command_name = current->valueOrNull("name");
+            if (command_name && (command_name->type() == Configuration::Value::Type::string))
+            {
+                const CompiledCommandLineSpecification::Command* subcommand =
+                    m_specification->findCommand(*command, path[i].name(), command_name->asString());
+                if (!subcommand && (command != &m_specification->root()))
+                {
+                    subcommand =
+                        m_specification->findCommand(m_specification->root(), path[i].name(), command_name->asString());
+                }
+                command = subcommand;
+            }
+            else
+            {
+                command = nullptr;
+            }
+        }
+    }
+
+    const Configuration::Value* result = current->valueOrNull(path[path.size() - 1]);
+    if (!result && command)
+    {
+        result = m_specification->findDefaultValue(*command, path[path.size() - 1].name());
+    }
+    return result;
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnvironmentParser.hpp"
+#include <cctype>
+#include <cstring>
+#include <unordered_set>
+#if defined(_WIN32)
+#include <stdlib.h>
+#else
+extern char** environ;
+#endif
+
+using namespace Ishiko;
+
+EnvironmentParser::EnvironmentParser(const CompiledCommandLineSpecification& specification,
+    boost::string_view prefix)
+    : m_prefix(prefix.data(), prefix.size())
+{
+    std::unordered_set<std::string> names;
+    m_variables.reserve(specification.namedOptionCount());
+    for (size_t i = 0; i < specification.namedOptionCount(); ++i)
+    {
+        const CompiledCommandLineSpecification::Option& option = specification.namedOption(i);
+        std::string name = VariableName(boost::string_view(), option.name);
+        // The perfect hash needs distinct keys
+        if (names.insert(name).second)
+        {
+            m_variables.push_back({std::move(name), Configuration::Path(option.name), &option});
+        }
+    }
+
+    m_index = PerfectHashIndex(m_variables.size(),
+        [this](size_t index, uint64_t seed)
+        {
+            return PerfectHashIndex::Hash(m_variables[index].name, seed);
+        });
+}
+
+std::string EnvironmentParser::VariableName(boost::string_view prefix, boost::string_view option_name)
+{
+    std::string result(prefix.data(), prefix.size());
+    result.reserve(prefix.size() + (2 * option_name.size()));
+    for (char c : option_name)
+    {
+        if (c == '.')
+        {
+            result += "__";
+        }
+        else if (c == '-')
+        {
+            result += '_';
+        }
+        else
+        {
+            result += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    return result;
+}
+
+void EnvironmentParser::parse(Configuration& configuration) const
+{
+#if defined(_WIN32)
+    parse(_environ, configuration);
+#else
+    parse(environ, configuration);
+#endif
+}
+
+void EnvironmentParser::parse(const char* const* environment, Configuration& configuration) const
+{
+    if (!environment || m_variables.empty())
+    {
+        return;
+    }
+
+    for (const char* const* variable = environment; *variable; ++variable)
+    {
+        // Most variables don't have the prefix so they are rejected before looking for the end of their name
+        const char* p = *variable;
+        if (std::strncmp(p, m_prefix.data(), m_prefix.size()) != 0)
+        {
+            continue;
+        }
+        p += m_prefix.size();
+        const char* separator = std::strchr(p, '=');
+        if (!separator)
+        {
+            continue;
+        }
+
+        boost::string_view name(p, separator - p);
+        size_t index = m_index.find(PerfectHashIndex::Hash(name, m_index.seed()));
+        if ((index == PerfectHashIndex::npos) || (m_variables[index].name != name))
+        {
+            continue;
+        }
+
+        const Variable& matched_variable = m_variables[index];
+        configuration.set(matched_variable.path, matched_variable.option->details.createValue(separator + 1));
+    }
+}
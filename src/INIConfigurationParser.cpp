@@ -0,0 +1,564 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "INIConfigurationParser.hpp"
+#include "MemoryMappedFile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+bool IsBlank(char c) noexcept
+{
+    return ((c == ' ') || (c == '\t'));
+}
+
+const char* SkipBlanks(const char* p, const char* end) noexcept
+{
+    while ((p != end) && IsBlank(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+
+const char* TrimTrailingBlanks(const char* begin, const char* end) noexcept
+{
+    while ((end != begin) && IsBlank(*(end - 1)))
+    {
+        --end;
+    }
+    return end;
+}
+
+class INIParser
+{
+public:
+    INIParser(boost::string_view text, ConfigurationArena* arena)
+        : m_text(text), m_arena(arena), m_current_section(0)
+    {
+        // The root section holds the keys that come before the first section header
+        m_sections.push_back({std::vector<std::string>(), 0});
+        m_section_ids[""] = 0;
+    }
+
+    Configuration parseDocument()
+    {
+        const char* p = m_text.data();
+        const char* end = (m_text.data() + m_text.size());
+        if (m_text.starts_with("\xEF\xBB\xBF"))
+        {
+            p += 3;
+        }
+        while (p != end)
+        {
+            const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* next_line = (line_end ? (line_end + 1) : end);
+            if (!line_end)
+            {
+                line_end = end;
+            }
+            if ((line_end != p) && (*(line_end - 1) == '\r'))
+            {
+                --line_end;
+            }
+            parseLine(p, line_end);
+            p = next_line;
+        }
+        return build();
+    }
+
+private:
+    enum class ValueKind
+    {
+        scalar,
+        array_element,
+        // Records that an empty array was assigned to the key
+        empty_array
+    };
+
+    struct Section
+    {
+        std::vector<std::string> segments;
+        // The position of the header that first opened the section, for the errors found when building
+        size_t offset;
+    };
+
+    struct Entry
+    {
+        size_t section;
+        boost::string_view name;
+        boost::string_view value;
+        ValueKind kind;
+    };
+
+    void parseLine(const char* p, const char* end)
+    {
+        p = SkipBlanks(p, end);
+        if ((p == end) || (*p == '#') || (*p == ';'))
+        {
+            return;
+        }
+        else if (*p == '[')
+        {
+            parseSectionHeader(p, end);
+        }
+        else
+        {
+            parseKeyValue(p, end);
+        }
+    }
+
+    void parseSectionHeader(const char* p, const char* end)
+    {
+        const char* header = p;
+        const char* name_end = static_cast<const char*>(std::memchr(p, ']', end - p));
+        if (!name_end)
+        {
+            fail("expected ']'", end);
+        }
+        const char* rest = SkipBlanks(name_end + 1, end);
+        if ((rest != end) && (*rest != '#') && (*rest != ';'))
+        {
+            fail("unexpected content after the section header", rest);
+        }
+
+        std::vector<std::string> segments;
+        splitDottedName(p + 1, name_end, segments);
+        m_current_section = findOrAddSection(std::move(segments), header);
+    }
+
+    void parseKeyValue(const char* p, const char* end)
+    {
+        const char* separator = static_cast<const char*>(std::memchr(p, '=', end - p));
+        if (!separator)
+        {
+            fail("expected '='", end);
+        }
+
+        // A dotted key puts the value in a nested section
+        const char* name_begin = p;
+        const char* name_end = TrimTrailingBlanks(p, separator);
+        const char* last_dot = name_end;
+        while ((last_dot != name_begin) && (*(last_dot - 1) != '.'))
+        {
+            --last_dot;
+        }
+        size_t section = m_current_section;
+        if (last_dot != name_begin)
+        {
+            std::vector<std::string> segments = m_sections[m_current_section].segments;
+            splitDottedName(name_begin, last_dot - 1, segments);
+            section = findOrAddSection(std::move(segments), name_begin);
+            name_begin = SkipBlanks(last_dot, name_end);
+        }
+        boost::string_view name(name_begin, name_end - name_begin);
+        if (name.empty())
+        {
+            fail("expected a key", name_begin);
+        }
+
+        p = SkipBlanks(separator + 1, end);
+        if ((p != end) && (*p == '['))
+        {
+            parseArray(section, name, p + 1, end);
+        }
+        else
+        {
+            boost::string_view value;
+            p = parseValue(p, end, false, value);
+            p = SkipBlanks(p, end);
+            if ((p != end) && (*p != '#') && (*p != ';'))
+            {
+                fail("unexpected content after the value", p);
+            }
+            m_entries.push_back({section, name, value, ValueKind::scalar});
+        }
+    }
+
+    // Called after the opening bracket
+    void parseArray(size_t section, boost::string_view name, const char* p, const char* end)
+    {
+        size_t size = 0;
+        p = SkipBlanks(p, end);
+        if ((p != end) && (*p == ']'))
+        {
+            ++p;
+        }
+        else
+        {
+            while (true)
+            {
+                boost::string_view value;
+                p = parseValue(p, end, true, value);
+                m_entries.push_back({section, name, value, ValueKind::array_element});
+                ++size;
+                p = SkipBlanks(p, end);
+                if (p == end)
+                {
+                    fail("expected ',' or ']'", p);
+                }
+                else if (*p == ']')
+                {
+                    ++p;
+                    break;
+                }
+                else if (*p == ',')
+                {
+                    p = SkipBlanks(p + 1, end);
+                }
+                else
+                {
+                    fail("expected ',' or ']'", p);
+                }
+            }
+        }
+
+        p = SkipBlanks(p, end);
+        if ((p != end) && (*p != '#') && (*p != ';'))
+        {
+            fail("unexpected content after the array", p);
+        }
+        if (size == 0)
+        {
+            m_entries.push_back({section, name, boost::string_view(), ValueKind::empty_array});
+        }
+    }
+
+    // Parses a quoted string, or an unquoted value that ends at the end of the line, at a comment or, in an array, at
+    // the next ',' or ']'. Returns the position after the value.
+    const char* parseValue(const char* p, const char* end, bool in_array, boost::string_view& value)
+    {
+        if ((p != end) && (*p == '"'))
+        {
+            return parseBasicString(p, end, value);
+        }
+        else if ((p != end) && (*p == '\''))
+        {
+            const char* closing_quote = static_cast<const char*>(std::memchr(p + 1, '\'', end - p - 1));
+            if (!closing_quote)
+            {
+                fail("unterminated string", p);
+            }
+            value = boost::string_view(p + 1, closing_quote - p - 1);
+            return (closing_quote + 1);
+        }
+
+        const char* begin = p;
+        while ((p != end) && !(in_array && ((*p == ',') || (*p == ']'))))
+        {
+            if (((*p == '#') || (*p == ';')) && (p != begin) && IsBlank(*(p - 1)))
+            {
+                break;
+            }
+            ++p;
+        }
+        value = boost::string_view(begin, TrimTrailingBlanks(begin, p) - begin);
+        if (in_array && value.empty())
+        {
+            fail("expected a value", begin);
+        }
+        return p;
+    }
+
+    const char* parseBasicString(const char* p, const char* end, boost::string_view& value)
+    {
+        const char* begin = (p + 1);
+        const char* special = begin;
+        while ((special != end) && (*special != '"') && (*special != '\\'))
+        {
+            ++special;
+        }
+        if (special == end)
+        {
+            fail("unterminated string", p);
+        }
+        if (*special == '"')
+        {
+            // The common case, the value is a view of the text
+            value = boost::string_view(begin, special - begin);
+            return (special + 1);
+        }
+
+        // The unescaped value is stored in a deque so that the views of the previous ones remain valid
+        m_unescaped.emplace_back(begin, special);
+        std::string& unescaped = m_unescaped.back();
+        p = special;
+        while (true)
+        {
+            if (p == end)
+            {
+                fail("unterminated string", begin - 1);
+            }
+            else if (*p == '"')
+            {
+                value = unescaped;
+                return (p + 1);
+            }
+            else if (*p == '\\')
+            {
+                if ((p + 1) == end)
+                {
+                    fail("unterminated string", begin - 1);
+                }
+                switch (p[1])
+                {
+                case '"':
+                    unescaped.push_back('"');
+                    break;
+
+                case '\\':
+                    unescaped.push_back('\\');
+                    break;
+
+                case 'n':
+                    unescaped.push_back('\n');
+                    break;
+
+                case 'r':
+                    unescaped.push_back('\r');
+                    break;
+
+                case 't':
+                    unescaped.push_back('\t');
+                    break;
+
+                default:
+                    fail("invalid escape sequence", p);
+                }
+                p += 2;
+            }
+            else
+            {
+                unescaped.push_back(*p);
+                ++p;
+            }
+        }
+    }
+
+    void splitDottedName(const char* p, const char* end, std::vector<std::string>& segments)
+    {
+        while (true)
+        {
+            const char* dot = static_cast<const char*>(std::memchr(p, '.', end - p));
+            const char* segment_end = (dot ? dot : end);
+            const char* segment_begin = SkipBlanks(p, segment_end);
+            segment_end = TrimTrailingBlanks(segment_begin, segment_end);
+            if (segment_begin == segment_end)
+            {
+                fail("empty name", segment_begin);
+            }
+            segments.emplace_back(segment_begin, segment_end);
+            if (!dot)
+            {
+                return;
+            }
+            p = (dot + 1);
+        }
+    }
+
+    size_t findOrAddSection(std::vector<std::string>&& segments, const char* position)
+    {
+        std::string name;
+        for (const std::string& segment : segments)
+        {
+            name.append(segment).push_back('.');
+        }
+        std::map<std::string, size_t>::iterator it = m_section_ids.find(name);
+        if (it != m_section_ids.end())
+        {
+            return it->second;
+        }
+
+        size_t result = m_sections.size();
+        m_sections.push_back({std::move(segments), static_cast<size_t>(position - m_text.data())});
+        m_section_ids.emplace(std::move(name), result);
+        return result;
+    }
+
+    Configuration build()
+    {
+        // The entries of each section end up together and in name order, the values of a repeated key in the order
+        // they were read
+        std::stable_sort(m_entries.begin(), m_entries.end(),
+            [](const Entry& lhs, const Entry& rhs)
+            {
+                return ((lhs.section < rhs.section) || ((lhs.section == rhs.section) && (lhs.name < rhs.name)));
+            });
+        std::vector<size_t> first_entries(m_sections.size() + 1, m_entries.size());
+        for (size_t i = m_entries.size(); i > 0; --i)
+        {
+            first_entries[m_entries[i - 1].section] = (i - 1);
+        }
+        for (size_t i = m_sections.size(); i > 0; --i)
+        {
+            first_entries[i - 1] = std::min(first_entries[i - 1], first_entries[i]);
+        }
+
+        // Sorting the sections by name puts each section right before its subsections, so that the whole tree can be
+        // built bottom-up without looking up a path for each section
+        m_order.resize(m_sections.size());
+        for (size_t i = 0; i < m_order.size(); ++i)
+        {
+            m_order[i] = i;
+        }
+        std::sort(m_order.begin(), m_order.end(),
+            [this](size_t lhs, size_t rhs)
+            {
+                return (m_sections[lhs].segments < m_sections[rhs].segments);
+            });
+        m_first_entries.swap(first_entries);
+
+        // The root section is always the first one
+        return buildTable(0, 0, m_order.size());
+    }
+
+    // Builds the table made of the sections in order[begin, end), they all have the same first depth segments. The
+    // keys of the section itself, if it was declared, and the subsections are merged in name order.
+    Configuration buildTable(size_t depth, size_t begin, size_t end)
+    {
+        size_t entry = 0;
+        size_t entries_end = 0;
+        if (m_sections[m_order[begin]].segments.size() == depth)
+        {
+            entry = m_first_entries[m_order[begin]];
+            entries_end = m_first_entries[m_order[begin] + 1];
+            ++begin;
+        }
+
+        Configuration::Builder& builder = builderAt(depth);
+        while ((entry < entries_end) || (begin < end))
+        {
+            size_t group_end = entry;
+            if (entry < entries_end)
+            {
+                do
+                {
+                    ++group_end;
+                } while ((group_end < entries_end) && (m_entries[group_end].name == m_entries[entry].name));
+            }
+            size_t subsection_end = begin;
+            if (begin < end)
+            {
+                const std::string& name = m_sections[m_order[begin]].segments[depth];
+                do
+                {
+                    ++subsection_end;
+                } while ((subsection_end < end) && (m_sections[m_order[subsection_end]].segments[depth] == name));
+            }
+
+            int comparison = 1;
+            if ((entry < entries_end) && (begin < end))
+            {
+                comparison = m_entries[entry].name.compare(m_sections[m_order[begin]].segments[depth]);
+            }
+            else if (entry < entries_end)
+            {
+                comparison = -1;
+            }
+
+            if (comparison == 0)
+            {
+                fail("section conflicts with a key of the same name",
+                    m_text.data() + m_sections[m_order[begin]].offset);
+            }
+            else if (comparison < 0)
+            {
+                addKey(entry, group_end, builder);
+                entry = group_end;
+            }
+            else
+            {
+                std::string name = m_sections[m_order[begin]].segments[depth];
+                Configuration table = buildTable(depth + 1, begin, subsection_end);
+                builder.add(std::move(name), Configuration::Value(std::move(table)));
+                begin = subsection_end;
+            }
+        }
+        return builder.build();
+    }
+
+    // Adds the values of the entries in [begin, end), they all have the same name
+    void addKey(size_t begin, size_t end, Configuration::Builder& builder)
+    {
+        const Entry& first = m_entries[begin];
+        if (((end - begin) == 1) && (first.kind == ValueKind::scalar))
+        {
+            builder.add(first.name.to_string(), Configuration::Value(first.value.to_string()));
+        }
+        else
+        {
+            std::vector<std::string> values;
+            values.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (m_entries[i].kind != ValueKind::empty_array)
+                {
+                    values.emplace_back(m_entries[i].value.data(), m_entries[i].value.size());
+                }
+            }
+            builder.add(first.name.to_string(), Configuration::Value(std::move(values)));
+        }
+    }
+
+    // The tables at the same depth are built with the same builder so that its buffer is reused
+    Configuration::Builder& builderAt(size_t depth)
+    {
+        if (depth == m_builders.size())
+        {
+            m_builders.emplace_back(new Configuration::Builder(m_arena));
+        }
+        return *m_builders[depth];
+    }
+
+    [[noreturn]] void fail(const std::string& message, const char* position) const
+    {
+        throw ConfigurationParseError::AtOffset(message, m_text, static_cast<size_t>(position - m_text.data()));
+    }
+
+    boost::string_view m_text;
+    ConfigurationArena* m_arena;
+    std::vector<Section> m_sections;
+    // The sections by name, the segments are joined and followed by a dot
+    std::map<std::string, size_t> m_section_ids;
+    size_t m_current_section;
+    std::vector<Entry> m_entries;
+    std::deque<std::string> m_unescaped;
+    // The sections in name order and the index of the first entry of each section, set by build
+    std::vector<size_t> m_order;
+    std::vector<size_t> m_first_entries;
+    std::vector<std::unique_ptr<Configuration::Builder>> m_builders;
+};
+
+}
+
+void INIConfigurationParser::parse(boost::string_view text, Configuration& configuration)
+{
+    INIParser parser(text, configuration.arena());
+    Configuration result = parser.parseDocument();
+    if (configuration.size() == 0)
+    {
+        configuration = std::move(result);
+    }
+    else
+    {
+        for (const Configuration::Entry& entry : result)
+        {
+            configuration.set(entry.first, entry.second);
+        }
+    }
+}
+
+void INIConfigurationParser::parseFile(const std::string& file_path, Configuration& configuration)
+{
+    MemoryMappedFile file(file_path);
+    parse(file.view(), configuration);
+}
@@ -0,0 +1,619 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "JSONConfigurationParser.hpp"
+#include "MemoryMappedFile.hpp"
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ISHIKO_CONFIGURATION_USE_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace Ishiko;
+
+namespace
+{
+
+// Limits the recursion so that deeply nested input can't overflow the stack
+const size_t MaxDepth = 512;
+
+#if defined(ISHIKO_CONFIGURATION_USE_SSE2)
+unsigned int CountTrailingZeros(unsigned int mask) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long result;
+    _BitScanForward(&result, mask);
+    return result;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+bool IsWhitespace(char c) noexcept
+{
+    return ((c == ' ') || (c == '\n') || (c == '\r') || (c == '\t'));
+}
+
+// Returns the first quote, backslash or control character, or end if there is none
+const char* FindStringSpecialCharacter(const char* p, const char* end) noexcept
+{
+#if defined(ISHIKO_CONFIGURATION_USE_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i last_control = _mm_set1_epi8(0x1F);
+    while ((end - p) >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // The comparisons are signed so control characters are found as the bytes that max_epu8 leaves unchanged
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, last_control), last_control));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+        if (mask != 0)
+        {
+            return (p + CountTrailingZeros(mask));
+        }
+        p += 16;
+    }
+#endif
+    while ((p != end) && (*p != '"') && (*p != '\\') && (static_cast<unsigned char>(*p) >= 0x20))
+    {
+        ++p;
+    }
+    return p;
+}
+
+const char* SkipWhitespace(const char* p, const char* end) noexcept
+{
+    // Compact JSON has no whitespace between tokens, pretty printed JSON has runs of indentation
+    if ((p == end) || !IsWhitespace(*p))
+    {
+        return p;
+    }
+#if defined(ISHIKO_CONFIGURATION_USE_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i new_line = _mm_set1_epi8('\n');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    while ((end - p) >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, new_line)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage_return), _mm_cmpeq_epi8(chunk, tab)));
+        unsigned int mask = (~static_cast<unsigned int>(_mm_movemask_epi8(whitespace)) & 0xFFFF);
+        if (mask != 0)
+        {
+            return (p + CountTrailingZeros(mask));
+        }
+        p += 16;
+    }
+#endif
+    while ((p != end) && IsWhitespace(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+
+bool IsDigit(char c) noexcept
+{
+    return ((c >= '0') && (c <= '9'));
+}
+
+int HexDigitValue(char c) noexcept
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return (c - '0');
+    }
+    else if ((c >= 'a') && (c <= 'f'))
+    {
+        return (c - 'a' + 10);
+    }
+    else if ((c >= 'A') && (c <= 'F'))
+    {
+        return (c - 'A' + 10);
+    }
+    return -1;
+}
+
+void AppendUTF8(uint32_t code_point, std::string& text)
+{
+    if (code_point < 0x80)
+    {
+        text.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800)
+    {
+        text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000)
+    {
+        text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else
+    {
+        text.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+class JSONParser
+{
+public:
+    JSONParser(boost::string_view text, ConfigurationArena* arena)
+        : m_text(text), m_p(text.data()), m_end(text.data() + text.size()), m_arena(arena)
+    {
+    }
+
+    Configuration parseDocument()
+    {
+        // A UTF-8 byte order mark is allowed
+        if (m_text.starts_with("\xEF\xBB\xBF"))
+        {
+            m_p += 3;
+        }
+        m_p = SkipWhitespace(m_p, m_end);
+        if ((m_p == m_end) || (*m_p != '{'))
+        {
+            fail("expected an object");
+        }
+        ++m_p;
+        Configuration::Builder& builder = builderAt(0);
+        parseObject(builder, 1);
+        m_p = SkipWhitespace(m_p, m_end);
+        if (m_p != m_end)
+        {
+            fail("unexpected content after the object");
+        }
+        return builder.build();
+    }
+
+private:
+    // Called after the opening brace
+    void parseObject(Configuration::Builder& builder, size_t depth)
+    {
+        m_p = SkipWhitespace(m_p, m_end);
+        if ((m_p != m_end) && (*m_p == '}'))
+        {
+            ++m_p;
+            return;
+        }
+
+        while (true)
+        {
+            if ((m_p == m_end) || (*m_p != '"'))
+            {
+                fail("expected a member name");
+            }
+            ++m_p;
+            std::string name;
+            parseString(name);
+
+            m_p = SkipWhitespace(m_p, m_end);
+            if ((m_p == m_end) || (*m_p != ':'))
+            {
+                fail("expected ':'");
+            }
+            m_p = SkipWhitespace(m_p + 1, m_end);
+
+            parseValue(builder, std::move(name), depth);
+
+            m_p = SkipWhitespace(m_p, m_end);
+            if (m_p == m_end)
+            {
+                fail("expected ',' or '}'");
+            }
+            else if (*m_p == ',')
+            {
+                m_p = SkipWhitespace(m_p + 1, m_end);
+            }
+            else if (*m_p == '}')
+            {
+                ++m_p;
+                return;
+            }
+            else
+            {
+                fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    // The value is constructed directly in the builder, nothing is added for null
+    void parseValue(Configuration::Builder& builder, std::string&& name, size_t depth)
+    {
+        if (m_p == m_end)
+        {
+            fail("expected a value");
+        }
+
+        switch (*m_p)
+        {
+        case '{':
+            {
+                if (depth >= MaxDepth)
+                {
+                    fail("too many nested objects");
+                }
+                ++m_p;
+                Configuration::Builder& nested_builder = builderAt(depth);
+                parseObject(nested_builder, depth + 1);
+                builder.add(std::move(name), Configuration::Value(nested_builder.build()));
+            }
+            return;
+
+        case '[':
+            {
+                ++m_p;
+                std::vector<std::string> items;
+                parseArray(items);
+                builder.add(std::move(name), Configuration::Value(std::move(items)));
+            }
+            return;
+
+        case '"':
+            {
+                ++m_p;
+                std::string text;
+                parseString(text);
+                builder.add(std::move(name), Configuration::Value(std::move(text)));
+            }
+            return;
+
+        case 't':
+            parseLiteral("true");
+            builder.add(std::move(name), Configuration::Value(true));
+            return;
+
+        case 'f':
+            parseLiteral("false");
+            builder.add(std::move(name), Configuration::Value(false));
+            return;
+
+        case 'n':
+            parseLiteral("null");
+            return;
+
+        default:
+            builder.add(std::move(name), parseNumber());
+            return;
+        }
+    }
+
+    // Called after the opening bracket
+    void parseArray(std::vector<std::string>& items)
+    {
+        m_p = SkipWhitespace(m_p, m_end);
+        if ((m_p != m_end) && (*m_p == ']'))
+        {
+            ++m_p;
+            return;
+        }
+
+        while (true)
+        {
+            if (m_p == m_end)
+            {
+                fail("expected a value");
+            }
+            else if (*m_p == '"')
+            {
+                ++m_p;
+                items.emplace_back();
+                parseString(items.back());
+            }
+            else if (*m_p == 't')
+            {
+                parseLiteral("true");
+                items.emplace_back("true");
+            }
+            else if (*m_p == 'f')
+            {
+                parseLiteral("false");
+                items.emplace_back("false");
+            }
+            else if ((*m_p == '-') || IsDigit(*m_p))
+            {
+                // Numbers are kept as they were written
+                const char* start = m_p;
+                bool integer;
+                scanNumber(integer);
+                items.emplace_back(start, m_p);
+            }
+            else
+            {
+                fail("only arrays of strings, numbers and booleans are supported");
+            }
+
+            m_p = SkipWhitespace(m_p, m_end);
+            if (m_p == m_end)
+            {
+                fail("expected ',' or ']'");
+            }
+            else if (*m_p == ',')
+            {
+                m_p = SkipWhitespace(m_p + 1, m_end);
+            }
+            else if (*m_p == ']')
+            {
+                ++m_p;
+                return;
+            }
+            else
+            {
+                fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    // Called after the opening quote
+    void parseString(std::string& text)
+    {
+        const char* start = (m_p - 1);
+        while (true)
+        {
+            const char* special = FindStringSpecialCharacter(m_p, m_end);
+            if (special == m_end)
+            {
+                m_p = start;
+                fail("unterminated string");
+            }
+            text.append(m_p, special);
+            m_p = special;
+            if (*m_p == '"')
+            {
+                ++m_p;
+                return;
+            }
+            else if (*m_p == '\\')
+            {
+                parseEscapeSequence(text);
+            }
+            else
+            {
+                fail("control character in string");
+            }
+        }
+    }
+
+    void parseEscapeSequence(std::string& text)
+    {
+        const char* start = m_p;
+        if ((m_end - m_p) < 2)
+        {
+            fail("invalid escape sequence");
+        }
+        char c = m_p[1];
+        m_p += 2;
+        switch (c)
+        {
+        case '"': text.push_back('"'); return;
+        case '\\': text.push_back('\\'); return;
+        case '/': text.push_back('/'); return;
+        case 'b': text.push_back('\b'); return;
+        case 'f': text.push_back('\f'); return;
+        case 'n': text.push_back('\n'); return;
+        case 'r': text.push_back('\r'); return;
+        case 't': text.push_back('\t'); return;
+        case 'u': break;
+        default:
+            m_p = start;
+            fail("invalid escape sequence");
+        }
+
+        uint32_t code_point = parseHexDigits(start);
+        if ((code_point >= 0xD800) && (code_point <= 0xDBFF))
+        {
+            // A high surrogate must be followed by a low surrogate, together they encode one code point
+            if (((m_end - m_p) < 2) || (m_p[0] != '\\') || (m_p[1] != 'u'))
+            {
+                m_p = start;
+                fail("invalid surrogate pair");
+            }
+            m_p += 2;
+            uint32_t low_surrogate = parseHexDigits(start);
+            if ((low_surrogate < 0xDC00) || (low_surrogate > 0xDFFF))
+            {
+                m_p = start;
+                fail("invalid surrogate pair");
+            }
+            code_point = (0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00));
+        }
+        else if ((code_point >= 0xDC00) && (code_point <= 0xDFFF))
+        {
+            m_p = start;
+            fail("invalid surrogate pair");
+        }
+        AppendUTF8(code_point, text);
+    }
+
+    uint32_t parseHexDigits(const char* escape_sequence_start)
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            int digit = ((m_p != m_end) ? HexDigitValue(*m_p) : -1);
+            if (digit < 0)
+            {
+                m_p = escape_sequence_start;
+                fail("invalid escape sequence");
+            }
+            result = ((result << 4) | static_cast<uint32_t>(digit));
+            ++m_p;
+        }
+        return result;
+    }
+
+    void parseLiteral(boost::string_view literal)
+    {
+        if (!boost::string_view(m_p, m_end - m_p).starts_with(literal))
+        {
+            fail("invalid literal");
+        }
+        m_p += literal.size();
+    }
+
+    Configuration::Value parseNumber()
+    {
+        const char* start = m_p;
+        bool integer;
+        scanNumber(integer);
+
+        if (integer)
+        {
+            // Integers are converted directly, those that don't fit in 64 bits are converted as floating point
+            bool negative = (*start == '-');
+            uint64_t magnitude = 0;
+            bool overflow = false;
+            for (const char* p = (negative ? (start + 1) : start); p != m_p; ++p)
+            {
+                uint64_t digit = static_cast<uint64_t>(*p - '0');
+                if (magnitude > ((UINT64_MAX - digit) / 10))
+                {
+                    overflow = true;
+                    break;
+                }
+                magnitude = ((magnitude * 10) + digit);
+            }
+            if (!overflow && !negative && (magnitude <= uint64_t(INT64_MAX)))
+            {
+                return Configuration::Value(static_cast<int64_t>(magnitude));
+            }
+            else if (!overflow && negative && (magnitude <= (uint64_t(INT64_MAX) + 1)))
+            {
+                return Configuration::Value(static_cast<int64_t>(0 - magnitude));
+            }
+        }
+
+        // strtod needs a null terminated string and the text may not have one after the number
+        m_number.assign(start, m_p);
+        errno = 0;
+        double number = std::strtod(m_number.c_str(), nullptr);
+        // strtod also reports ERANGE for numbers that are too small to be normalized, those are converted to the
+        // nearest subnormal or to 0 and are accepted, only overflows are errors
+        if ((errno == ERANGE) && (std::fabs(number) == HUGE_VAL))
+        {
+            m_p = start;
+            fail("number out of range");
+        }
+        return Configuration::Value(number);
+    }
+
+    // Moves past a number, checking it follows the JSON syntax
+    void scanNumber(bool& integer)
+    {
+        const char* start = m_p;
+        integer = true;
+        if ((m_p != m_end) && (*m_p == '-'))
+        {
+            ++m_p;
+        }
+        if ((m_p == m_end) || !IsDigit(*m_p))
+        {
+            m_p = start;
+            fail((*start == '-') ? "invalid number" : "unexpected character");
+        }
+        if (*m_p == '0')
+        {
+            ++m_p;
+        }
+        else
+        {
+            skipDigits();
+        }
+        if ((m_p != m_end) && (*m_p == '.'))
+        {
+            integer = false;
+            ++m_p;
+            if ((m_p == m_end) || !IsDigit(*m_p))
+            {
+                fail("invalid number");
+            }
+            skipDigits();
+        }
+        if ((m_p != m_end) && ((*m_p == 'e') || (*m_p == 'E')))
+        {
+            integer = false;
+            ++m_p;
+            if ((m_p != m_end) && ((*m_p == '+') || (*m_p == '-')))
+            {
+                ++m_p;
+            }
+            if ((m_p == m_end) || !IsDigit(*m_p))
+            {
+                fail("invalid number");
+            }
+            skipDigits();
+        }
+    }
+
+    void skipDigits() noexcept
+    {
+        while ((m_p != m_end) && IsDigit(*m_p))
+        {
+            ++m_p;
+        }
+    }
+
+    // The objects at the same depth are built with the same builder so that its buffer is reused
+    Configuration::Builder& builderAt(size_t depth)
+    {
+        if (depth == m_builders.size())
+        {
+            m_builders.emplace_back(new Configuration::Builder(m_arena));
+        }
+        return *m_builders[depth];
+    }
+
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        throw ConfigurationParseError::AtOffset(message, m_text, static_cast<size_t>(m_p - m_text.data()));
+    }
+
+    boost::string_view m_text;
+    const char* m_p;
+    const char* m_end;
+    ConfigurationArena* m_arena;
+    std::string m_number;
+    std::vector<std::unique_ptr<Configuration::Builder>> m_builders;
+};
+
+}
+
+void JSONConfigurationParser::parse(boost::string_view text, Configuration& configuration)
+{
+    JSONParser parser(text, configuration.arena());
+    Configuration result = parser.parseDocument();
+    if (configuration.size() == 0)
+    {
+        configuration = std::move(result);
+    }
+    else
+    {
+        for (const Configuration::Entry& entry : result)
+        {
+            configuration.set(entry.first, entry.second);
+        }
+    }
+}
+
+void JSONConfigurationParser::parseFile(const std::string& file_path, Configuration& configuration)
+{
+    MemoryMappedFile file(file_path);
+    parse(file.view(), configuration);
+}
@@ -0,0 +1,315 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "LayeredConfiguration.hpp"
+#include <memory>
+#include <stdexcept>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// The result of looking up a path in a single layer
+enum class LookupResult
+{
+    found,
+    // The layer doesn't have the option, the lower layers may
+    missing,
+    // The layer has a value that isn't a configuration on the path so the lower layers are hidden
+    hidden
+};
+
+LookupResult Lookup(const Configuration& layer, const Configuration::Path& path, const Configuration::Value*& value)
+{
+    if (path.size() == 0)
+    {
+        // An empty path doesn't name any option, like in Configuration
+        return LookupResult::missing;
+    }
+
+    const Configuration* current = &layer;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        value = current->valueOrNull(path[i]);
+        if (!value)
+        {
+            return LookupResult::missing;
+        }
+        if ((i + 1) < path.size())
+        {
+            if (value->type() != Configuration::Value::Type::configuration)
+            {
+                return LookupResult::hidden;
+            }
+            current = &value->asConfiguration();
+        }
+    }
+    return LookupResult::found;
+}
+
+class LayerMerger
+{
+public:
+    explicit LayerMerger(ConfigurationArena* arena)
+        : m_arena(arena)
+    {
+    }
+
+    // The layers are from the highest to the lowest and there are at least two of them
+    Configuration merge(const std::vector<const Configuration*>& layers, size_t depth)
+    {
+        std::vector<Configuration::const_iterator> positions;
+        std::vector<Configuration::const_iterator> ends;
+        positions.reserve(layers.size());
+        ends.reserve(layers.size());
+        for (const Configuration* layer : layers)
+        {
+            positions.push_back(layer->begin());
+            ends.push_back(layer->end());
+        }
+
+        Configuration::Builder& builder = builderAt(depth);
+        std::vector<size_t> matching_layers;
+        std::vector<const Configuration*> nested_layers;
+        while (true)
+        {
+            // There are few layers so the smallest name is found with a linear scan rather than a heap
+            const std::string* name = nullptr;
+            for (size_t i = 0; i < layers.size(); ++i)
+            {
+                if ((positions[i] != ends[i]) && (!name || (positions[i]->first < *name)))
+                {
+                    name = &positions[i]->first;
+                }
+            }
+            if (!name)
+            {
+                break;
+            }
+            matching_layers.clear();
+            for (size_t i = 0; i < layers.size(); ++i)
+            {
+                if ((positions[i] != ends[i]) && (positions[i]->first == *name))
+                {
+                    matching_layers.push_back(i);
+                }
+            }
+
+            // The highest layer that has the option decides: a value that isn't a configuration hides the lower
+            // layers, configurations are merged until a lower layer has something else
+            const Configuration::Value& top = positions[matching_layers[0]]->second;
+            nested_layers.clear();
+            if (top.type() == Configuration::Value::Type::configuration)
+            {
+                for (size_t i : matching_layers)
+                {
+                    const Configuration::Value& value = positions[i]->second;
+                    if (value.type() != Configuration::Value::Type::configuration)
+                    {
+                        break;
+                    }
+                    nested_layers.push_back(&value.asConfiguration());
+                }
+            }
+
+            if (nested_layers.size() > 1)
+            {
+                Configuration nested = merge(nested_layers, depth + 1);
+                builder.add(*name, Configuration::Value(std::move(nested)));
+            }
+            else
+            {
+                // Shares the options of a nested configuration that only one layer has
+                builder.add(*name, top);
+            }
+
+            for (size_t i : matching_layers)
+            {
+                ++positions[i];
+            }
+        }
+        return builder.build();
+    }
+
+private:
+    // The configurations at the same depth are built with the same builder so that its buffer is reused
+    Configuration::Builder& builderAt(size_t depth)
+    {
+        if (depth == m_builders.size())
+        {
+            m_builders.emplace_back(new Configuration::Builder(m_arena));
+        }
+        return *m_builders[depth];
+    }
+
+    ConfigurationArena* m_arena;
+    std::vector<std::unique_ptr<Configuration::Builder>> m_builders;
+};
+
+}
+
+LayeredConfiguration::LayeredConfiguration() noexcept
+{
+}
+
+LayeredConfiguration::LayeredConfiguration(std::vector<Configuration> layers)
+    : m_layers(std::move(layers))
+{
+}
+
+void LayeredConfiguration::push(Configuration layer)
+{
+    m_layers.push_back(std::move(layer));
+}
+
+void LayeredConfiguration::pop()
+{
+    m_layers.pop_back();
+}
+
+size_t LayeredConfiguration::layerCount() const noexcept
+{
+    return m_layers.size();
+}
+
+const Configuration& LayeredConfiguration::layer(size_t index) const
+{
+    return m_layers.at(index);
+}
+
+const Configuration::Value& LayeredConfiguration::value(boost::string_view name) const
+{
+    const Configuration::Value* result = valueOrNull(name);
+    if (!result)
+    {
+        throw std::out_of_range("LayeredConfiguration::value: option not found");
+    }
+    return *result;
+}
+
+const char* LayeredConfiguration::valueOrDefault(boost::string_view name, const char* default_value) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(name);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString().c_str()
+        : default_value);
+}
+
+const std::string& LayeredConfiguration::valueOrDefault(boost::string_view name,
+    const std::string& defaultValue) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(name);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString()
+        : defaultValue);
+}
+
+const Configuration::Value* LayeredConfiguration::valueOrNull(boost::string_view name) const noexcept
+{
+    for (size_t i = m_layers.size(); i > 0; --i)
+    {
+        const Configuration::Value* result = m_layers[i - 1].valueOrNull(name);
+        if (result)
+        {
+            return result;
+        }
+    }
+    return nullptr;
+}
+
+const Configuration::Value& LayeredConfiguration::value(const Configuration::Path& path) const
+{
+    const Configuration::Value* result = valueOrNull(path);
+    if (!result)
+    {
+        throw std::out_of_range("LayeredConfiguration::value: option not found");
+    }
+    return *result;
+}
+
+const char* LayeredConfiguration::valueOrDefault(const Configuration::Path& path,
+    const char* default_value) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(path);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString().c_str()
+        : default_value);
+}
+
+const std::string& LayeredConfiguration::valueOrDefault(const Configuration::Path& path,
+    const std::string& defaultValue) const noexcept
+{
+    const Configuration::Value* result = valueOrNull(path);
+    return ((result && (result->type() == Configuration::Value::Type::string)) ? result->asString()
+        : defaultValue);
+}
+
+const Configuration::Value* LayeredConfiguration::valueOrNull(const Configuration::Path& path) const noexcept
+{
+    for (size_t i = m_layers.size(); i > 0; --i)
+    {
+        const Configuration::Value* result = nullptr;
+        switch (Lookup(m_layers[i - 1], path, result))
+        {
+        case LookupResult::found:
+            return result;
+
+        case LookupResult::missing:
+            break;
+
+        case LookupResult::hidden:
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+LayeredConfiguration LayeredConfiguration::subtree(boost::string_view name) const
+{
+    return subtree(Configuration::Path(std::vector<std::string>(1, name.to_string())));
+}
+
+LayeredConfiguration LayeredConfiguration::subtree(const Configuration::Path& path) const
+{
+    std::vector<Configuration> layers;
+    for (size_t i = m_layers.size(); i > 0; --i)
+    {
+        const Configuration::Value* value = nullptr;
+        LookupResult result = Lookup(m_layers[i - 1], path, value);
+        if (result == LookupResult::missing)
+        {
+            continue;
+        }
+        if ((result == LookupResult::hidden) || (value->type() != Configuration::Value::Type::configuration))
+        {
+            break;
+        }
+        layers.push_back(value->asConfiguration());
+    }
+    return LayeredConfiguration(std::vector<Configuration>(layers.rbegin(), layers.rend()));
+}
+
+Configuration LayeredConfiguration::flatten(ConfigurationArena* arena) const
+{
+    std::vector<const Configuration*> layers;
+    layers.reserve(m_layers.size());
+    for (size_t i = m_layers.size(); i > 0; --i)
+    {
+        if (m_layers[i - 1].size() != 0)
+        {
+            layers.push_back(&m_layers[i - 1]);
+        }
+    }
+
+    if (layers.empty())
+    {
+        return Configuration(arena);
+    }
+    else if (layers.size() == 1)
+    {
+        return *layers[0];
+    }
+    else
+    {
+        LayerMerger merger(arena);
+        return merger.merge(layers, 0);
+    }
+}
@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "MemoryMappedFile.hpp"
+#include <system_error>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace Ishiko;
+
+#if defined(_WIN32)
+
+MemoryMappedFile::MemoryMappedFile(const std::string& file_path, Access access)
+    : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+{
+    m_file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL
+            | ((access == Access::sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS), nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        throw std::system_error(GetLastError(), std::system_category(),
+            "MemoryMappedFile: failed to open " + file_path);
+    }
+
+    // Pipes and devices report a size of 0, they would be taken for empty files
+    if (GetFileType(m_file) != FILE_TYPE_DISK)
+    {
+        CloseHandle(m_file);
+        throw std::system_error(ERROR_BAD_FILE_TYPE, std::system_category(),
+            "MemoryMappedFile: " + file_path + " is not a regular file");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size))
+    {
+        DWORD error = GetLastError();
+        CloseHandle(m_file);
+        throw std::system_error(error, std::system_category(), "MemoryMappedFile: failed to get size of " + file_path);
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0)
+    {
+        // Empty files can't be mapped
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+    {
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_data)
+    {
+        DWORD error = GetLastError();
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        CloseHandle(m_file);
+        throw std::system_error(error, std::system_category(), "MemoryMappedFile: failed to map " + file_path);
+    }
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+    CloseHandle(m_file);
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile(const std::string& file_path, Access access)
+    : m_data(nullptr), m_size(0)
+{
+    // Opening a FIFO for reading would wait for a writer without O_NONBLOCK, it has no effect on regular files
+    int file = open(file_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (file == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), "MemoryMappedFile: failed to open " + file_path);
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        int error = errno;
+        close(file);
+        throw std::system_error(error, std::generic_category(), "MemoryMappedFile: failed to get size of " + file_path);
+    }
+    // FIFOs and devices report a size of 0, they would be taken for empty files
+    if (!S_ISREG(status.st_mode))
+    {
+        close(file);
+        throw std::system_error(EINVAL, std::generic_category(),
+            "MemoryMappedFile: " + file_path + " is not a regular file");
+    }
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size == 0)
+    {
+        // Empty files can't be mapped
+        close(file);
+        return;
+    }
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    int error = errno;
+    // The mapping keeps a reference to the file
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        throw std::system_error(error, std::generic_category(), "MemoryMappedFile: failed to map " + file_path);
+    }
+    madvise(data, m_size, ((access == Access::sequential) ? MADV_SEQUENTIAL : MADV_RANDOM));
+    m_data = static_cast<const char*>(data);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#endif
+
+const char* MemoryMappedFile::data() const noexcept
+{
+    return m_data;
+}
+
+size_t MemoryMappedFile::size() const noexcept
+{
+    return m_size;
+}
+
+boost::string_view MemoryMappedFile::view() const noexcept
+{
+    return boost::string_view(m_data, m_size);
+}
@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "PerfectHashIndex.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// Finalizer from splitmix64, makes sure every bit of the input affects every bit of the output
+uint64_t Mix(uint64_t value) noexcept
+{
+    value ^= (value >> 30);
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= (value >> 27);
+    value *= 0x94D049BB133111EBULL;
+    value ^= (value >> 31);
+    return value;
+}
+
+size_t Bucket(uint64_t hash, size_t bucket_count) noexcept
+{
+    return static_cast<size_t>(hash % bucket_count);
+}
+
+size_t Slot(uint64_t hash, uint32_t displacement, size_t slot_count) noexcept
+{
+    return static_cast<size_t>(Mix(hash ^ (displacement * 0x9E3779B97F4A7C15ULL)) % slot_count);
+}
+
+}
+
+const size_t PerfectHashIndex::npos;
+
+PerfectHashIndex::PerfectHashIndex() noexcept
+    : m_seed(0)
+{
+}
+
+PerfectHashIndex::PerfectHashIndex(size_t key_count, const KeyHash& key_hash)
+    : m_seed(0)
+{
+    // A handful of seeds is always enough unless two keys have the same 64-bit hash for every seed, which means they
+    // are the same key
+    for (uint64_t seed = 1; seed <= 16; ++seed)
+    {
+        if (build(key_count, key_hash, seed))
+        {
+            return;
+        }
+    }
+    throw std::invalid_argument("PerfectHashIndex: keys are not distinct");
+}
+
+uint64_t PerfectHashIndex::Hash(boost::string_view key, uint64_t seed) noexcept
+{
+    return Hash(key, seed, 0);
+}
+
+uint64_t PerfectHashIndex::Hash(boost::string_view key, uint64_t seed, uint64_t previous_hash) noexcept
+{
+    // FNV-1a followed by a finalizer, the names we hash are short so this is good enough and has no alignment
+    // requirements
+    uint64_t result = (0xCBF29CE484222325ULL ^ Mix(seed + previous_hash));
+    for (char c : key)
+    {
+        result ^= static_cast<unsigned char>(c);
+        result *= 0x100000001B3ULL;
+    }
+    return Mix(result ^ key.size());
+}
+
+uint64_t PerfectHashIndex::seed() const noexcept
+{
+    return m_seed;
+}
+
+size_t PerfectHashIndex::find(uint64_t hash) const noexcept
+{
+    if (m_slots.empty())
+    {
+        return npos;
+    }
+    uint32_t displacement = m_displacements[Bucket(hash, m_displacements.size())];
+    return m_slots[Slot(hash, displacement, m_slots.size())];
+}
+
+bool PerfectHashIndex::build(size_t key_count, const KeyHash& key_hash, uint64_t seed)
+{
+    m_seed = seed;
+    m_displacements.clear();
+    m_slots.clear();
+    if (key_count == 0)
+    {
+        return true;
+    }
+
+    std::vector<uint64_t> hashes(key_count);
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        hashes[i] = key_hash(i, seed);
+    }
+
+    // Keys are spread over buckets of about 4 keys on average, then the buckets are placed from the largest to the
+    // smallest by searching for a displacement that sends all the keys of the bucket to free slots
+    size_t bucket_count = ((key_count + 3) / 4);
+    std::vector<std::vector<size_t>> buckets(bucket_count);
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        buckets[Bucket(hashes[i], bucket_count)].push_back(i);
+    }
+    std::vector<size_t> bucket_order(bucket_count);
+    for (size_t i = 0; i < bucket_count; ++i)
+    {
+        bucket_order[i] = i;
+    }
+    std::stable_sort(bucket_order.begin(), bucket_order.end(),
+        [&buckets](size_t lhs, size_t rhs)
+        {
+            return (buckets[lhs].size() > buckets[rhs].size());
+        });
+
+    m_displacements.assign(bucket_count, 0);
+    m_slots.assign(key_count, npos);
+    std::vector<size_t> bucket_slots;
+    for (size_t bucket : bucket_order)
+    {
+        const std::vector<size_t>& keys = buckets[bucket];
+        if (keys.empty())
+        {
+            break;
+        }
+
+        // Bounds the search, if no displacement works the caller tries again with another seed
+        const uint32_t max_displacement = static_cast<uint32_t>(std::min<size_t>(100 * key_count + 1000, UINT32_MAX));
+        bool placed = false;
+        for (uint32_t displacement = 0; (displacement < max_displacement) && !placed; ++displacement)
+        {
+            placed = true;
+            bucket_slots.clear();
+            for (size_t key : keys)
+            {
+                size_t slot = Slot(hashes[key], displacement, key_count);
+                if ((m_slots[slot] != npos)
+                    || (std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()))
+                {
+                    placed = false;
+                    break;
+                }
+                bucket_slots.push_back(slot);
+            }
+            if (placed)
+            {
+                m_displacements[bucket] = displacement;
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    m_slots[bucket_slots[i]] = keys[i];
+                }
+            }
+        }
+        if (!placed)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "BenchmarkHarness.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacing the global allocation functions lets the harness report the allocations made by the library itself
+// without any cooperation from it. The counters are atomic because some benchmarks run several threads.
+
+namespace
+{
+
+std::atomic<size_t> g_allocations(0);
+std::atomic<size_t> g_bytes(0);
+
+void* CountedAllocate(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    void* result = std::malloc((size == 0) ? 1 : size);
+    if (!result)
+    {
+        throw std::bad_alloc();
+    }
+    return result;
+}
+
+}
+
+size_t AllocationCounters::allocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounters::bytes()
+{
+    return g_bytes.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
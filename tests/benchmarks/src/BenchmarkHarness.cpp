@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "BenchmarkHarness.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+
+volatile size_t g_sink = 0;
+
+std::string EscapeJSONString(const std::string& value)
+{
+    std::string result;
+    for (char c : value)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            result.push_back('\\');
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+}
+
+BenchmarkHarness::BenchmarkHarness()
+    : m_minimum_time(std::chrono::milliseconds(200)), m_format(OutputFormat::text)
+{
+}
+
+bool BenchmarkHarness::parseArguments(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--filter=", 9) == 0)
+        {
+            m_filter = arg + 9;
+        }
+        else if (std::strncmp(arg, "--min-time-ms=", 14) == 0)
+        {
+            m_minimum_time = std::chrono::milliseconds(std::strtoul(arg + 14, nullptr, 10));
+        }
+        else if (std::strcmp(arg, "--format=text") == 0)
+        {
+            m_format = OutputFormat::text;
+        }
+        else if (std::strcmp(arg, "--format=json") == 0)
+        {
+            m_format = OutputFormat::json;
+        }
+        else if (std::strcmp(arg, "--format=csv") == 0)
+        {
+            m_format = OutputFormat::csv;
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--filter=<substring>] [--min-time-ms=<milliseconds>]"
+                " [--format=text|json|csv]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void BenchmarkHarness::add(const std::string& name, std::function<void()> operation)
+{
+    add(name, std::move(operation), std::function<void()>(), std::function<void()>());
+}
+
+void BenchmarkHarness::add(const std::string& name, std::function<void()> operation, std::function<void()> setup,
+    std::function<void()> teardown)
+{
+    m_benchmarks.push_back({name, std::move(operation), std::move(setup), std::move(teardown), 0});
+}
+
+void BenchmarkHarness::add(const std::string& name, std::function<void()> operation, size_t input_size)
+{
+    m_benchmarks.push_back({name, std::move(operation), std::function<void()>(), std::function<void()>(),
+        input_size});
+}
+
+int BenchmarkHarness::run(std::ostream& output)
+{
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : m_benchmarks)
+    {
+        if (benchmark.name.find(m_filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (benchmark.setup)
+        {
+            benchmark.setup();
+        }
+        results.push_back(measure(benchmark));
+        if (benchmark.teardown)
+        {
+            benchmark.teardown();
+        }
+        if (m_format == OutputFormat::text)
+        {
+            // Text output is written as we go because a full run takes a while
+            write(output, std::vector<Result>(1, results.back()));
+        }
+    }
+    if (m_format != OutputFormat::text)
+    {
+        write(output, results);
+    }
+    return 0;
+}
+
+void BenchmarkHarness::doNotOptimize(const void* value)
+{
+    g_sink = g_sink + reinterpret_cast<size_t>(value);
+}
+
+void BenchmarkHarness::doNotOptimize(size_t value)
+{
+    g_sink = g_sink + value;
+}
+
+BenchmarkHarness::Result BenchmarkHarness::measure(const Benchmark& benchmark) const
+{
+    const std::function<void()>& operation = benchmark.operation;
+
+    // Warm up caches and any lazily initialized state before timing anything
+    operation();
+
+    size_t iterations = 1;
+    while (true)
+    {
+        size_t allocations_before = AllocationCounters::allocations();
+        size_t bytes_before = AllocationCounters::bytes();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            operation();
+        }
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+        size_t allocations = AllocationCounters::allocations() - allocations_before;
+        size_t bytes = AllocationCounters::bytes() - bytes_before;
+
+        if ((elapsed >= m_minimum_time) || (iterations >= (size_t(1) << 40)))
+        {
+            Result result;
+            result.name = benchmark.name;
+            result.iterations = iterations;
+            result.nanoseconds_per_operation = double(elapsed.count()) / iterations;
+            result.allocations_per_operation = double(allocations) / iterations;
+            result.bytes_per_operation = double(bytes) / iterations;
+            result.megabytes_per_second = 0;
+            if ((benchmark.input_size != 0) && (elapsed.count() > 0))
+            {
+                result.megabytes_per_second = (1000.0 * benchmark.input_size * iterations / elapsed.count());
+            }
+            return result;
+        }
+
+        // Aim slightly past the minimum time based on the last run but grow at most tenfold per round
+        size_t next = iterations * 10;
+        if (elapsed.count() > 0)
+        {
+            double estimate = 1.2 * iterations * m_minimum_time.count() / elapsed.count();
+            if (estimate < next)
+            {
+                next = size_t(estimate);
+            }
+        }
+        iterations = (next > iterations) ? next : (iterations + 1);
+    }
+}
+
+void BenchmarkHarness::write(std::ostream& output, const std::vector<Result>& results) const
+{
+    switch (m_format)
+    {
+    case OutputFormat::text:
+        for (const Result& result : results)
+        {
+            output << std::left << std::setw(64) << result.name << std::right
+                << std::setw(14) << std::fixed << std::setprecision(1) << result.nanoseconds_per_operation << " ns/op"
+                << std::setw(12) << std::setprecision(2) << result.allocations_per_operation << " allocs/op"
+                << std::setw(14) << std::setprecision(1) << result.bytes_per_operation << " B/op"
+                << std::setw(12) << result.iterations << " iterations";
+            if (result.megabytes_per_second != 0)
+            {
+                output << std::setw(12) << std::setprecision(1) << result.megabytes_per_second << " MB/s";
+            }
+            output << std::endl;
+        }
+        break;
+
+    case OutputFormat::json:
+        output << "[" << std::endl;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            output << "  {\"name\": \"" << EscapeJSONString(result.name) << "\""
+                << ", \"iterations\": " << result.iterations
+                << std::fixed << std::setprecision(3)
+                << ", \"ns_per_op\": " << result.nanoseconds_per_operation
+                << ", \"allocs_per_op\": " << result.allocations_per_operation
+                << ", \"bytes_per_op\": " << result.bytes_per_operation
+                << ", \"mb_per_s\": " << result.megabytes_per_second << "}"
+                << ((i + 1 < results.size()) ? "," : "") << std::endl;
+        }
+        output << "]" << std::endl;
+        break;
+
+    case OutputFormat::csv:
+        output << "name,iterations,ns_per_op,allocs_per_op,bytes_per_op,mb_per_s" << std::endl;
+        for (const Result& result : results)
+        {
+            output << "\"" << result.name << "\"," << result.iterations << std::fixed << std::setprecision(3)
+                << "," << result.nanoseconds_per_operation << "," << result.allocations_per_operation
+                << "," << result.bytes_per_operation << "," << result.megabytes_per_second << std::endl;
+        }
+        break;
+    }
+}
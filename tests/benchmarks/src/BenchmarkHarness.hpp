@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_BENCHMARKS_BENCHMARKHARNESS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_BENCHMARKS_BENCHMARKHARNESS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark runner. Each benchmark is a callable executing one operation, the harness repeats it until
+// the minimum measurement time has elapsed and reports the time, the number of heap allocations and the number of
+// bytes allocated per operation, and the throughput for the benchmarks that process an input. Allocations are counted
+// by the global operator new replacement in AllocationCounters.cpp.
+class BenchmarkHarness
+{
+public:
+    enum class OutputFormat
+    {
+        text,
+        json,
+        csv
+    };
+
+    struct Result
+    {
+        std::string name;
+        size_t iterations;
+        double nanoseconds_per_operation;
+        double allocations_per_operation;
+        double bytes_per_operation;
+        // 0 if the benchmark doesn't process an input
+        double megabytes_per_second;
+    };
+
+    BenchmarkHarness();
+
+    // Recognizes --filter=<substring>, --min-time-ms=<milliseconds> and --format=text|json|csv.
+    bool parseArguments(int argc, char* argv[]);
+
+    void add(const std::string& name, std::function<void()> operation);
+    // The setup and teardown functions are called before and after the benchmark is measured, for instance to start
+    // and stop background threads that should only run while this benchmark does
+    void add(const std::string& name, std::function<void()> operation, std::function<void()> setup,
+        std::function<void()> teardown);
+    // Each operation processes input_size bytes, for instance parses a file of that size
+    void add(const std::string& name, std::function<void()> operation, size_t input_size);
+
+    int run(std::ostream& output);
+
+    static void doNotOptimize(const void* value);
+    static void doNotOptimize(size_t value);
+
+private:
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void()> operation;
+        std::function<void()> setup;
+        std::function<void()> teardown;
+        size_t input_size;
+    };
+
+    Result measure(const Benchmark& benchmark) const;
+    void write(std::ostream& output, const std::vector<Result>& results) const;
+
+    std::vector<Benchmark> m_benchmarks;
+    std::string m_filter;
+    std::chrono::nanoseconds m_minimum_time;
+    OutputFormat m_format;
+};
+
+struct AllocationCounters
+{
+    static size_t allocations();
+    static size_t bytes();
+};
+
+#endif
@@ -0,0 +1,274 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CommandLineParserBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// Specification is either a CommandLineSpecification or a CompiledCommandLineSpecification
+template<typename Specification>
+struct ParseFixture
+{
+    ParseFixture(const CommandLineSpecification& specification, SyntheticData::Arguments arguments)
+        : specification(specification), arguments(std::move(arguments))
+    {
+    }
+
+    Specification specification;
+    SyntheticData::Arguments arguments;
+    Configuration configuration;
+};
+
+typedef ParseFixture<CommandLineSpecification> MapParseFixture;
+typedef ParseFixture<CompiledCommandLineSpecification> CompiledParseFixture;
+
+template<typename Specification>
+void AddParseBenchmark(BenchmarkHarness& harness, const std::string& name,
+    std::shared_ptr<ParseFixture<Specification>> fixture)
+{
+    harness.add(name,
+        [fixture]()
+        {
+            Configuration configuration;
+            CommandLineParser::parse(fixture->specification, fixture->arguments.argc(), fixture->arguments.argv(),
+                configuration);
+            BenchmarkHarness::doNotOptimize(configuration.size());
+        });
+}
+
+// Parses repeatedly into the same configuration which already holds all the keys, this isolates the cost of the
+// parser itself from the cost of inserting new keys in the configuration
+template<typename Specification>
+void AddReparseBenchmark(BenchmarkHarness& harness, const std::string& name,
+    std::shared_ptr<ParseFixture<Specification>> fixture)
+{
+    fixture->configuration = fixture->specification.createDefaultConfiguration();
+    harness.add(name,
+        [fixture]()
+        {
+            CommandLineParser::parse(fixture->specification, fixture->arguments.argc(), fixture->arguments.argv(),
+                fixture->configuration);
+            BenchmarkHarness::doNotOptimize(fixture->configuration.size());
+        });
+}
+
+// What each parse costs without a session: a fresh default configuration that the arguments are parsed into
+template<typename Specification>
+void AddParseWithDefaultsBenchmark(BenchmarkHarness& harness, const std::string& name,
+    std::shared_ptr<ParseFixture<Specification>> fixture)
+{
+    harness.add(name,
+        [fixture]()
+        {
+            Configuration configuration = fixture->specification.createDefaultConfiguration();
+            CommandLineParser::parse(fixture->specification, fixture->arguments.argc(), fixture->arguments.argv(),
+                configuration);
+            BenchmarkHarness::doNotOptimize(configuration.size());
+        });
+}
+
+// The same as above with the defaults read through a view on the specification instead of copied. One option is read,
+// from its default if it wasn't set on the command line.
+void AddParseWithDefaultedViewBenchmark(BenchmarkHarness& harness, const std::string& name,
+    std::shared_ptr<CompiledParseFixture> fixture, size_t option_count)
+{
+    std::shared_ptr<std::string> unset_option =
+        std::make_shared<std::string>(SyntheticData::OptionName(option_count - 1));
+    harness.add(name,
+        [fixture, unset_option]()
+        {
+            Configuration parsed;
+            CommandLineParser::parse(fixture->specification, fixture->arguments.argc(), fixture->arguments.argv(),
+                parsed);
+            DefaultedConfiguration configuration(fixture->specification, std::move(parsed));
+            BenchmarkHarness::doNotOptimize(configuration.value(*unset_option).asString().size());
+        });
+}
+
+// Command lines of 16 arguments each, as they would be replayed from a log
+struct BatchFixture
+{
+    BatchFixture(size_t option_count, size_t command_line_count)
+        : specification(SyntheticData::CreateNamedOptionsSpecification(option_count)),
+        arguments(SyntheticData::CreateNamedOptionArguments(option_count, 16 * command_line_count).arguments())
+    {
+        // arguments[0] is the executable name which every command line shares
+        for (size_t i = 0; i < command_line_count; ++i)
+        {
+            command_lines.emplace_back(1, arguments[0].c_str());
+            for (size_t j = 0; j < 16; ++j)
+            {
+                command_lines.back().push_back(arguments[1 + (16 * i) + j].c_str());
+            }
+        }
+    }
+
+    CompiledCommandLineSpecification specification;
+    std::vector<std::string> arguments;
+    std::vector<std::vector<const char*>> command_lines;
+};
+
+// Parses repeatedly with the same session, after the first iterations the storage has reached its steady state
+void AddSessionBenchmark(BenchmarkHarness& harness, const std::string& name,
+    const CommandLineSpecification& specification, SyntheticData::Arguments arguments)
+{
+    std::shared_ptr<CommandLineParser::Session> session = std::make_shared<CommandLineParser::Session>(specification);
+    std::shared_ptr<SyntheticData::Arguments> session_arguments =
+        std::make_shared<SyntheticData::Arguments>(std::move(arguments));
+    harness.add(name,
+        [session, session_arguments]()
+        {
+            const Configuration& configuration = session->parse(session_arguments->argc(), session_arguments->argv());
+            BenchmarkHarness::doNotOptimize(configuration.size());
+        });
+}
+
+}
+
+// The arguments are written to a response file, one per line, and the command line only names that file
+struct ResponseFileFixture
+{
+    ResponseFileFixture(const CommandLineSpecification& specification, const SyntheticData::Arguments& arguments,
+        const std::string& file_path)
+        : specification(specification), file_path(file_path), arguments({"@" + file_path})
+    {
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        for (size_t i = 1; i < arguments.arguments().size(); ++i)
+        {
+            file << arguments.arguments()[i] << '\n';
+        }
+    }
+
+    ~ResponseFileFixture()
+    {
+        std::remove(file_path.c_str());
+    }
+
+    CompiledCommandLineSpecification specification;
+    std::string file_path;
+    SyntheticData::Arguments arguments;
+};
+
+void AddCommandLineParserBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t option_count : {10, 1000, 10000})
+    {
+        AddParseBenchmark(harness,
+            "CommandLineParser::parse named options=" + std::to_string(option_count) + " args=16",
+            std::make_shared<MapParseFixture>(SyntheticData::CreateNamedOptionsSpecification(option_count),
+                SyntheticData::CreateNamedOptionArguments(option_count, 16)));
+    }
+
+    AddParseBenchmark(harness, "CommandLineParser::parse short options=1000 args=16",
+        std::make_shared<MapParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000),
+            SyntheticData::CreateShortOptionArguments(1000, 16)));
+
+    for (size_t argument_count : {1000, 10000})
+    {
+        AddParseBenchmark(harness,
+            "CommandLineParser::parse long argv options=1000 args=" + std::to_string(argument_count),
+            std::make_shared<MapParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000),
+                SyntheticData::CreateNamedOptionArguments(1000, argument_count)));
+    }
+
+    for (size_t depth : {2, 8})
+    {
+        AddParseBenchmark(harness,
+            "CommandLineParser::parse command tree depth=" + std::to_string(depth) + " breadth=3",
+            std::make_shared<MapParseFixture>(SyntheticData::CreateCommandTreeSpecification(depth, 3),
+                SyntheticData::CreateCommandTreeArguments(depth, 3)));
+        AddParseBenchmark(harness,
+            "CommandLineParser::parse compiled command tree depth=" + std::to_string(depth) + " breadth=3",
+            std::make_shared<CompiledParseFixture>(SyntheticData::CreateCommandTreeSpecification(depth, 3),
+                SyntheticData::CreateCommandTreeArguments(depth, 3)));
+    }
+
+    for (size_t option_count : {10, 1000, 10000})
+    {
+        AddParseBenchmark(harness,
+            "CommandLineParser::parse compiled named options=" + std::to_string(option_count) + " args=16",
+            std::make_shared<CompiledParseFixture>(SyntheticData::CreateNamedOptionsSpecification(option_count),
+                SyntheticData::CreateNamedOptionArguments(option_count, 16)));
+    }
+
+    AddParseBenchmark(harness, "CommandLineParser::parse compiled short options=1000 args=16",
+        std::make_shared<CompiledParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000),
+            SyntheticData::CreateShortOptionArguments(1000, 16)));
+
+    AddReparseBenchmark(harness, "CommandLineParser::parse toggles into populated configuration options=1000 args=16",
+        std::make_shared<MapParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000),
+            SyntheticData::CreateToggleArguments(1000, 16)));
+
+    AddReparseBenchmark(harness,
+        "CommandLineParser::parse compiled toggles into populated configuration options=1000 args=16",
+        std::make_shared<CompiledParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000),
+            SyntheticData::CreateToggleArguments(1000, 16)));
+
+    AddReparseBenchmark(harness, "CommandLineParser::parse unmatched arguments args=16",
+        std::make_shared<MapParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000),
+            SyntheticData::CreateUnmatchedArguments(16)));
+
+    // The same command lines as the parse benchmarks above, including creating the default configuration each time,
+    // versus a session that reuses its storage
+    for (size_t option_count : {10, 1000})
+    {
+        AddParseWithDefaultsBenchmark(harness,
+            "CommandLineParser::parse compiled with defaults options=" + std::to_string(option_count) + " args=16",
+            std::make_shared<CompiledParseFixture>(SyntheticData::CreateNamedOptionsSpecification(option_count),
+                SyntheticData::CreateNamedOptionArguments(option_count, 16)));
+        AddParseWithDefaultedViewBenchmark(harness,
+            "CommandLineParser::parse compiled with DefaultedConfiguration options=" + std::to_string(option_count)
+                + " args=16",
+            std::make_shared<CompiledParseFixture>(SyntheticData::CreateNamedOptionsSpecification(option_count),
+                SyntheticData::CreateNamedOptionArguments(option_count, 16)),
+            option_count);
+        AddSessionBenchmark(harness,
+            "CommandLineParser::Session::parse options=" + std::to_string(option_count) + " args=16",
+            SyntheticData::CreateNamedOptionsSpecification(option_count),
+            SyntheticData::CreateNamedOptionArguments(option_count, 16));
+    }
+
+    // The same arguments in argv and in a response file
+    for (size_t argument_count : {10000, 100000})
+    {
+        SyntheticData::Arguments arguments = SyntheticData::CreateNamedOptionArguments(1000, argument_count);
+        AddParseBenchmark(harness,
+            "CommandLineParser::parse compiled long argv options=1000 args=" + std::to_string(argument_count),
+            std::make_shared<CompiledParseFixture>(SyntheticData::CreateNamedOptionsSpecification(1000), arguments));
+
+        std::shared_ptr<ResponseFileFixture> fixture =
+            std::make_shared<ResponseFileFixture>(SyntheticData::CreateNamedOptionsSpecification(1000), arguments,
+                "CommandLineParserBenchmarks_" + std::to_string(argument_count) + ".rsp");
+        harness.add(
+            "CommandLineParser::parse compiled response file options=1000 args=" + std::to_string(argument_count),
+            [fixture]()
+            {
+                Configuration configuration;
+                CommandLineParser::parse(fixture->specification, fixture->arguments.argc(),
+                    fixture->arguments.argv(), configuration, CommandLineParser::ResponseFiles::enabled);
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            });
+    }
+
+    // Scaling with the number of threads, the time per operation is the time to parse the whole batch
+    std::shared_ptr<BatchFixture> batch_fixture = std::make_shared<BatchFixture>(1000, 10000);
+    for (size_t thread_count : {1, 2, 4, 8})
+    {
+        harness.add("CommandLineParser::parseBatch command lines=10000 threads=" + std::to_string(thread_count),
+            [batch_fixture, thread_count]()
+            {
+                std::vector<Configuration> configurations = CommandLineParser::parseBatch(
+                    batch_fixture->specification, batch_fixture->command_lines, thread_count);
+                BenchmarkHarness::doNotOptimize(configurations.size());
+            });
+    }
+}
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CommandLineSpecificationBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <memory>
+
+using namespace Ishiko;
+
+namespace
+{
+
+struct LookupFixture
+{
+    LookupFixture(size_t option_count)
+        : specification(SyntheticData::CreateNamedOptionsSpecification(option_count)),
+        compiled_specification(specification), next(0)
+    {
+        for (size_t index : SyntheticData::CreateIndices(option_count, 1024))
+        {
+            names.push_back(SyntheticData::OptionName(index));
+            short_names.push_back(SyntheticData::ShortOptionName(index));
+        }
+    }
+
+    const std::string& nextName()
+    {
+        return names[next++ % names.size()];
+    }
+
+    const std::string& nextShortName()
+    {
+        return short_names[next++ % short_names.size()];
+    }
+
+    CommandLineSpecification specification;
+    CompiledCommandLineSpecification compiled_specification;
+    std::vector<std::string> names;
+    std::vector<std::string> short_names;
+    size_t next;
+};
+
+// The commands on the deepest path of a command tree
+struct CommandLookupFixture
+{
+    CommandLookupFixture(size_t depth, size_t breadth)
+        : specification(SyntheticData::CreateCommandTreeSpecification(depth, breadth)),
+        compiled_specification(specification)
+    {
+        SyntheticData::Arguments arguments = SyntheticData::CreateCommandTreeArguments(depth, breadth);
+        // Skip the executable name
+        command_names.assign(arguments.arguments().begin() + 1, arguments.arguments().end());
+    }
+
+    CommandLineSpecification specification;
+    CompiledCommandLineSpecification compiled_specification;
+    std::vector<std::string> command_names;
+};
+
+}
+
+void AddCommandLineSpecificationBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t option_count : {10, 1000, 10000})
+    {
+        std::shared_ptr<CommandLineSpecification> specification =
+            std::make_shared<CommandLineSpecification>(SyntheticData::CreateNamedOptionsSpecification(option_count));
+        harness.add("CommandLineSpecification::createDefaultConfiguration options=" + std::to_string(option_count),
+            [specification]()
+            {
+                Configuration configuration = specification->createDefaultConfiguration();
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            });
+    }
+
+    for (size_t option_count : {10, 1000, 10000})
+    {
+        std::shared_ptr<LookupFixture> fixture = std::make_shared<LookupFixture>(option_count);
+        harness.add("CommandLineSpecification::findNamedOption options=" + std::to_string(option_count),
+            [fixture]()
+            {
+                CommandLineSpecification::OptionDetails details;
+                bool found = fixture->specification.findNamedOption(fixture->nextName(), details);
+                BenchmarkHarness::doNotOptimize(found);
+            });
+        harness.add("CompiledCommandLineSpecification::findNamedOption options=" + std::to_string(option_count),
+            [fixture]()
+            {
+                BenchmarkHarness::doNotOptimize(fixture->compiled_specification.findNamedOption(fixture->nextName()));
+            });
+    }
+
+    for (size_t option_count : {1000, 10000})
+    {
+        std::shared_ptr<LookupFixture> fixture = std::make_shared<LookupFixture>(option_count);
+        harness.add("CommandLineSpecification::findShortNamedOption options=" + std::to_string(option_count),
+            [fixture]()
+            {
+                const std::string* name = nullptr;
+                const CommandLineSpecification::OptionDetails* details = nullptr;
+                bool found = fixture->specification.findShortNamedOption(fixture->nextShortName(), name, details);
+                BenchmarkHarness::doNotOptimize(found);
+            });
+        harness.add("CompiledCommandLineSpecification::findShortNamedOption options=" + std::to_string(option_count),
+            [fixture]()
+            {
+                BenchmarkHarness::doNotOptimize(
+                    fixture->compiled_specification.findShortNamedOption(fixture->nextShortName()));
+            });
+    }
+
+    for (size_t value_count : {10, 500})
+    {
+        std::shared_ptr<CommandLineSpecification::OptionDetails> details =
+            std::make_shared<CommandLineSpecification::OptionDetails>(CommandLineSpecification::OptionType::single_value);
+        std::vector<std::string> values;
+        for (size_t i = 0; i < value_count; ++i)
+        {
+            values.push_back(SyntheticData::KeyName(i));
+        }
+        details->setAllowedValues(values, CommandLineSpecification::CaseSensitivity::insensitive);
+        // The last value is the worst case for a linear search
+        std::string value = values.back();
+        harness.add("OptionDetails::isValueAllowed case insensitive values=" + std::to_string(value_count),
+            [details, value]()
+            {
+                BenchmarkHarness::doNotOptimize(details->isValueAllowed(value));
+            });
+    }
+
+    std::shared_ptr<CommandLineSpecification::OptionDetails> range_details =
+        std::make_shared<CommandLineSpecification::OptionDetails>(CommandLineSpecification::OptionType::single_value);
+    range_details->setAllowedRange(1, 65535);
+    harness.add("OptionDetails::isValueAllowed range",
+        [range_details]()
+        {
+            BenchmarkHarness::doNotOptimize(range_details->isValueAllowed("8080"));
+        });
+
+    std::shared_ptr<CommandLookupFixture> command_fixture = std::make_shared<CommandLookupFixture>(8, 3);
+    harness.add("CommandLineSpecification::findCommand depth=8 breadth=3",
+        [command_fixture]()
+        {
+            // The map based specification only knows the top-level commands
+            const CommandLineSpecification::CommandDetails* details = nullptr;
+            bool found = command_fixture->specification.findCommand("command", command_fixture->command_names[0],
+                details);
+            BenchmarkHarness::doNotOptimize(found);
+        });
+    harness.add("CompiledCommandLineSpecification::findCommand depth=8 breadth=3",
+        [command_fixture]()
+        {
+            const CompiledCommandLineSpecification& specification = command_fixture->compiled_specification;
+            const CompiledCommandLineSpecification::Command* command =
+                specification.findCommand(specification.root(), "command", command_fixture->command_names[0]);
+            BenchmarkHarness::doNotOptimize(command);
+        });
+}
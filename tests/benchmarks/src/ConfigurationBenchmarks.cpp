@@ -0,0 +1,266 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <map>
+#include <memory>
+
+using namespace Ishiko;
+
+namespace
+{
+
+struct LookupFixture
+{
+    LookupFixture(size_t key_count)
+        : configuration(SyntheticData::CreateFlatConfiguration(key_count)), next(0)
+    {
+        for (size_t index : SyntheticData::CreateIndices(key_count, 1024))
+        {
+            hits.push_back(SyntheticData::KeyName(index));
+            misses.push_back(SyntheticData::KeyName(index) + "-missing");
+        }
+    }
+
+    Configuration configuration;
+    std::vector<std::string> hits;
+    std::vector<std::string> misses;
+    size_t next;
+};
+
+}
+
+void AddConfigurationBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t key_count : {10, 1000, 100000})
+    {
+        std::shared_ptr<LookupFixture> fixture = std::make_shared<LookupFixture>(key_count);
+        std::string suffix = " keys=" + std::to_string(key_count);
+
+        harness.add("Configuration::valueOrDefault hit" + suffix,
+            [fixture]()
+            {
+                static const std::string default_value;
+                const std::string& value = fixture->configuration.valueOrDefault(
+                    fixture->hits[fixture->next++ % fixture->hits.size()], default_value);
+                BenchmarkHarness::doNotOptimize(value.size());
+            });
+
+        harness.add("Configuration::valueOrDefault miss" + suffix,
+            [fixture]()
+            {
+                const char* value = fixture->configuration.valueOrDefault(
+                    fixture->misses[fixture->next++ % fixture->misses.size()], "default");
+                BenchmarkHarness::doNotOptimize(value);
+            });
+
+        harness.add("Configuration::valueOrDefault literal" + suffix,
+            [fixture]()
+            {
+                const char* value = fixture->configuration.valueOrDefault("key-000000", "default");
+                BenchmarkHarness::doNotOptimize(value);
+            });
+
+        // The same literal name every time, resolved once by the key
+        std::shared_ptr<Configuration::Key> key = std::make_shared<Configuration::Key>("key-000000");
+        harness.add("Configuration::valueOrDefault key" + suffix,
+            [fixture, key]()
+            {
+                const char* value = fixture->configuration.valueOrDefault(*key, "default");
+                BenchmarkHarness::doNotOptimize(value);
+            });
+
+        harness.add("Configuration::valueOrDefault string_view" + suffix,
+            [fixture]()
+            {
+                const std::string& name = fixture->hits[fixture->next++ % fixture->hits.size()];
+                // A view on a larger buffer, as a parser would produce
+                boost::string_view view(name.data(), name.size());
+                const char* value = fixture->configuration.valueOrDefault(view, "default");
+                BenchmarkHarness::doNotOptimize(value);
+            });
+
+        harness.add("Configuration::set insert" + suffix,
+            [key_count]()
+            {
+                Configuration configuration = SyntheticData::CreateFlatConfiguration(key_count);
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            });
+    }
+
+    // Inserting in reverse order is the worst case for the sorted storage, every insertion shifts all the options so
+    // the total cost is quadratic. The std::map baseline shows how much is lost compared to a tree when options are
+    // set one at a time out of order, Configuration::Builder avoids this. At 100k keys a single iteration takes close
+    // to a minute, use --filter to leave it out.
+    for (size_t key_count : {10, 1000, 100000})
+    {
+        std::shared_ptr<std::vector<std::string>> names = std::make_shared<std::vector<std::string>>();
+        for (size_t i = key_count; i > 0; --i)
+        {
+            names->push_back(SyntheticData::KeyName(i - 1));
+        }
+        harness.add("Configuration::set insert reverse order keys=" + std::to_string(key_count),
+            [names]()
+            {
+                Configuration configuration;
+                for (const std::string& name : *names)
+                {
+                    configuration.set(name, name);
+                }
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            });
+        harness.add("std::map insert reverse order keys=" + std::to_string(key_count),
+            [names]()
+            {
+                std::map<std::string, std::string> map;
+                for (const std::string& name : *names)
+                {
+                    map[name] = name;
+                }
+                BenchmarkHarness::doNotOptimize(map.size());
+            });
+    }
+
+    // Building a string array and storing it by copy versus by move, the move doesn't copy the strings a second time
+    std::shared_ptr<std::vector<std::string>> values = std::make_shared<std::vector<std::string>>();
+    for (size_t i = 0; i < 64; ++i)
+    {
+        values->push_back(SyntheticData::KeyName(i) + " with a value too long for the small string buffer");
+    }
+    harness.add("Configuration::set string array copy size=64",
+        [values]()
+        {
+            std::vector<std::string> built_values = *values;
+            Configuration configuration;
+            configuration.set("values", built_values);
+            BenchmarkHarness::doNotOptimize(configuration.size());
+        });
+    harness.add("Configuration::set string array move size=64",
+        [values]()
+        {
+            std::vector<std::string> built_values = *values;
+            Configuration configuration;
+            configuration.set("values", std::move(built_values));
+            BenchmarkHarness::doNotOptimize(configuration.size());
+        });
+
+    // Reading a number stored as a string versus stored as an integer when it was set
+    std::shared_ptr<Configuration> typed_configuration = std::make_shared<Configuration>();
+    typed_configuration->set("port-string", "8080");
+    typed_configuration->set("port", Configuration::Value(int64_t(8080)));
+    harness.add("Configuration::Value parse string on read",
+        [typed_configuration]()
+        {
+            BenchmarkHarness::doNotOptimize(
+                static_cast<size_t>(std::stoll(typed_configuration->value("port-string").asString())));
+        });
+    harness.add("Configuration::Value asInt",
+        [typed_configuration]()
+        {
+            BenchmarkHarness::doNotOptimize(static_cast<size_t>(typed_configuration->value("port").asInt()));
+        });
+
+    for (size_t depth : {2, 8})
+    {
+        std::shared_ptr<Configuration> configuration =
+            std::make_shared<Configuration>(SyntheticData::CreateNestedConfiguration(depth, 16));
+        std::string suffix = " depth=" + std::to_string(depth) + " breadth=16";
+
+        harness.add("Configuration::value nested" + suffix,
+            [configuration, depth]()
+            {
+                const Configuration* current = configuration.get();
+                for (size_t i = 1; i < depth; ++i)
+                {
+                    current = &current->value("child").asConfiguration();
+                }
+                BenchmarkHarness::doNotOptimize(current->value("key-000007").asString().size());
+            });
+
+        std::string path_string;
+        for (size_t i = 1; i < depth; ++i)
+        {
+            path_string += "child.";
+        }
+        path_string += "key-000007";
+        std::shared_ptr<Configuration::Path> path = std::make_shared<Configuration::Path>(path_string);
+        harness.add("Configuration::value path" + suffix,
+            [configuration, path]()
+            {
+                BenchmarkHarness::doNotOptimize(configuration->value(*path).asString().size());
+            });
+
+        harness.add("Configuration copy nested" + suffix,
+            [configuration]()
+            {
+                Configuration copy = *configuration;
+                BenchmarkHarness::doNotOptimize(copy.size());
+            });
+
+        // Only the configurations on the path to the modified option are duplicated
+        harness.add("Configuration copy and modify nested" + suffix,
+            [configuration, path]()
+            {
+                Configuration copy = *configuration;
+                copy.value(*path) = Configuration::Value("modified");
+                BenchmarkHarness::doNotOptimize(copy.size());
+            });
+    }
+
+    // A short-lived per-request overlay built on the heap versus in an arena that is released after each request
+    std::shared_ptr<std::vector<Configuration::Path>> overlay_paths =
+        std::make_shared<std::vector<Configuration::Path>>();
+    for (size_t i = 0; i < 32; ++i)
+    {
+        overlay_paths->emplace_back("section-" + std::to_string(i % 4) + "." + SyntheticData::KeyName(i));
+    }
+    harness.add("Configuration overlay heap keys=32",
+        [overlay_paths]()
+        {
+            Configuration configuration;
+            for (const Configuration::Path& path : *overlay_paths)
+            {
+                configuration.set(path, "value");
+            }
+            BenchmarkHarness::doNotOptimize(configuration.size());
+        });
+    std::shared_ptr<ConfigurationArena> arena = std::make_shared<ConfigurationArena>();
+    harness.add("Configuration overlay arena keys=32",
+        [overlay_paths, arena]()
+        {
+            {
+                Configuration configuration(arena.get());
+                for (const Configuration::Path& path : *overlay_paths)
+                {
+                    configuration.set(path, "value");
+                }
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            }
+            arena->release();
+        });
+
+    // Diffing a reloaded configuration that shares its unchanged sections with the previous one versus one that was
+    // built independently and has to be compared option by option
+    std::shared_ptr<Configuration> from = std::make_shared<Configuration>();
+    std::shared_ptr<Configuration> rebuilt = std::make_shared<Configuration>();
+    for (size_t i = 0; i < 64; ++i)
+    {
+        std::string section = "section-" + std::to_string(i);
+        from->set(section, SyntheticData::CreateFlatConfiguration(64));
+        rebuilt->set(section, SyntheticData::CreateFlatConfiguration(64));
+    }
+    std::shared_ptr<Configuration> modified = std::make_shared<Configuration>(*from);
+    modified->set(Configuration::Path("section-7." + SyntheticData::KeyName(7)), "modified");
+    rebuilt->set(Configuration::Path("section-7." + SyntheticData::KeyName(7)), "modified");
+    harness.add("ConfigurationPatch::Diff shared sections=64 keys=64",
+        [from, modified]()
+        {
+            BenchmarkHarness::doNotOptimize(ConfigurationPatch::Diff(*from, *modified).changes().size());
+        });
+    harness.add("ConfigurationPatch::Diff unshared sections=64 keys=64",
+        [from, rebuilt]()
+        {
+            BenchmarkHarness::doNotOptimize(ConfigurationPatch::Diff(*from, *rebuilt).changes().size());
+        });
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationSnapshotBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// The file is deleted once the benchmarks that use it are destroyed
+std::shared_ptr<std::string> CreateFile(const std::string& file_path, const std::string& content)
+{
+    {
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+    return std::shared_ptr<std::string>(new std::string(file_path),
+        [](std::string* file_path)
+        {
+            std::remove(file_path->c_str());
+            delete file_path;
+        });
+}
+
+}
+
+void AddConfigurationSnapshotBenchmarks(BenchmarkHarness& harness)
+{
+    // Startup: loading a large configuration and reading a few options from it, the files are in the page cache
+    std::string document = SyntheticData::CreateJSONDocument(2048, 64, true);
+    Configuration configuration;
+    JSONConfigurationParser::parse(document, configuration);
+
+    std::shared_ptr<std::string> json_file = CreateFile("ConfigurationSnapshotBenchmarks.json", document);
+    std::shared_ptr<std::string> snapshot_file = CreateFile("ConfigurationSnapshotBenchmarks.snapshot",
+        ConfigurationSnapshot::Compile(configuration));
+
+    std::shared_ptr<std::vector<Configuration::Path>> paths = std::make_shared<std::vector<Configuration::Path>>();
+    for (size_t index : SyntheticData::CreateIndices(2048, 16))
+    {
+        paths->emplace_back("section-" + std::to_string(index) + "." + SyntheticData::KeyName(4));
+    }
+
+    harness.add("JSONConfigurationParser::parseFile startup sections=2048 keys=64 lookups=16",
+        [json_file, paths]()
+        {
+            Configuration configuration;
+            JSONConfigurationParser::parseFile(*json_file, configuration);
+            for (const Configuration::Path& path : *paths)
+            {
+                BenchmarkHarness::doNotOptimize(configuration.value(path).asString().size());
+            }
+        });
+
+    harness.add("ConfigurationSnapshot startup sections=2048 keys=64 lookups=16",
+        [snapshot_file, paths]()
+        {
+            ConfigurationSnapshot snapshot(*snapshot_file);
+            for (const Configuration::Path& path : *paths)
+            {
+                BenchmarkHarness::doNotOptimize(snapshot.value(path).asString().size());
+            }
+        });
+
+    harness.add("ConfigurationSnapshot::Compile sections=2048 keys=64",
+        [configuration]()
+        {
+            BenchmarkHarness::doNotOptimize(ConfigurationSnapshot::Compile(configuration).size());
+        });
+
+    // The same lookup as the "Configuration::value path" benchmark
+    std::shared_ptr<std::string> nested_file = CreateFile("ConfigurationSnapshotBenchmarks_nested.snapshot",
+        ConfigurationSnapshot::Compile(SyntheticData::CreateNestedConfiguration(8, 16)));
+    std::shared_ptr<ConfigurationSnapshot> nested_snapshot = std::make_shared<ConfigurationSnapshot>(*nested_file);
+    std::shared_ptr<Configuration::Path> path =
+        std::make_shared<Configuration::Path>("child.child.child.child.child.child.child.key-000007");
+    harness.add("ConfigurationSnapshot::value path depth=8 breadth=16",
+        [nested_file, nested_snapshot, path]()
+        {
+            BenchmarkHarness::doNotOptimize(nested_snapshot->value(*path).asString().size());
+        });
+}
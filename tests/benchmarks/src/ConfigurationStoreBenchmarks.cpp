@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationStoreBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// A store read by the benchmark thread while background threads read it too and, optionally, a writer publishes a
+// new configuration periodically. The background threads only run while the benchmark is measured.
+struct ContentionFixture
+{
+    ContentionFixture(size_t reader_count, std::chrono::microseconds publish_period)
+        : configuration(SyntheticData::CreateFlatConfiguration(100)), store(configuration),
+        key(SyntheticData::KeyName(42)), reader_count(reader_count), publish_period(publish_period), stop(false)
+    {
+    }
+
+    void start()
+    {
+        stop = false;
+        for (size_t i = 0; i < reader_count; ++i)
+        {
+            threads.emplace_back(
+                [this]()
+                {
+                    while (!stop)
+                    {
+                        ConfigurationStore::ReadHandle handle = store.read();
+                        BenchmarkHarness::doNotOptimize(handle->valueOrNull(key));
+                    }
+                });
+        }
+        if (publish_period.count() > 0)
+        {
+            threads.emplace_back(
+                [this]()
+                {
+                    while (!stop)
+                    {
+                        store.publish(configuration);
+                        std::this_thread::sleep_for(publish_period);
+                    }
+                });
+        }
+    }
+
+    void stopThreads()
+    {
+        stop = true;
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+    }
+
+    Configuration configuration;
+    ConfigurationStore store;
+    Configuration::Key key;
+    size_t reader_count;
+    std::chrono::microseconds publish_period;
+    std::atomic<bool> stop;
+    std::vector<std::thread> threads;
+};
+
+// The same reads through a mutex and a copy of a shared_ptr, what a store would typically look like without
+// snapshots and epochs
+struct MutexFixture
+{
+    MutexFixture()
+        : configuration(std::make_shared<Configuration>(SyntheticData::CreateFlatConfiguration(100))),
+        key(SyntheticData::KeyName(42))
+    {
+    }
+
+    std::mutex mutex;
+    std::shared_ptr<const Configuration> configuration;
+    Configuration::Key key;
+};
+
+}
+
+void AddConfigurationStoreBenchmarks(BenchmarkHarness& harness)
+{
+    std::shared_ptr<ContentionFixture> uncontended_fixture =
+        std::make_shared<ContentionFixture>(0, std::chrono::microseconds(0));
+    harness.add("ConfigurationStore::read uncontended",
+        [uncontended_fixture]()
+        {
+            ConfigurationStore::ReadHandle handle = uncontended_fixture->store.read();
+            BenchmarkHarness::doNotOptimize(handle->valueOrNull(uncontended_fixture->key));
+        });
+
+    std::shared_ptr<MutexFixture> mutex_fixture = std::make_shared<MutexFixture>();
+    harness.add("ConfigurationStore baseline mutex and shared_ptr read uncontended",
+        [mutex_fixture]()
+        {
+            std::shared_ptr<const Configuration> configuration;
+            {
+                std::lock_guard<std::mutex> lock(mutex_fixture->mutex);
+                configuration = mutex_fixture->configuration;
+            }
+            BenchmarkHarness::doNotOptimize(configuration->valueOrNull(mutex_fixture->key));
+        });
+
+    // Allocations made by the writer thread are counted in the results of the benchmarks with a writer
+    for (size_t reader_count : {1, 3, 7})
+    {
+        for (size_t publish_period_us : {0, 1000})
+        {
+            std::shared_ptr<ContentionFixture> fixture =
+                std::make_shared<ContentionFixture>(reader_count, std::chrono::microseconds(publish_period_us));
+            harness.add("ConfigurationStore::read readers=" + std::to_string(reader_count + 1)
+                + (publish_period_us ? " writer every " + std::to_string(publish_period_us) + " us" : " no writer"),
+                [fixture]()
+                {
+                    ConfigurationStore::ReadHandle handle = fixture->store.read();
+                    BenchmarkHarness::doNotOptimize(handle->valueOrNull(fixture->key));
+                },
+                [fixture]()
+                {
+                    fixture->start();
+                },
+                [fixture]()
+                {
+                    fixture->stopThreads();
+                });
+        }
+    }
+}
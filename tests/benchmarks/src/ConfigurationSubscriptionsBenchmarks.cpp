@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationSubscriptionsBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// One subscription per option of a configuration with 64 sections, updated alternately with two versions of the
+// configuration that differ by a single option. The sections grow with the number of subscribers so the time also
+// includes diffing a larger section, matching the change against the subscriptions doesn't depend on their number.
+struct UpdateFixture
+{
+    UpdateFixture(size_t subscriber_count)
+        : calls(0), next(0)
+    {
+        size_t keys_per_section = ((subscriber_count + 63) / 64);
+        for (size_t i = 0; i < 64; ++i)
+        {
+            configurations[0].set("section-" + std::to_string(i),
+                SyntheticData::CreateFlatConfiguration(keys_per_section));
+        }
+        configurations[1] = configurations[0];
+        configurations[1].set(Configuration::Path("section-7." + SyntheticData::KeyName(0)), "modified");
+
+        subscriptions.reset(new ConfigurationSubscriptions(configurations[0]));
+        for (size_t i = 0; i < subscriber_count; ++i)
+        {
+            std::string pattern = "section-" + std::to_string(i % 64) + "." + SyntheticData::KeyName(i / 64);
+            subscriptions->subscribe(pattern,
+                [this](const Configuration&, const std::vector<const ConfigurationPatch::Change*>&)
+                {
+                    ++calls;
+                });
+        }
+    }
+
+    Configuration configurations[2];
+    std::unique_ptr<ConfigurationSubscriptions> subscriptions;
+    size_t calls;
+    size_t next;
+};
+
+}
+
+void AddConfigurationSubscriptionsBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t subscriber_count : {64, 4096, 65536})
+    {
+        std::shared_ptr<UpdateFixture> fixture = std::make_shared<UpdateFixture>(subscriber_count);
+        harness.add("ConfigurationSubscriptions::update one change subscribers=" + std::to_string(subscriber_count),
+            [fixture]()
+            {
+                fixture->next = (1 - fixture->next);
+                fixture->subscriptions->update(fixture->configurations[fixture->next]);
+                BenchmarkHarness::doNotOptimize(fixture->calls);
+            });
+    }
+}
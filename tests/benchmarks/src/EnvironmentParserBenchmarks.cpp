@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnvironmentParserBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// An environment with "other_count" variables that don't have the prefix and 32 variables that set options
+struct EnvironmentFixture
+{
+    EnvironmentFixture(size_t option_count, size_t other_count)
+        : specification(SyntheticData::CreateNamedOptionsSpecification(option_count)),
+        parser(specification, "APP_")
+    {
+        for (size_t i = 0; i < other_count; ++i)
+        {
+            variables.push_back("OTHER_VARIABLE_" + std::to_string(i) + "=value-" + std::to_string(i));
+        }
+        for (size_t index : SyntheticData::CreateIndices(option_count, 32))
+        {
+            std::string name = EnvironmentParser::VariableName("APP_", SyntheticData::OptionName(index));
+            variables.insert(variables.begin() + ((index * 7919) % variables.size()),
+                name + "=value-" + std::to_string(index));
+        }
+        for (const std::string& variable : variables)
+        {
+            environment.push_back(variable.c_str());
+        }
+        environment.push_back(nullptr);
+
+        for (size_t i = 0; i < specification.namedOptionCount(); ++i)
+        {
+            variable_names.push_back(EnvironmentParser::VariableName("APP_", specification.namedOption(i).name));
+        }
+    }
+
+    // What getenv does for each option: a linear search of the environment
+    const char* findVariable(const std::string& name) const
+    {
+        for (const char* const* variable = environment.data(); *variable; ++variable)
+        {
+            if ((std::strncmp(*variable, name.c_str(), name.size()) == 0) && ((*variable)[name.size()] == '='))
+            {
+                return (*variable + name.size() + 1);
+            }
+        }
+        return nullptr;
+    }
+
+    CompiledCommandLineSpecification specification;
+    EnvironmentParser parser;
+    std::vector<std::string> variables;
+    std::vector<const char*> environment;
+    std::vector<std::string> variable_names;
+};
+
+}
+
+void AddEnvironmentParserBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t option_count : {100, 2000})
+    {
+        std::shared_ptr<EnvironmentFixture> fixture = std::make_shared<EnvironmentFixture>(option_count, 2000);
+        std::string suffix = " options=" + std::to_string(option_count) + " variables=2032";
+
+        harness.add("EnvironmentParser::parse" + suffix,
+            [fixture]()
+            {
+                Configuration configuration;
+                fixture->parser.parse(fixture->environment.data(), configuration);
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            });
+
+        harness.add("getenv per option baseline" + suffix,
+            [fixture]()
+            {
+                Configuration configuration;
+                for (size_t i = 0; i < fixture->variable_names.size(); ++i)
+                {
+                    const char* value = fixture->findVariable(fixture->variable_names[i]);
+                    if (value)
+                    {
+                        const CompiledCommandLineSpecification::Option& option = fixture->specification.namedOption(i);
+                        configuration.set(Configuration::Path(option.name), option.details.createValue(value));
+                    }
+                }
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            });
+    }
+}
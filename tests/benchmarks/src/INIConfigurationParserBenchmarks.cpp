@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "INIConfigurationParserBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <memory>
+#include <string>
+
+using namespace Ishiko;
+
+void AddINIConfigurationParserBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t section_count : {16, 2048})
+    {
+        std::shared_ptr<std::string> document =
+            std::make_shared<std::string>(SyntheticData::CreateINIDocument(section_count, 64));
+        std::string suffix = " sections=" + std::to_string(section_count) + " keys=64";
+
+        harness.add("INIConfigurationParser::parse" + suffix,
+            [document]()
+            {
+                Configuration configuration;
+                INIConfigurationParser::parse(*document, configuration);
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            },
+            document->size());
+    }
+}
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "JSONConfigurationParserBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <memory>
+#include <string>
+
+using namespace Ishiko;
+
+void AddJSONConfigurationParserBenchmarks(BenchmarkHarness& harness)
+{
+    for (size_t section_count : {16, 2048})
+    for (bool indented : {false, true})
+    {
+        std::shared_ptr<std::string> document =
+            std::make_shared<std::string>(SyntheticData::CreateJSONDocument(section_count, 64, indented));
+        std::string suffix = " sections=" + std::to_string(section_count) + " keys=64"
+            + (indented ? " indented" : " compact");
+
+        harness.add("JSONConfigurationParser::parse" + suffix,
+            [document]()
+            {
+                Configuration configuration;
+                JSONConfigurationParser::parse(*document, configuration);
+                BenchmarkHarness::doNotOptimize(configuration.size());
+            },
+            document->size());
+    }
+}
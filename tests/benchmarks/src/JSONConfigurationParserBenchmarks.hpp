@@ -0,0 +1,11 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_BENCHMARKS_JSONCONFIGURATIONPARSERBENCHMARKS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_BENCHMARKS_JSONCONFIGURATIONPARSERBENCHMARKS_HPP
+
+#include "BenchmarkHarness.hpp"
+
+void AddJSONConfigurationParserBenchmarks(BenchmarkHarness& harness);
+
+#endif
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "LayeredConfigurationBenchmarks.hpp"
+#include "SyntheticData.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+void AddLayeredConfigurationBenchmarks(BenchmarkHarness& harness)
+{
+    // Defaults with 64 sections of 64 keys, a file that overrides a key in half of the sections and a command line
+    // that overrides a few keys
+    Configuration defaults;
+    Configuration file;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        std::string section = "section-" + std::to_string(i);
+        defaults.set(section, SyntheticData::CreateFlatConfiguration(64));
+        if ((i % 2) == 0)
+        {
+            file.set(Configuration::Path(section + "." + SyntheticData::KeyName(i)), "file");
+        }
+    }
+    Configuration command_line;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        command_line.set(Configuration::Path("section-" + std::to_string(i * 8) + "." + SyntheticData::KeyName(i)),
+            "command line");
+    }
+    std::shared_ptr<LayeredConfiguration> layers = std::make_shared<LayeredConfiguration>(
+        std::vector<Configuration>({defaults, file, command_line}));
+    std::shared_ptr<Configuration> flattened = std::make_shared<Configuration>(layers->flatten());
+
+    // A per-request override of 4 keys on top of the base, read once: copying and modifying the flattened base versus
+    // pushing a layer
+    std::shared_ptr<std::vector<Configuration::Path>> paths = std::make_shared<std::vector<Configuration::Path>>();
+    for (size_t i = 0; i < 4; ++i)
+    {
+        paths->emplace_back("section-" + std::to_string(i * 16 + 1) + "." + SyntheticData::KeyName(7));
+    }
+    std::shared_ptr<Configuration> overrides = std::make_shared<Configuration>();
+    for (const Configuration::Path& path : *paths)
+    {
+        overrides->set(path, "request");
+    }
+
+    harness.add("Configuration copy and override keys=4 base sections=64 keys=64",
+        [flattened, paths]()
+        {
+            Configuration configuration = *flattened;
+            for (const Configuration::Path& path : *paths)
+            {
+                configuration.set(path, "request");
+            }
+            for (const Configuration::Path& path : *paths)
+            {
+                BenchmarkHarness::doNotOptimize(configuration.value(path).asString().size());
+            }
+        });
+
+    harness.add("LayeredConfiguration push override keys=4 base sections=64 keys=64",
+        [layers, overrides, paths]()
+        {
+            LayeredConfiguration configuration = *layers;
+            configuration.push(*overrides);
+            for (const Configuration::Path& path : *paths)
+            {
+                BenchmarkHarness::doNotOptimize(configuration.value(path).asString().size());
+            }
+        });
+
+    std::shared_ptr<Configuration::Path> path =
+        std::make_shared<Configuration::Path>("section-33." + SyntheticData::KeyName(7));
+    harness.add("Configuration::value path flattened sections=64 keys=64",
+        [flattened, path]()
+        {
+            BenchmarkHarness::doNotOptimize(flattened->value(*path).asString().size());
+        });
+    harness.add("LayeredConfiguration::value path layers=3 sections=64 keys=64",
+        [layers, path]()
+        {
+            BenchmarkHarness::doNotOptimize(layers->value(*path).asString().size());
+        });
+
+    harness.add("LayeredConfiguration::flatten layers=3 sections=64 keys=64",
+        [layers]()
+        {
+            BenchmarkHarness::doNotOptimize(layers->flatten().size());
+        });
+}
@@ -0,0 +1,265 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "SyntheticData.hpp"
+#include <cstdio>
+#include <random>
+
+using namespace Ishiko;
+
+SyntheticData::Arguments::Arguments(std::vector<std::string> arguments)
+    : m_arguments(std::move(arguments))
+{
+    m_arguments.insert(m_arguments.begin(), "benchmark");
+    for (const std::string& argument : m_arguments)
+    {
+        m_argv.push_back(argument.c_str());
+    }
+}
+
+SyntheticData::Arguments::Arguments(const Arguments& other)
+    : Arguments(std::vector<std::string>(other.m_arguments.begin() + 1, other.m_arguments.end()))
+{
+}
+
+int SyntheticData::Arguments::argc() const
+{
+    return static_cast<int>(m_argv.size());
+}
+
+const char** SyntheticData::Arguments::argv()
+{
+    return m_argv.data();
+}
+
+const std::vector<std::string>& SyntheticData::Arguments::arguments() const
+{
+    return m_arguments;
+}
+
+std::string SyntheticData::OptionName(size_t index)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "option-%05zu", index);
+    return buffer;
+}
+
+std::string SyntheticData::ShortOptionName(size_t index)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "o%zu", index);
+    return buffer;
+}
+
+std::string SyntheticData::KeyName(size_t index)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "key-%06zu", index);
+    return buffer;
+}
+
+CommandLineSpecification SyntheticData::CreateNamedOptionsSpecification(size_t option_count)
+{
+    CommandLineSpecification result;
+    for (size_t i = 0; i < option_count; ++i)
+    {
+        result.addNamedOption(OptionName(i), ShortOptionName(i),
+            {CommandLineSpecification::OptionType::single_value, "default-" + std::to_string(i)});
+    }
+    return result;
+}
+
+namespace
+{
+
+void AddSubcommands(CommandLineSpecification::CommandDetails& command, size_t position, size_t depth, size_t breadth)
+{
+    if (depth == 0)
+    {
+        return;
+    }
+    command.addPositionalOption(position, "subcommand", {CommandLineSpecification::OptionType::single_value});
+    for (size_t i = 0; i < breadth; ++i)
+    {
+        CommandLineSpecification::CommandDetails& subcommand =
+            command.addCommand("subcommand", "subcommand-" + std::to_string(i));
+        AddSubcommands(subcommand, position + 1, depth - 1, breadth);
+    }
+}
+
+}
+
+CommandLineSpecification SyntheticData::CreateCommandTreeSpecification(size_t depth, size_t breadth)
+{
+    CommandLineSpecification result;
+    result.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    for (size_t i = 0; i < breadth; ++i)
+    {
+        CommandLineSpecification::CommandDetails& command = result.addCommand("command", "command-" + std::to_string(i));
+        AddSubcommands(command, 2, depth - 1, breadth);
+    }
+    return result;
+}
+
+SyntheticData::Arguments SyntheticData::CreateNamedOptionArguments(size_t option_count, size_t argument_count)
+{
+    std::vector<std::string> arguments;
+    for (size_t index : CreateIndices(option_count, argument_count))
+    {
+        arguments.push_back("--" + OptionName(index) + "=value-" + std::to_string(index));
+    }
+    return Arguments(std::move(arguments));
+}
+
+SyntheticData::Arguments SyntheticData::CreateShortOptionArguments(size_t option_count, size_t argument_count)
+{
+    std::vector<std::string> arguments;
+    for (size_t index : CreateIndices(option_count, argument_count))
+    {
+        arguments.push_back("-" + ShortOptionName(index) + "=value-" + std::to_string(index));
+    }
+    return Arguments(std::move(arguments));
+}
+
+SyntheticData::Arguments SyntheticData::CreateToggleArguments(size_t option_count, size_t argument_count)
+{
+    std::vector<std::string> arguments;
+    for (size_t index : CreateIndices(option_count, argument_count))
+    {
+        arguments.push_back("--" + OptionName(index));
+    }
+    return Arguments(std::move(arguments));
+}
+
+SyntheticData::Arguments SyntheticData::CreateUnmatchedArguments(size_t argument_count)
+{
+    std::vector<std::string> arguments;
+    for (size_t i = 0; i < argument_count; ++i)
+    {
+        arguments.push_back("unmatched-positional-argument-" + std::to_string(i));
+    }
+    return Arguments(std::move(arguments));
+}
+
+SyntheticData::Arguments SyntheticData::CreateCommandTreeArguments(size_t depth, size_t breadth)
+{
+    std::vector<std::string> arguments;
+    arguments.push_back("command-" + std::to_string(breadth - 1));
+    for (size_t i = 1; i < depth; ++i)
+    {
+        arguments.push_back("subcommand-" + std::to_string(breadth - 1));
+    }
+    return Arguments(std::move(arguments));
+}
+
+Configuration SyntheticData::CreateFlatConfiguration(size_t key_count)
+{
+    Configuration result;
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        result.set(KeyName(i), "value-" + std::to_string(i));
+    }
+    return result;
+}
+
+Configuration SyntheticData::CreateNestedConfiguration(size_t depth, size_t breadth)
+{
+    Configuration result;
+    for (size_t i = 0; i < breadth; ++i)
+    {
+        result.set(KeyName(i), "value-" + std::to_string(i));
+    }
+    if (depth > 1)
+    {
+        result.set("child", CreateNestedConfiguration(depth - 1, breadth));
+    }
+    return result;
+}
+
+std::string SyntheticData::CreateJSONDocument(size_t section_count, size_t key_count, bool indented)
+{
+    std::string new_line = (indented ? "\n" : "");
+    std::string indent = (indented ? "    " : "");
+    std::string separator = (indented ? " " : "");
+
+    std::string result = "{" + new_line;
+    for (size_t i = 0; i < section_count; ++i)
+    {
+        result += indent + "\"section-" + std::to_string(i) + "\":" + separator + "{" + new_line;
+        for (size_t j = key_count; j > 0; --j)
+        {
+            size_t index = (j - 1);
+            result += indent + indent + "\"" + KeyName(index) + "\":" + separator;
+            switch (index % 4)
+            {
+            case 0:
+                result += "\"value-" + std::to_string(index) + " with some \\\"quoted\\\" text\"";
+                break;
+
+            case 1:
+                result += std::to_string(index * 1000);
+                break;
+
+            case 2:
+                result += ((index % 8) == 2) ? "true" : "false";
+                break;
+
+            case 3:
+                result += "[\"host-1.example.com\"," + separator + "\"host-2.example.com\"," + separator
+                    + "\"host-3.example.com\"]";
+                break;
+            }
+            result += ((j > 1) ? "," : "") + new_line;
+        }
+        result += indent + "}" + (((i + 1) < section_count) ? "," : "") + new_line;
+    }
+    result += "}" + new_line;
+    return result;
+}
+
+std::string SyntheticData::CreateINIDocument(size_t section_count, size_t key_count)
+{
+    std::string result;
+    for (size_t i = 0; i < section_count; ++i)
+    {
+        result += "[section-" + std::to_string(i) + "]\n";
+        for (size_t j = key_count; j > 0; --j)
+        {
+            size_t index = (j - 1);
+            std::string key = KeyName(index);
+            switch (index % 4)
+            {
+            case 0:
+                result += key + " = \"value-" + std::to_string(index) + " with some \\\"quoted\\\" text\"\n";
+                break;
+
+            case 1:
+                result += key + " = " + std::to_string(index * 1000) + "\n";
+                break;
+
+            case 2:
+                result += key + " = " + (((index % 8) == 2) ? "true" : "false") + "\n";
+                break;
+
+            case 3:
+                result += key + " = host-1.example.com\n" + key + " = host-2.example.com\n" + key
+                    + " = host-3.example.com\n";
+                break;
+            }
+        }
+        result += "\n";
+    }
+    return result;
+}
+
+std::vector<size_t> SyntheticData::CreateIndices(size_t size, size_t count)
+{
+    std::mt19937 generator(20240101);
+    std::uniform_int_distribution<size_t> distribution(0, size - 1);
+    std::vector<size_t> result;
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.push_back(distribution(generator));
+    }
+    return result;
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_BENCHMARKS_SYNTHETICDATA_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_BENCHMARKS_SYNTHETICDATA_HPP
+
+#include "Ishiko/Configuration.hpp"
+#include <string>
+#include <vector>
+
+// Generators for the inputs used by the benchmarks. All of them are deterministic so that results can be compared
+// between runs and between releases.
+class SyntheticData
+{
+public:
+    // Owns the argument strings and exposes them as a classic argc/argv pair. argv[0] is a dummy executable name.
+    class Arguments
+    {
+    public:
+        explicit Arguments(std::vector<std::string> arguments);
+        Arguments(const Arguments& other);
+        Arguments& operator=(const Arguments& other) = delete;
+
+        int argc() const;
+        const char** argv();
+        const std::vector<std::string>& arguments() const;
+
+    private:
+        std::vector<std::string> m_arguments;
+        std::vector<const char*> m_argv;
+    };
+
+    static std::string OptionName(size_t index);
+    static std::string ShortOptionName(size_t index);
+    static std::string KeyName(size_t index);
+
+    // Named options "option-<n>" with short names "o<n>" and a default value each.
+    static Ishiko::CommandLineSpecification CreateNamedOptionsSpecification(size_t option_count);
+    // A command at position 1 followed by nested subcommands at each following position, "breadth" alternatives at
+    // each level.
+    static Ishiko::CommandLineSpecification CreateCommandTreeSpecification(size_t depth, size_t breadth);
+
+    static Arguments CreateNamedOptionArguments(size_t option_count, size_t argument_count);
+    static Arguments CreateShortOptionArguments(size_t option_count, size_t argument_count);
+    // "--option-<n>" without a value
+    static Arguments CreateToggleArguments(size_t option_count, size_t argument_count);
+    // Positional arguments that match nothing in the specifications created by this class
+    static Arguments CreateUnmatchedArguments(size_t argument_count);
+    static Arguments CreateCommandTreeArguments(size_t depth, size_t breadth);
+
+    // "key-<n>" to "value-<n>"
+    static Ishiko::Configuration CreateFlatConfiguration(size_t key_count);
+    // Each level has "breadth" string values and a "child" nested configuration, "depth" levels deep.
+    static Ishiko::Configuration CreateNestedConfiguration(size_t depth, size_t breadth);
+    // An object with "section_count" objects of "key_count" members each, in reverse name order. The members cycle
+    // through strings, integers, booleans and arrays of strings, some strings have escape sequences. Indented
+    // documents use four spaces per level like most generated configuration files.
+    static std::string CreateJSONDocument(size_t section_count, size_t key_count, bool indented);
+    // The same content as CreateJSONDocument as an INI file, the arrays are written as repeated keys
+    static std::string CreateINIDocument(size_t section_count, size_t key_count);
+
+    // Pseudo-random but reproducible selection of "count" indices in [0, size)
+    static std::vector<size_t> CreateIndices(size_t size, size_t count);
+};
+
+#endif
@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "BenchmarkHarness.hpp"
+#include "CommandLineParserBenchmarks.hpp"
+#include "CommandLineSpecificationBenchmarks.hpp"
+#include "ConfigurationBenchmarks.hpp"
+#include "ConfigurationSnapshotBenchmarks.hpp"
+#include "ConfigurationStoreBenchmarks.hpp"
+#include "ConfigurationSubscriptionsBenchmarks.hpp"
+#include "EnvironmentParserBenchmarks.hpp"
+#include "INIConfigurationParserBenchmarks.hpp"
+#include "JSONConfigurationParserBenchmarks.hpp"
+#include "LayeredConfigurationBenchmarks.hpp"
+#include "Ishiko/Configuration/linkoptions.hpp"
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    BenchmarkHarness theBenchmarkHarness;
+    if (!theBenchmarkHarness.parseArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    AddConfigurationBenchmarks(theBenchmarkHarness);
+    AddConfigurationStoreBenchmarks(theBenchmarkHarness);
+    AddConfigurationSubscriptionsBenchmarks(theBenchmarkHarness);
+    AddCommandLineSpecificationBenchmarks(theBenchmarkHarness);
+    AddCommandLineParserBenchmarks(theBenchmarkHarness);
+    AddJSONConfigurationParserBenchmarks(theBenchmarkHarness);
+    AddINIConfigurationParserBenchmarks(theBenchmarkHarness);
+    AddConfigurationSnapshotBenchmarks(theBenchmarkHarness);
+    AddLayeredConfigurationBenchmarks(theBenchmarkHarness);
+    AddEnvironmentParserBenchmarks(theBenchmarkHarness);
+
+    return theBenchmarkHarness.run(std::cout);
+}
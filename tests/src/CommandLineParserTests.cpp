@@ -3,9 +3,27 @@
 
 #include "CommandLineParserTests.hpp"
 #include "Ishiko/Configuration/CommandLineParser.hpp"
+#include "Ishiko/Configuration/ConfigurationParseError.hpp"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
 
 using namespace Ishiko;
 
+namespace
+{
+
+void WriteFile(const std::string& file_path, const std::string& content)
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+}
+
 CommandLineParserTests::CommandLineParserTests(const TestNumber& number, const TestContext& context)
     : TestSequence(number, "CommandLineParser tests", context)
 {
@@ -19,6 +37,25 @@ CommandLineParserTests::CommandLineParserTests(const TestNumber& number, const T
     append<HeapAllocationErrorsTest>("parse test 7", ParseTest7);
     append<HeapAllocationErrorsTest>("parse test 8", ParseTest8);
     append<HeapAllocationErrorsTest>("parse test 9", ParseTest9);
+    append<HeapAllocationErrorsTest>("parse test 10", ParseTest10);
+    append<HeapAllocationErrorsTest>("parse test 11", ParseTest11);
+    append<HeapAllocationErrorsTest>("parse test 12", ParseTest12);
+    append<HeapAllocationErrorsTest>("parse test 13", ParseTest13);
+    append<HeapAllocationErrorsTest>("parse test 14", ParseTest14);
+    append<HeapAllocationErrorsTest>("parse test 15", ParseTest15);
+    append<HeapAllocationErrorsTest>("parse test 16", ParseTest16);
+    append<HeapAllocationErrorsTest>("parse test 17", ParseTest17);
+    append<HeapAllocationErrorsTest>("parse test 18", ParseTest18);
+    append<HeapAllocationErrorsTest>("parse test 19", ParseTest19);
+    append<HeapAllocationErrorsTest>("parse test 20", ParseTest20);
+    append<HeapAllocationErrorsTest>("parse test 21", ParseTest21);
+    append<HeapAllocationErrorsTest>("parse test 22", ParseTest22);
+    append<HeapAllocationErrorsTest>("parse test 23", ParseTest23);
+    append<HeapAllocationErrorsTest>("Session parse test 1", SessionParseTest1);
+    append<HeapAllocationErrorsTest>("Session parse test 2", SessionParseTest2);
+    append<HeapAllocationErrorsTest>("Session parse test 3", SessionParseTest3);
+    append<HeapAllocationErrorsTest>("parseBatch test 1", ParseBatchTest1);
+    append<HeapAllocationErrorsTest>("parseBatch test 2", ParseBatchTest2);
 }
 
 void CommandLineParserTests::ConstructorTest1(Test& test)
@@ -180,3 +217,498 @@ void CommandLineParserTests::ParseTest9(Test& test)
         "value1");
     ISHIKO_TEST_PASS();
 }
+
+void CommandLineParserTests::ParseTest10(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "option1", {CommandLineSpecification::OptionType::single_value});
+
+    CommandLineParser parser;
+    int argc = 4;
+    const char* argv[] = {"dummy", "value1", "value2", "-x=value3"};
+    Configuration configuration;
+    parser.parse(spec, argc, argv, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest11(Test& test)
+{
+    CommandLineSpecification spec;
+    CommandLineSpecification::OptionDetails option_details(CommandLineSpecification::OptionType::single_value);
+    option_details.setAllowedValues({"value1", "value2"});
+    spec.addPositionalOption(1, "option1", option_details);
+    spec.addPositionalOption(2, "option2", option_details);
+
+    CommandLineParser parser;
+    int argc = 3;
+    const char* argv[] = {"dummy", "value2", "value3"};
+    Configuration configuration;
+    parser.parse(spec, argc, argv, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrNull("option2"), nullptr);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest12(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", "o", {CommandLineSpecification::OptionType::single_value, "default"});
+    spec.addNamedOption("option2", {CommandLineSpecification::OptionType::single_value});
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    CommandLineParser parser;
+    int argc = 4;
+    const char* argv[] = {"dummy", "-o=value1", "--option2=value2", "--option3=value3"};
+    Configuration configuration;
+    parser.parse(compiled_spec, argc, argv, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option2").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option3").asString(), "value3");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest13(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    CommandLineSpecification::CommandDetails& command_details = spec.addCommand("command", "command1", "subcommand1");
+    command_details.addPositionalOption(3, "subcommand1_option1", {CommandLineSpecification::OptionType::single_value});
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    CommandLineParser parser;
+    int argc = 4;
+    const char* argv[] = {"dummy", "command1", "subcommand1", "value1"};
+    Configuration configuration;
+    parser.parse(compiled_spec, argc, argv, configuration);
+
+    const Configuration& command_configuration = configuration.value("command").asConfiguration();
+    const Configuration& subcommand_configuration = command_configuration.value("subcommand").asConfiguration();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(command_configuration.value("name").asString(), "command1");
+    ISHIKO_TEST_FAIL_IF_NEQ(subcommand_configuration.value("name").asString(), "subcommand1");
+    ISHIKO_TEST_FAIL_IF_NEQ(subcommand_configuration.value("subcommand1_option1").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest14(Test& test)
+{
+    CommandLineSpecification spec;
+    CommandLineSpecification::OptionDetails port_details(CommandLineSpecification::OptionType::single_value);
+    port_details.setValueType(Configuration::Value::Type::integer);
+    spec.addNamedOption("port", "p", port_details);
+    CommandLineSpecification::OptionDetails timeout_details(CommandLineSpecification::OptionType::single_value);
+    timeout_details.setValueType(Configuration::Value::Type::duration);
+    spec.addPositionalOption(1, "timeout", timeout_details);
+
+    CommandLineParser parser;
+    int argc = 3;
+    const char* argv[] = {"dummy", "-p=8080", "30s"};
+    Configuration configuration;
+    parser.parse(spec, argc, argv, configuration);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(configuration.value("port").type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("port").asInt(), 8080);
+    ISHIKO_TEST_ABORT_IF_NEQ(configuration.value("timeout").type(), Configuration::Value::Type::duration);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("timeout").asDuration().count(), 30000000000);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest15(Test& test)
+{
+    CommandLineSpecification spec;
+    CommandLineSpecification::OptionDetails toggle_details(CommandLineSpecification::OptionType::toggle);
+    toggle_details.setValueType(Configuration::Value::Type::boolean);
+    spec.addNamedOption("verbose", toggle_details);
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setValueType(Configuration::Value::Type::boolean);
+    spec.addNamedOption("debug", details);
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    CommandLineParser parser;
+    int argc = 2;
+    const char* argv[] = {"dummy", "--verbose"};
+    Configuration configuration;
+    parser.parse(compiled_spec, argc, argv, configuration);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(configuration.value("verbose").type(), Configuration::Value::Type::boolean);
+    ISHIKO_TEST_FAIL_IF_NOT(configuration.value("verbose").asBool());
+
+    // The value can't be converted
+    const char* invalid_argv[] = {"dummy", "--debug=maybe"};
+    bool error = false;
+    try
+    {
+        parser.parse(compiled_spec, argc, invalid_argv, configuration);
+    }
+    catch (const std::invalid_argument&)
+    {
+        error = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(error);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest16(Test& test)
+{
+    WriteFile("CommandLineParserTests_ParseTest16.rsp", "--option1=value1\n  --option2=value2\tpositional1\r\n");
+
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "positional1", {CommandLineSpecification::OptionType::single_value});
+    spec.addPositionalOption(2, "positional2", {CommandLineSpecification::OptionType::single_value});
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    CommandLineParser parser;
+    int argc = 4;
+    const char* argv[] =
+        {"dummy", "--option1=value0", "@CommandLineParserTests_ParseTest16.rsp", "positional2"};
+    Configuration configuration;
+    parser.parse(compiled_spec, argc, argv, configuration, CommandLineParser::ResponseFiles::enabled);
+
+    std::remove("CommandLineParserTests_ParseTest16.rsp");
+
+    // The arguments in the file are parsed in place of the @file argument
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 4);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option2").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("positional1").asString(), "positional1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("positional2").asString(), "positional2");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest17(Test& test)
+{
+    WriteFile("CommandLineParserTests_ParseTest17.rsp",
+        "--option1=\"a b\" --option2='c \\d' --option3=e\\ f \"--option4=\\\"g\\\\\" '@h' --option5=");
+
+    CommandLineSpecification spec;
+
+    CommandLineParser parser;
+    int argc = 2;
+    const char* argv[] = {"dummy", "@CommandLineParserTests_ParseTest17.rsp"};
+    Configuration configuration;
+    parser.parse(spec, argc, argv, configuration, CommandLineParser::ResponseFiles::enabled);
+
+    std::remove("CommandLineParserTests_ParseTest17.rsp");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 5);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "a b");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option2").asString(), "c \\d");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option3").asString(), "e f");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option4").asString(), "\"g\\");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option5").asString(), "");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest18(Test& test)
+{
+    WriteFile("CommandLineParserTests_ParseTest18_1.rsp",
+        "--option1=value1 @CommandLineParserTests_ParseTest18_2.rsp");
+    WriteFile("CommandLineParserTests_ParseTest18_2.rsp", "--option2=value2");
+
+    CommandLineSpecification spec;
+
+    CommandLineParser parser;
+    int argc = 3;
+    const char* argv[] =
+        {"dummy", "@CommandLineParserTests_ParseTest18_1.rsp", "@CommandLineParserTests_ParseTest18_2.rsp"};
+    Configuration configuration;
+    parser.parse(spec, argc, argv, configuration, CommandLineParser::ResponseFiles::enabled);
+
+    std::remove("CommandLineParserTests_ParseTest18_1.rsp");
+    std::remove("CommandLineParserTests_ParseTest18_2.rsp");
+
+    // A response file can be read several times as long as it doesn't include itself
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option2").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest19(Test& test)
+{
+    WriteFile("CommandLineParserTests_ParseTest19_1.rsp",
+        "--option1=value1 @CommandLineParserTests_ParseTest19_2.rsp");
+    // The file includes the first one through a different path
+    WriteFile("CommandLineParserTests_ParseTest19_2.rsp",
+        "--option2=value2\n@./CommandLineParserTests_ParseTest19_1.rsp");
+
+    CommandLineSpecification spec;
+
+    CommandLineParser parser;
+    int argc = 2;
+    const char* argv[] = {"dummy", "@CommandLineParserTests_ParseTest19_1.rsp"};
+    Configuration configuration;
+    size_t line = 0;
+    size_t column = 0;
+    try
+    {
+        parser.parse(spec, argc, argv, configuration, CommandLineParser::ResponseFiles::enabled);
+    }
+    catch (const ConfigurationParseError& e)
+    {
+        line = e.line();
+        column = e.column();
+    }
+
+    std::remove("CommandLineParserTests_ParseTest19_1.rsp");
+    std::remove("CommandLineParserTests_ParseTest19_2.rsp");
+
+    // The error is at the argument that names the file that is already being read
+    ISHIKO_TEST_FAIL_IF_NEQ(line, 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(column, 1);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest20(Test& test)
+{
+    WriteFile("CommandLineParserTests_ParseTest20.rsp", "--option1='value1");
+
+    CommandLineSpecification spec;
+
+    CommandLineParser parser;
+    std::vector<std::vector<const char*>> command_lines = {{"dummy", "@CommandLineParserTests_ParseTest20.rsp"},
+        {"dummy", "@CommandLineParserTests_ParseTest20_missing.rsp"}};
+    size_t parse_errors = 0;
+    size_t system_errors = 0;
+    for (std::vector<const char*>& argv : command_lines)
+    {
+        Configuration configuration;
+        try
+        {
+            parser.parse(spec, static_cast<int>(argv.size()), argv.data(), configuration,
+                CommandLineParser::ResponseFiles::enabled);
+        }
+        catch (const ConfigurationParseError&)
+        {
+            ++parse_errors;
+        }
+        catch (const std::system_error&)
+        {
+            ++system_errors;
+        }
+    }
+
+    std::remove("CommandLineParserTests_ParseTest20.rsp");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(parse_errors, 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(system_errors, 1);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest21(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    CommandLineSpecification::CommandDetails& command_details = spec.addCommand("command", "build", "all");
+    command_details.addPositionalOption(3, "target", {CommandLineSpecification::OptionType::single_value});
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    // The named options are set in the root configuration between the arguments that set options of the commands
+    CommandLineParser parser;
+    int argc = 8;
+    const char* argv[] = {"dummy", "build", "--a=1", "--b=2", "--c=3", "all", "--d=4", "release"};
+    Configuration configuration;
+    parser.parse(spec, argc, argv, configuration);
+    Configuration compiled_configuration;
+    parser.parse(compiled_spec, argc, argv, compiled_configuration);
+
+    for (const Configuration* result : {&configuration, &compiled_configuration})
+    {
+        ISHIKO_TEST_ABORT_IF_NEQ(result->size(), 5);
+        ISHIKO_TEST_FAIL_IF_NEQ(result->value("a").asString(), "1");
+        ISHIKO_TEST_FAIL_IF_NEQ(result->value("d").asString(), "4");
+
+        const Configuration& command_configuration = result->value("command").asConfiguration();
+        const Configuration& subcommand_configuration = command_configuration.value("subcommand").asConfiguration();
+        ISHIKO_TEST_FAIL_IF_NEQ(command_configuration.value("name").asString(), "build");
+        ISHIKO_TEST_FAIL_IF_NEQ(subcommand_configuration.value("name").asString(), "all");
+        ISHIKO_TEST_FAIL_IF_NEQ(subcommand_configuration.value("target").asString(), "release");
+    }
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest22(Test& test)
+{
+    WriteFile("CommandLineParserTests_ParseTest22.rsp", "@@value3 '@value4'");
+
+    CommandLineSpecification spec;
+    for (size_t i = 1; i <= 4; ++i)
+    {
+        spec.addPositionalOption(i, "positional" + std::to_string(i),
+            {CommandLineSpecification::OptionType::single_value});
+    }
+
+    // Response files are disabled by default
+    CommandLineParser parser;
+    const char* argv[] = {"dummy", "@alice", "@@bob"};
+    Configuration configuration;
+    parser.parse(spec, 3, argv, configuration);
+    std::vector<Configuration> batch_configurations =
+        CommandLineParser::parseBatch(spec, {{"dummy", "@CommandLineParserTests_ParseTest22.rsp"}});
+
+    // "@@" escapes the '@' of an argument that isn't a response file
+    const char* response_file_argv[] = {"dummy", "@@value1", "value2", "@CommandLineParserTests_ParseTest22.rsp"};
+    Configuration response_file_configuration;
+    parser.parse(spec, 4, response_file_argv, response_file_configuration,
+        CommandLineParser::ResponseFiles::enabled);
+
+    std::remove("CommandLineParserTests_ParseTest22.rsp");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("positional1").asString(), "@alice");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("positional2").asString(), "@@bob");
+    ISHIKO_TEST_ABORT_IF_NEQ(batch_configurations.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(batch_configurations[0].value("positional1").asString(),
+        "@CommandLineParserTests_ParseTest22.rsp");
+    ISHIKO_TEST_FAIL_IF_NEQ(response_file_configuration.value("positional1").asString(), "@value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(response_file_configuration.value("positional2").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(response_file_configuration.value("positional3").asString(), "@value3");
+    ISHIKO_TEST_FAIL_IF_NEQ(response_file_configuration.value("positional4").asString(), "@value4");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseTest23(Test& test)
+{
+    CommandLineSpecification spec;
+
+    // A device has no size, it must not be taken for an empty response file
+    CommandLineParser parser;
+#if defined(_WIN32)
+    const char* argv[] = {"dummy", "@NUL"};
+#else
+    const char* argv[] = {"dummy", "@/dev/null"};
+#endif
+    Configuration configuration;
+    bool system_error_thrown = false;
+    try
+    {
+        parser.parse(spec, 2, argv, configuration, CommandLineParser::ResponseFiles::enabled);
+    }
+    catch (const std::system_error&)
+    {
+        system_error_thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(system_error_thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::SessionParseTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default1"});
+    spec.addNamedOption("option2", {CommandLineSpecification::OptionType::single_value, "default2"});
+
+    CommandLineParser::Session session(spec);
+    const char* argv1[] = {"dummy", "--option1=value1", "--option3=value3"};
+    const Configuration& configuration1 = session.parse(3, argv1);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value("option2").asString(), "default2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value("option3").asString(), "value3");
+
+    // The second parse starts from the defaults again
+    const char* argv2[] = {"dummy", "--option2=value2"};
+    const Configuration& configuration2 = session.parse(2, argv2);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.value("option1").asString(), "default1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.value("option2").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::SessionParseTest2(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default1"});
+
+    CommandLineParser::Session session(spec.compile());
+    const char* argv1[] = {"dummy", "--option1=value1"};
+    Configuration copy = session.parse(2, argv1);
+    const char* argv2[] = {"dummy", "--option1=value2"};
+    const Configuration& configuration = session.parse(2, argv2);
+
+    // The copy is not affected by the next parse
+    ISHIKO_TEST_FAIL_IF_NEQ(copy.value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::SessionParseTest3(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    spec.addCommand("command", "build");
+    spec.addCommand("command", "test");
+
+    CommandLineParser::Session session(spec);
+    const char* argv1[] = {"dummy", "build"};
+    session.parse(2, argv1);
+    const char* argv2[] = {"dummy", "test"};
+    const Configuration& configuration = session.parse(2, argv2);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("command").asConfiguration().value("name").asString(), "test");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseBatchTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default1"});
+    spec.addNamedOption("option2", {CommandLineSpecification::OptionType::single_value, "default2"});
+
+    std::vector<std::vector<const char*>> command_lines;
+    command_lines.push_back({"dummy", "--option1=value1"});
+    command_lines.push_back({"dummy"});
+    command_lines.push_back({"dummy", "--option2=value2"});
+    std::vector<Configuration> configurations = CommandLineParser::parseBatch(spec, command_lines);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(configurations.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configurations[0].size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configurations[0].value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configurations[1].size(), 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(configurations[2].size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configurations[2].value("option2").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineParserTests::ParseBatchTest2(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default1"});
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    // Enough command lines for every thread to get several chunks
+    std::vector<std::string> arguments;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        arguments.push_back("--option1=value" + std::to_string(i));
+    }
+    std::vector<std::vector<const char*>> command_lines;
+    for (const std::string& argument : arguments)
+    {
+        command_lines.push_back({"dummy", argument.c_str()});
+    }
+    std::vector<Configuration> configurations = CommandLineParser::parseBatch(compiled_spec, command_lines, 4);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(configurations.size(), 1000);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < configurations.size(); ++i)
+    {
+        if (configurations[i].value("option1").asString() != ("value" + std::to_string(i)))
+        {
+            ++mismatches;
+        }
+    }
+    ISHIKO_TEST_FAIL_IF_NEQ(mismatches, 0);
+    ISHIKO_TEST_PASS();
+}
@@ -22,6 +22,25 @@ private:
     static void ParseTest7(Ishiko::Test& test);
     static void ParseTest8(Ishiko::Test& test);
     static void ParseTest9(Ishiko::Test& test);
+    static void ParseTest10(Ishiko::Test& test);
+    static void ParseTest11(Ishiko::Test& test);
+    static void ParseTest12(Ishiko::Test& test);
+    static void ParseTest13(Ishiko::Test& test);
+    static void ParseTest14(Ishiko::Test& test);
+    static void ParseTest15(Ishiko::Test& test);
+    static void ParseTest16(Ishiko::Test& test);
+    static void ParseTest17(Ishiko::Test& test);
+    static void ParseTest18(Ishiko::Test& test);
+    static void ParseTest19(Ishiko::Test& test);
+    static void ParseTest20(Ishiko::Test& test);
+    static void ParseTest21(Ishiko::Test& test);
+    static void ParseTest22(Ishiko::Test& test);
+    static void ParseTest23(Ishiko::Test& test);
+    static void SessionParseTest1(Ishiko::Test& test);
+    static void SessionParseTest2(Ishiko::Test& test);
+    static void SessionParseTest3(Ishiko::Test& test);
+    static void ParseBatchTest1(Ishiko::Test& test);
+    static void ParseBatchTest2(Ishiko::Test& test);
 };
 
 #endif
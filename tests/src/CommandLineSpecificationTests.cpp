@@ -3,6 +3,7 @@
 
 #include "CommandLineSpecificationTests.hpp"
 #include "Ishiko/Configuration/CommandLineSpecification.hpp"
+#include <stdexcept>
 
 using namespace Ishiko;
 
@@ -18,6 +19,19 @@ CommandLineSpecificationTests::CommandLineSpecificationTests(const TestNumber& n
     append<HeapAllocationErrorsTest>("createDefaultConfiguration test 2", CreateDefaultConfigurationTest2);
     append<HeapAllocationErrorsTest>("createDefaultConfiguration test 3", CreateDefaultConfigurationTest3);
     append<HeapAllocationErrorsTest>("createDefaultConfiguration test 4", CreateDefaultConfigurationTest4);
+    append<HeapAllocationErrorsTest>("findPositionalOption test 1", FindPositionalOptionTest1);
+    append<HeapAllocationErrorsTest>("findNamedOption test 1", FindNamedOptionTest1);
+    append<HeapAllocationErrorsTest>("findShortNamedOption test 1", FindShortNamedOptionTest1);
+    append<HeapAllocationErrorsTest>("findCommand test 1", FindCommandTest1);
+    append<HeapAllocationErrorsTest>("isValueAllowed test 1", IsValueAllowedTest1);
+    append<HeapAllocationErrorsTest>("isValueAllowed test 2", IsValueAllowedTest2);
+    append<HeapAllocationErrorsTest>("isValueAllowed test 3", IsValueAllowedTest3);
+    append<HeapAllocationErrorsTest>("isValueAllowed test 4", IsValueAllowedTest4);
+    append<HeapAllocationErrorsTest>("isValueAllowed test 5", IsValueAllowedTest5);
+    append<HeapAllocationErrorsTest>("isValueAllowed test 6", IsValueAllowedTest6);
+    append<HeapAllocationErrorsTest>("createDefaultConfiguration test 5", CreateDefaultConfigurationTest5);
+    append<HeapAllocationErrorsTest>("setValueType test 1", SetValueTypeTest1);
+    append<HeapAllocationErrorsTest>("createValue test 1", CreateValueTest1);
 }
 
 void CommandLineSpecificationTests::ConstructorTest1(Test& test)
@@ -134,3 +148,209 @@ void CommandLineSpecificationTests::CreateDefaultConfigurationTest4(Test& test)
     ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option2").asString(), "true");
     ISHIKO_TEST_PASS();
 }
+
+void CommandLineSpecificationTests::FindPositionalOptionTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "option1", {CommandLineSpecification::OptionType::single_value, "default"});
+
+    const std::string* name = nullptr;
+    const CommandLineSpecification::OptionDetails* details = nullptr;
+    bool found1 = spec.findPositionalOption(1, name, details);
+    bool found2 = spec.findPositionalOption(2, name, details);
+
+    ISHIKO_TEST_ABORT_IF_NOT(found1);
+    ISHIKO_TEST_FAIL_IF_NEQ(*name, "option1");
+    ISHIKO_TEST_FAIL_IF_NEQ(*details->defaultValue(), "default");
+    ISHIKO_TEST_FAIL_IF(found2);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::FindNamedOptionTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default"});
+
+    const CommandLineSpecification::OptionDetails* details1 = nullptr;
+    bool found1 = spec.findNamedOption("option1", details1);
+    const CommandLineSpecification::OptionDetails* details2 = nullptr;
+    bool found2 = spec.findNamedOption("option2", details2);
+
+    ISHIKO_TEST_ABORT_IF_NOT(found1);
+    ISHIKO_TEST_FAIL_IF_NEQ(details1->type(), CommandLineSpecification::OptionType::single_value);
+    ISHIKO_TEST_FAIL_IF_NEQ(*details1->defaultValue(), "default");
+    ISHIKO_TEST_FAIL_IF(found2);
+    ISHIKO_TEST_FAIL_IF_NEQ(details2, nullptr);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::FindShortNamedOptionTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", "o", {CommandLineSpecification::OptionType::toggle});
+
+    const std::string* name = nullptr;
+    const CommandLineSpecification::OptionDetails* details = nullptr;
+    bool found = spec.findShortNamedOption("o", name, details);
+
+    ISHIKO_TEST_ABORT_IF_NOT(found);
+    ISHIKO_TEST_FAIL_IF_NEQ(*name, "option1");
+    ISHIKO_TEST_FAIL_IF_NEQ(details->type(), CommandLineSpecification::OptionType::toggle);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::FindCommandTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    CommandLineSpecification::CommandDetails& command_details = spec.addCommand("command", "command1", "subcommand1");
+
+    const CommandLineSpecification::CommandDetails* found_command_details = nullptr;
+    bool found1 = spec.findCommand("command", "command1", found_command_details);
+
+    ISHIKO_TEST_ABORT_IF_NOT(found1);
+
+    const CommandLineSpecification::CommandDetails* found_subcommand_details = nullptr;
+    bool found2 = found_command_details->findCommand("subcommand", "subcommand1", found_subcommand_details);
+
+    ISHIKO_TEST_FAIL_IF_NOT(found2);
+    ISHIKO_TEST_FAIL_IF_NEQ(found_subcommand_details, &command_details);
+    ISHIKO_TEST_FAIL_IF(spec.findCommand("command", "command2", found_command_details));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::IsValueAllowedTest1(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("value1"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed(""));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::IsValueAllowedTest2(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setAllowedValues({"value1", "value2"});
+
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("value1"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("value2"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("Value1"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("value3"));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::IsValueAllowedTest3(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setAllowedValues({"eu-west", "us-east"}, CommandLineSpecification::CaseSensitivity::insensitive);
+
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("eu-west"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("EU-West"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("US-EAST"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("eu-east"));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::IsValueAllowedTest4(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setAllowedRange(1, 65535);
+
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("1"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("8080"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("65535"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("0"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("65536"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("80a"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed(" 80"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed(""));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("99999999999999999999"));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::IsValueAllowedTest5(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setAllowedPattern("[a-z]+-[0-9]+");
+
+    CommandLineSpecification::OptionDetails copied_details = details;
+
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("codec-264"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("codec-264x"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("codec"));
+    ISHIKO_TEST_FAIL_IF_NOT(copied_details.isValueAllowed("codec-264"));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::IsValueAllowedTest6(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setAllowedValues({"auto"});
+    details.setAllowedRange(1, 64);
+
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("auto"));
+    ISHIKO_TEST_FAIL_IF_NOT(details.isValueAllowed("16"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("128"));
+    ISHIKO_TEST_FAIL_IF(details.isValueAllowed("manual"));
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::CreateDefaultConfigurationTest5(Test& test)
+{
+    CommandLineSpecification spec;
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value, "8080");
+    details.setValueType(Configuration::Value::Type::integer);
+    spec.addNamedOption("port", details);
+
+    Configuration configuration = spec.createDefaultConfiguration();
+
+    ISHIKO_TEST_ABORT_IF_NEQ(configuration.value("port").type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("port").asInt(), 8080);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::SetValueTypeTest1(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+
+    size_t errors = 0;
+    for (Configuration::Value::Type type :
+        {Configuration::Value::Type::string_array, Configuration::Value::Type::configuration})
+    {
+        try
+        {
+            details.setValueType(type);
+        }
+        catch (const std::invalid_argument&)
+        {
+            ++errors;
+        }
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(details.valueType(), Configuration::Value::Type::string);
+    ISHIKO_TEST_PASS();
+}
+
+void CommandLineSpecificationTests::CreateValueTest1(Test& test)
+{
+    CommandLineSpecification::OptionDetails details(CommandLineSpecification::OptionType::single_value);
+    details.setValueType(Configuration::Value::Type::integer);
+
+    Configuration::Value value = details.createValue("8080");
+    bool error = false;
+    try
+    {
+        details.createValue("abc");
+    }
+    catch (const std::invalid_argument&)
+    {
+        error = true;
+    }
+
+    ISHIKO_TEST_ABORT_IF_NEQ(value.type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asInt(), 8080);
+    ISHIKO_TEST_FAIL_IF_NOT(error);
+    ISHIKO_TEST_PASS();
+}
@@ -21,6 +21,19 @@ private:
     static void CreateDefaultConfigurationTest2(Ishiko::Test& test);
     static void CreateDefaultConfigurationTest3(Ishiko::Test& test);
     static void CreateDefaultConfigurationTest4(Ishiko::Test& test);
+    static void FindPositionalOptionTest1(Ishiko::Test& test);
+    static void FindNamedOptionTest1(Ishiko::Test& test);
+    static void FindShortNamedOptionTest1(Ishiko::Test& test);
+    static void FindCommandTest1(Ishiko::Test& test);
+    static void IsValueAllowedTest1(Ishiko::Test& test);
+    static void IsValueAllowedTest2(Ishiko::Test& test);
+    static void IsValueAllowedTest3(Ishiko::Test& test);
+    static void IsValueAllowedTest4(Ishiko::Test& test);
+    static void IsValueAllowedTest5(Ishiko::Test& test);
+    static void IsValueAllowedTest6(Ishiko::Test& test);
+    static void CreateDefaultConfigurationTest5(Ishiko::Test& test);
+    static void SetValueTypeTest1(Ishiko::Test& test);
+    static void CreateValueTest1(Ishiko::Test& test);
 };
 
 #endif
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CompiledCommandLineSpecificationTests.hpp"
+#include "Ishiko/Configuration/CompiledCommandLineSpecification.hpp"
+#include <string>
+
+using namespace Ishiko;
+
+CompiledCommandLineSpecificationTests::CompiledCommandLineSpecificationTests(const TestNumber& number,
+    const TestContext& context)
+    : TestSequence(number, "CompiledCommandLineSpecification tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("createDefaultConfiguration test 1", CreateDefaultConfigurationTest1);
+    append<HeapAllocationErrorsTest>("findPositionalOption test 1", FindPositionalOptionTest1);
+    append<HeapAllocationErrorsTest>("findNamedOption test 1", FindNamedOptionTest1);
+    append<HeapAllocationErrorsTest>("findShortNamedOption test 1", FindShortNamedOptionTest1);
+    append<HeapAllocationErrorsTest>("findCommand test 1", FindCommandTest1);
+    append<HeapAllocationErrorsTest>("findCommand test 2", FindCommandTest2);
+    append<HeapAllocationErrorsTest>("findCommand test 3", FindCommandTest3);
+    append<HeapAllocationErrorsTest>("findDefaultValue test 1", FindDefaultValueTest1);
+}
+
+void CompiledCommandLineSpecificationTests::ConstructorTest1(Test& test)
+{
+    CompiledCommandLineSpecification spec;
+
+    ISHIKO_TEST_FAIL_IF(spec.findNamedOption("option1"));
+    ISHIKO_TEST_FAIL_IF(spec.findPositionalOption(spec.root(), 1));
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::CreateDefaultConfigurationTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default1"});
+    spec.addNamedOption("option2", {CommandLineSpecification::OptionType::single_value});
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+    Configuration configuration = compiled_spec.createDefaultConfiguration();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "default1");
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindPositionalOptionTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "option1", {CommandLineSpecification::OptionType::single_value});
+    spec.addPositionalOption(3, "option3", {CommandLineSpecification::OptionType::single_value});
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+    const CompiledCommandLineSpecification::Option* option1 =
+        compiled_spec.findPositionalOption(compiled_spec.root(), 1);
+    const CompiledCommandLineSpecification::Option* option2 =
+        compiled_spec.findPositionalOption(compiled_spec.root(), 2);
+    const CompiledCommandLineSpecification::Option* option3 =
+        compiled_spec.findPositionalOption(compiled_spec.root(), 3);
+
+    ISHIKO_TEST_ABORT_IF_NOT(option1);
+    ISHIKO_TEST_FAIL_IF_NEQ(option1->name, "option1");
+    ISHIKO_TEST_FAIL_IF(option2);
+    ISHIKO_TEST_ABORT_IF_NOT(option3);
+    ISHIKO_TEST_FAIL_IF_NEQ(option3->name, "option3");
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindNamedOptionTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", {CommandLineSpecification::OptionType::single_value, "default1"});
+    spec.addNamedOption("option2", {CommandLineSpecification::OptionType::single_value});
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+    const CompiledCommandLineSpecification::Option* option1 = compiled_spec.findNamedOption("option1");
+    const CompiledCommandLineSpecification::Option* option2 = compiled_spec.findNamedOption("option2");
+    const CompiledCommandLineSpecification::Option* option3 = compiled_spec.findNamedOption("option3");
+
+    ISHIKO_TEST_ABORT_IF_NOT(option1);
+    ISHIKO_TEST_FAIL_IF_NEQ(option1->name, "option1");
+    ISHIKO_TEST_FAIL_IF_NEQ(*option1->details.defaultValue(), "default1");
+    ISHIKO_TEST_ABORT_IF_NOT(option2);
+    ISHIKO_TEST_FAIL_IF_NEQ(option2->name, "option2");
+    ISHIKO_TEST_FAIL_IF(option3);
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindShortNamedOptionTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addNamedOption("option1", "o", {CommandLineSpecification::OptionType::single_value});
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+    const CompiledCommandLineSpecification::Option* option = compiled_spec.findShortNamedOption("o");
+
+    ISHIKO_TEST_ABORT_IF_NOT(option);
+    ISHIKO_TEST_FAIL_IF_NEQ(option->name, "option1");
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findShortNamedOption("p"));
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindCommandTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    spec.addCommand("command", "command1");
+    spec.addCommand("command", "command2");
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    ISHIKO_TEST_FAIL_IF_NOT(compiled_spec.findCommand(compiled_spec.root(), "command", "command1"));
+    ISHIKO_TEST_FAIL_IF_NOT(compiled_spec.findCommand(compiled_spec.root(), "command", "command2"));
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findCommand(compiled_spec.root(), "command", "command3"));
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindCommandTest2(Test& test)
+{
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    CommandLineSpecification::CommandDetails& command_details = spec.addCommand("command", "command1", "subcommand1");
+    command_details.addPositionalOption(3, "subcommand1_option1", {CommandLineSpecification::OptionType::single_value});
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+    const CompiledCommandLineSpecification::Command* command =
+        compiled_spec.findCommand(compiled_spec.root(), "command", "command1");
+
+    ISHIKO_TEST_ABORT_IF_NOT(command);
+
+    const CompiledCommandLineSpecification::Command* subcommand =
+        compiled_spec.findCommand(*command, "subcommand", "subcommand1");
+
+    ISHIKO_TEST_ABORT_IF_NOT(subcommand);
+
+    const CompiledCommandLineSpecification::Option* option = compiled_spec.findPositionalOption(*subcommand, 3);
+
+    ISHIKO_TEST_ABORT_IF_NOT(option);
+    ISHIKO_TEST_FAIL_IF_NEQ(option->name, "subcommand1_option1");
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findPositionalOption(*command, 3));
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindCommandTest3(Test& test)
+{
+    // Enough commands that they are looked up in the hash table rather than searched linearly
+    CommandLineSpecification spec;
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    for (size_t i = 1; i <= 20; ++i)
+    {
+        spec.addCommand("command", "command" + std::to_string(i));
+    }
+    spec.addCommand("command", "command1", "command2");
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+
+    for (size_t i = 1; i <= 20; ++i)
+    {
+        ISHIKO_TEST_FAIL_IF_NOT(compiled_spec.findCommand(compiled_spec.root(), "command",
+            "command" + std::to_string(i)));
+    }
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findCommand(compiled_spec.root(), "command", "command21"));
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findCommand(compiled_spec.root(), "subcommand", "command1"));
+
+    const CompiledCommandLineSpecification::Command* command =
+        compiled_spec.findCommand(compiled_spec.root(), "command", "command1");
+
+    ISHIKO_TEST_ABORT_IF_NOT(command);
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findCommand(*command, "command", "command2"));
+    ISHIKO_TEST_FAIL_IF_NOT(compiled_spec.findCommand(*command, "subcommand", "command2"));
+    ISHIKO_TEST_PASS();
+}
+
+void CompiledCommandLineSpecificationTests::FindDefaultValueTest1(Test& test)
+{
+    CommandLineSpecification spec;
+    CommandLineSpecification::OptionDetails port_details(CommandLineSpecification::OptionType::single_value, "8080");
+    port_details.setValueType(Configuration::Value::Type::integer);
+    spec.addNamedOption("port", port_details);
+    spec.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    spec.addPositionalOption(3, "output", {CommandLineSpecification::OptionType::single_value, "out.txt"});
+    CommandLineSpecification::CommandDetails& command_details = spec.addCommand("command", "command1");
+    command_details.addPositionalOption(2, "input", {CommandLineSpecification::OptionType::single_value, "in.txt"});
+
+    CompiledCommandLineSpecification compiled_spec = spec.compile();
+    const CompiledCommandLineSpecification::Command* command =
+        compiled_spec.findCommand(compiled_spec.root(), "command", "command1");
+
+    ISHIKO_TEST_ABORT_IF_NOT(command);
+
+    const Configuration::Value* port = compiled_spec.findDefaultValue(compiled_spec.root(), "port");
+    const Configuration::Value* output = compiled_spec.findDefaultValue(compiled_spec.root(), "output");
+    const Configuration::Value* input = compiled_spec.findDefaultValue(*command, "input");
+
+    ISHIKO_TEST_ABORT_IF_NOT(port);
+    ISHIKO_TEST_FAIL_IF_NEQ(port->asInt(), 8080);
+    ISHIKO_TEST_ABORT_IF_NOT(output);
+    ISHIKO_TEST_FAIL_IF_NEQ(output->asString(), "out.txt");
+    ISHIKO_TEST_ABORT_IF_NOT(input);
+    ISHIKO_TEST_FAIL_IF_NEQ(input->asString(), "in.txt");
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findDefaultValue(compiled_spec.root(), "command"));
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findDefaultValue(compiled_spec.root(), "input"));
+    ISHIKO_TEST_FAIL_IF(compiled_spec.findDefaultValue(*command, "port"));
+    ISHIKO_TEST_PASS();
+}
@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_COMPILEDCOMMANDLINESPECIFICATIONTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_COMPILEDCOMMANDLINESPECIFICATIONTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class CompiledCommandLineSpecificationTests : public Ishiko::TestSequence
+{
+public:
+    CompiledCommandLineSpecificationTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void CreateDefaultConfigurationTest1(Ishiko::Test& test);
+    static void FindPositionalOptionTest1(Ishiko::Test& test);
+    static void FindNamedOptionTest1(Ishiko::Test& test);
+    static void FindShortNamedOptionTest1(Ishiko::Test& test);
+    static void FindCommandTest1(Ishiko::Test& test);
+    static void FindCommandTest2(Ishiko::Test& test);
+    static void FindCommandTest3(Ishiko::Test& test);
+    static void FindDefaultValueTest1(Ishiko::Test& test);
+};
+
+#endif
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationArenaTests.hpp"
+#include "Ishiko/Configuration/Configuration.hpp"
+#include "Ishiko/Configuration/ConfigurationArena.hpp"
+#include <cstdint>
+
+using namespace Ishiko;
+
+ConfigurationArenaTests::ConfigurationArenaTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "ConfigurationArena tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("allocate test 1", AllocateTest1);
+    append<HeapAllocationErrorsTest>("allocate test 2", AllocateTest2);
+    append<HeapAllocationErrorsTest>("release test 1", ReleaseTest1);
+    append<HeapAllocationErrorsTest>("Configuration test 1", ConfigurationTest1);
+    append<HeapAllocationErrorsTest>("Configuration test 2", ConfigurationTest2);
+}
+
+void ConfigurationArenaTests::ConstructorTest1(Test& test)
+{
+    ConfigurationArena arena;
+
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.size(), 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.capacity(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationArenaTests::AllocateTest1(Test& test)
+{
+    ConfigurationArena arena(256);
+
+    char* p1 = static_cast<char*>(arena.allocate(1, 1));
+    void* p2 = arena.allocate(8, 8);
+    void* p3 = arena.allocate(16, 16);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(reinterpret_cast<uintptr_t>(p2) % 8, 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(reinterpret_cast<uintptr_t>(p3) % 16, 0);
+    ISHIKO_TEST_FAIL_IF_NOT(static_cast<char*>(p2) > p1);
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.size(), 25);
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.capacity(), 256);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationArenaTests::AllocateTest2(Test& test)
+{
+    ConfigurationArena arena(64);
+
+    // Larger than the block size
+    void* p1 = arena.allocate(1000, 8);
+    void* p2 = arena.allocate(1000, 8);
+
+    ISHIKO_TEST_FAIL_IF_EQ(p1, p2);
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.size(), 2000);
+    ISHIKO_TEST_FAIL_IF_NOT(arena.capacity() >= 2000);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationArenaTests::ReleaseTest1(Test& test)
+{
+    ConfigurationArena arena(64);
+    arena.allocate(100, 8);
+    arena.allocate(1000, 8);
+    size_t capacity = arena.capacity();
+
+    arena.release();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.size(), 0);
+    ISHIKO_TEST_FAIL_IF_NOT(arena.capacity() < capacity);
+    ISHIKO_TEST_FAIL_IF_NOT(arena.capacity() >= 1000);
+
+    // The kept block is reused
+    capacity = arena.capacity();
+    arena.allocate(500, 8);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.capacity(), capacity);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationArenaTests::ConfigurationTest1(Test& test)
+{
+    ConfigurationArena arena;
+
+    {
+        Configuration configuration(&arena);
+        configuration.set("key2", "value2");
+        configuration.set("key1", "value1");
+        configuration.set(Configuration::Path("key3.key4"), "value4");
+
+        ISHIKO_TEST_FAIL_IF_NEQ(configuration.arena(), &arena);
+        ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key3").asConfiguration().arena(), &arena);
+        ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 3);
+        ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value1");
+        ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("key3.key4")).asString(), "value4");
+        ISHIKO_TEST_FAIL_IF_EQ(arena.size(), 0);
+    }
+
+    arena.release();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(arena.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationArenaTests::ConfigurationTest2(Test& test)
+{
+    ConfigurationArena arena;
+    Configuration configuration(&arena);
+    configuration.set("key1", "value1");
+
+    Configuration copy = configuration;
+    size_t size = arena.size();
+    copy.set("key2", "value2");
+
+    // The copy detaches its options into the same arena
+    ISHIKO_TEST_FAIL_IF_NEQ(copy.arena(), &arena);
+    ISHIKO_TEST_FAIL_IF_NOT(arena.size() > size);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(copy.size(), 2);
+    ISHIKO_TEST_PASS();
+}
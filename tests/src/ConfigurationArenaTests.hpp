@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONARENATESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONARENATESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class ConfigurationArenaTests : public Ishiko::TestSequence
+{
+public:
+    ConfigurationArenaTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void AllocateTest1(Ishiko::Test& test);
+    static void AllocateTest2(Ishiko::Test& test);
+    static void ReleaseTest1(Ishiko::Test& test);
+    static void ConfigurationTest1(Ishiko::Test& test);
+    static void ConfigurationTest2(Ishiko::Test& test);
+};
+
+#endif
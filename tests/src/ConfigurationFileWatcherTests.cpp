@@ -0,0 +1,269 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationFileWatcherTests.hpp"
+#include "Ishiko/Configuration/ConfigurationFileWatcher.hpp"
+#include "Ishiko/Configuration/ConfigurationSubscriptions.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+void WriteFile(const std::string& file_path, const std::string& content)
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+// Stores the content of the file as the "content" option
+Configuration LoadContent(const std::string& file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (content == "invalid")
+    {
+        throw std::runtime_error("invalid content");
+    }
+    Configuration result;
+    result.set("content", content);
+    return result;
+}
+
+}
+
+ConfigurationFileWatcherTests::ConfigurationFileWatcherTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "ConfigurationFileWatcher tests", context)
+{
+    append<HeapAllocationErrorsTest>("reload test 1", ReloadTest1);
+    append<HeapAllocationErrorsTest>("reload test 2", ReloadTest2);
+    append<HeapAllocationErrorsTest>("reload test 3", ReloadTest3);
+    append<HeapAllocationErrorsTest>("reload test 4", ReloadTest4);
+    append<HeapAllocationErrorsTest>("start test 1", StartTest1);
+    append<HeapAllocationErrorsTest>("start test 2", StartTest2);
+}
+
+void ConfigurationFileWatcherTests::ReloadTest1(Test& test)
+{
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest1_a.txt", "a1");
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest1_b.txt", "b1");
+
+    ConfigurationStore store(Configuration{});
+    ConfigurationFileWatcher watcher(store, std::chrono::milliseconds(10));
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest1_a.txt", Configuration::Path("fragments.a"),
+        LoadContent);
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest1_b.txt", Configuration::Path("fragments.b"),
+        LoadContent);
+
+    size_t loaded1 = watcher.reload();
+    const Configuration snapshot1 = *store.read();
+
+    // The size changes so that the change is seen even if the modification time has a coarse resolution
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest1_a.txt", "a22");
+    size_t loaded2 = watcher.reload();
+    const Configuration snapshot2 = *store.read();
+
+    size_t loaded3 = watcher.reload();
+
+    std::remove("ConfigurationFileWatcherTests_ReloadTest1_a.txt");
+    std::remove("ConfigurationFileWatcherTests_ReloadTest1_b.txt");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(loaded1, 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(loaded2, 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(loaded3, 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(snapshot1.value(Configuration::Path("fragments.a.content")).asString(), "a1");
+    ISHIKO_TEST_FAIL_IF_NEQ(snapshot2.value(Configuration::Path("fragments.a.content")).asString(), "a22");
+    ISHIKO_TEST_FAIL_IF_NEQ(snapshot2.value(Configuration::Path("fragments.b.content")).asString(), "b1");
+    // The subtree of the file that didn't change is shared with the previous snapshot
+    const Configuration& b1 = snapshot1.value(Configuration::Path("fragments.b")).asConfiguration();
+    const Configuration& b2 = snapshot2.value(Configuration::Path("fragments.b")).asConfiguration();
+    ISHIKO_TEST_FAIL_IF_NEQ(&*b1.begin(), &*b2.begin());
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationFileWatcherTests::ReloadTest2(Test& test)
+{
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest2.txt", "value1");
+
+    ConfigurationStore store(Configuration{});
+    ConfigurationFileWatcher watcher(store, std::chrono::milliseconds(10));
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest2.txt", Configuration::Path("file"), LoadContent);
+    size_t errors = 0;
+    std::string error_file_path;
+    watcher.setErrorHandler(
+        [&errors, &error_file_path](const std::string& file_path, std::exception_ptr)
+        {
+            ++errors;
+            error_file_path = file_path;
+        });
+
+    watcher.reload();
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest2.txt", "invalid");
+    size_t loaded = watcher.reload();
+
+    std::remove("ConfigurationFileWatcherTests_ReloadTest2.txt");
+
+    // The previous configuration of the file is kept
+    ISHIKO_TEST_FAIL_IF_NEQ(loaded, 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(error_file_path, "ConfigurationFileWatcherTests_ReloadTest2.txt");
+    ISHIKO_TEST_FAIL_IF_NEQ(store.read()->value(Configuration::Path("file.content")).asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationFileWatcherTests::ReloadTest4(Test& test)
+{
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest4_a.txt", "a1");
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest4_b.txt", "invalid");
+
+    ConfigurationStore store(Configuration{});
+    ConfigurationFileWatcher watcher(store, std::chrono::milliseconds(10));
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest4_a.txt", Configuration::Path("a"), LoadContent);
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest4_b.txt", Configuration::Path("b"), LoadContent);
+
+    // The handlers call back into the watcher, which must not deadlock
+    size_t errors = 0;
+    watcher.setErrorHandler(
+        [&watcher, &errors](const std::string&, std::exception_ptr)
+        {
+            ++errors;
+            watcher.setErrorHandler(nullptr);
+        });
+    size_t reloads = 0;
+    size_t nested_loaded = 1;
+    watcher.setReloadHandler(
+        [&watcher, &reloads, &nested_loaded](const Configuration&)
+        {
+            ++reloads;
+            nested_loaded = watcher.reload();
+            watcher.setReloadHandler(nullptr);
+        });
+    size_t loaded = watcher.reload();
+
+    std::remove("ConfigurationFileWatcherTests_ReloadTest4_a.txt");
+    std::remove("ConfigurationFileWatcherTests_ReloadTest4_b.txt");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(loaded, 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(reloads, 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(nested_loaded, 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(store.read()->value(Configuration::Path("a.content")).asString(), "a1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationFileWatcherTests::StartTest1(Test& test)
+{
+    WriteFile("ConfigurationFileWatcherTests_StartTest1.txt", "value1");
+
+    ConfigurationStore store(Configuration{});
+    ConfigurationFileWatcher watcher(store, std::chrono::milliseconds(20));
+    watcher.addFile("ConfigurationFileWatcherTests_StartTest1.txt", Configuration::Path("file"), LoadContent);
+    watcher.start();
+
+    uint64_t version1 = store.read().version();
+
+    // A burst of writes
+    WriteFile("ConfigurationFileWatcherTests_StartTest1.txt", "value2");
+    WriteFile("ConfigurationFileWatcherTests_StartTest1.txt", "value33");
+    WriteFile("ConfigurationFileWatcherTests_StartTest1.txt", "value444");
+
+    std::chrono::steady_clock::time_point deadline = (std::chrono::steady_clock::now() + std::chrono::seconds(5));
+    while ((store.read()->value(Configuration::Path("file.content")).asString() != "value444")
+        && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    uint64_t version2 = store.read().version();
+    watcher.stop();
+
+    std::remove("ConfigurationFileWatcherTests_StartTest1.txt");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(version1, 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(store.read()->value(Configuration::Path("file.content")).asString(), "value444");
+    // The writes were debounced into a single reload
+    ISHIKO_TEST_FAIL_IF_NEQ(version2, 3);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationFileWatcherTests::ReloadTest3(Test& test)
+{
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest3_a.txt", "a1");
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest3_b.txt", "b1");
+
+    ConfigurationStore store(Configuration{});
+    ConfigurationFileWatcher watcher(store, std::chrono::milliseconds(10));
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest3_a.txt", Configuration::Path("a"), LoadContent);
+    watcher.addFile("ConfigurationFileWatcherTests_ReloadTest3_b.txt", Configuration::Path("b"), LoadContent);
+    watcher.reload();
+
+    ConfigurationSubscriptions subscriptions(*store.read());
+    watcher.setReloadHandler(
+        [&subscriptions](const Configuration& configuration)
+        {
+            subscriptions.update(configuration);
+        });
+    size_t a_calls = 0;
+    size_t b_calls = 0;
+    subscriptions.subscribe("a.*",
+        [&a_calls](const Configuration&, const std::vector<const ConfigurationPatch::Change*>&)
+        {
+            ++a_calls;
+        });
+    subscriptions.subscribe("b.*",
+        [&b_calls](const Configuration&, const std::vector<const ConfigurationPatch::Change*>&)
+        {
+            ++b_calls;
+        });
+
+    WriteFile("ConfigurationFileWatcherTests_ReloadTest3_b.txt", "b22");
+    watcher.reload();
+
+    std::remove("ConfigurationFileWatcherTests_ReloadTest3_a.txt");
+    std::remove("ConfigurationFileWatcherTests_ReloadTest3_b.txt");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(a_calls, 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(b_calls, 1);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationFileWatcherTests::StartTest2(Test& test)
+{
+    WriteFile("ConfigurationFileWatcherTests_StartTest2.txt", "value1");
+
+    ConfigurationStore store(Configuration{});
+    ConfigurationFileWatcher watcher(store, std::chrono::milliseconds(20));
+    // The file changes right after the initial load, before the background thread has started
+    size_t load_count = 0;
+    watcher.addFile("ConfigurationFileWatcherTests_StartTest2.txt", Configuration::Path("file"),
+        [&load_count](const std::string& file_path)
+        {
+            Configuration result = LoadContent(file_path);
+            if (++load_count == 1)
+            {
+                WriteFile(file_path, "value22");
+            }
+            return result;
+        });
+    watcher.start();
+
+    std::chrono::steady_clock::time_point deadline = (std::chrono::steady_clock::now() + std::chrono::seconds(5));
+    while ((store.read()->value(Configuration::Path("file.content")).asString() != "value22")
+        && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    watcher.stop();
+
+    std::remove("ConfigurationFileWatcherTests_StartTest2.txt");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(store.read()->value(Configuration::Path("file.content")).asString(), "value22");
+    ISHIKO_TEST_PASS();
+}
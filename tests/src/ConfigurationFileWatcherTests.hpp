@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONFILEWATCHERTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONFILEWATCHERTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class ConfigurationFileWatcherTests : public Ishiko::TestSequence
+{
+public:
+    ConfigurationFileWatcherTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ReloadTest1(Ishiko::Test& test);
+    static void ReloadTest2(Ishiko::Test& test);
+    static void ReloadTest3(Ishiko::Test& test);
+    static void ReloadTest4(Ishiko::Test& test);
+    static void StartTest1(Ishiko::Test& test);
+    static void StartTest2(Ishiko::Test& test);
+};
+
+#endif
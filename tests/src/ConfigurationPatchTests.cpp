@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationPatchTests.hpp"
+#include "Ishiko/Configuration/ConfigurationPatch.hpp"
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+ConfigurationPatchTests::ConfigurationPatchTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "ConfigurationPatch tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("Diff test 1", DiffTest1);
+    append<HeapAllocationErrorsTest>("Diff test 2", DiffTest2);
+    append<HeapAllocationErrorsTest>("Diff test 3", DiffTest3);
+    append<HeapAllocationErrorsTest>("Diff test 4", DiffTest4);
+    append<HeapAllocationErrorsTest>("apply test 1", ApplyTest1);
+}
+
+void ConfigurationPatchTests::ConstructorTest1(Test& test)
+{
+    ConfigurationPatch patch;
+
+    ISHIKO_TEST_FAIL_IF_NOT(patch.empty());
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes().size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationPatchTests::DiffTest1(Test& test)
+{
+    Configuration from;
+    from.set("key1", "value1");
+    from.set("key2", "value2");
+    from.set("key3", "value3");
+    Configuration to;
+    to.set("key2", "value2");
+    to.set("key3", "new value3");
+    to.set("key4", "value4");
+
+    ConfigurationPatch patch = ConfigurationPatch::Diff(from, to);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(patch.changes().size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].type, ConfigurationPatch::Change::Type::removed);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].path, std::vector<std::string>({"key1"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[1].type, ConfigurationPatch::Change::Type::modified);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[1].path, std::vector<std::string>({"key3"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[1].value.asString(), "new value3");
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[2].type, ConfigurationPatch::Change::Type::added);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[2].path, std::vector<std::string>({"key4"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[2].value.asString(), "value4");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationPatchTests::DiffTest2(Test& test)
+{
+    Configuration from;
+    from.set(Configuration::Path("server.port"), "80");
+    from.set(Configuration::Path("server.host"), "localhost");
+    from.set("log", "info");
+    Configuration to = from;
+    to.set(Configuration::Path("server.port"), "8080");
+
+    ConfigurationPatch patch = ConfigurationPatch::Diff(from, to);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(patch.changes().size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].type, ConfigurationPatch::Change::Type::modified);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].path, std::vector<std::string>({"server", "port"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].value.asString(), "8080");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationPatchTests::DiffTest3(Test& test)
+{
+    Configuration from;
+    from.set(Configuration::Path("server.port"), "80");
+    Configuration to = from;
+
+    ConfigurationPatch patch = ConfigurationPatch::Diff(from, to);
+
+    ISHIKO_TEST_FAIL_IF_NOT(patch.empty());
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationPatchTests::DiffTest4(Test& test)
+{
+    // A value that changes type is a modification, even to or from a nested configuration
+    Configuration from;
+    from.set("key1", "value1");
+    from.set(Configuration::Path("key2.key3"), "value3");
+    Configuration to;
+    to.set(Configuration::Path("key1.key4"), "value4");
+    to.set("key2", std::vector<std::string>({"value2"}));
+
+    ConfigurationPatch patch = ConfigurationPatch::Diff(from, to);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(patch.changes().size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].type, ConfigurationPatch::Change::Type::modified);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].path, std::vector<std::string>({"key1"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[0].value.asConfiguration().value("key4").asString(), "value4");
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[1].type, ConfigurationPatch::Change::Type::modified);
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[1].path, std::vector<std::string>({"key2"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes()[1].value.asStringArray(), std::vector<std::string>({"value2"}));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationPatchTests::ApplyTest1(Test& test)
+{
+    Configuration from;
+    from.set(Configuration::Path("server.port"), "80");
+    from.set(Configuration::Path("server.host"), "localhost");
+    from.set("log", "info");
+    from.set("removed", "value");
+    Configuration to;
+    to.set(Configuration::Path("server.port"), "8080");
+    to.set(Configuration::Path("server.host"), "localhost");
+    to.set(Configuration::Path("server.tls.enabled"), "true");
+    to.set("log", "info");
+
+    ConfigurationPatch patch = ConfigurationPatch::Diff(from, to);
+    Configuration configuration = from;
+    patch.apply(configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(patch.changes().size(), 3);
+    ISHIKO_TEST_FAIL_IF_NOT(ConfigurationPatch::Diff(configuration, to).empty());
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull("removed"));
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.enabled")).asString(), "true");
+    ISHIKO_TEST_PASS();
+}
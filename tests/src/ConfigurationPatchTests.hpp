@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONPATCHTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONPATCHTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class ConfigurationPatchTests : public Ishiko::TestSequence
+{
+public:
+    ConfigurationPatchTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void DiffTest1(Ishiko::Test& test);
+    static void DiffTest2(Ishiko::Test& test);
+    static void DiffTest3(Ishiko::Test& test);
+    static void DiffTest4(Ishiko::Test& test);
+    static void ApplyTest1(Ishiko::Test& test);
+};
+
+#endif
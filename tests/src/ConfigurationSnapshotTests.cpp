@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationSnapshotTests.hpp"
+#include "Ishiko/Configuration/ConfigurationPatch.hpp"
+#include "Ishiko/Configuration/ConfigurationSnapshot.hpp"
+#include <boost/variant/get.hpp>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+Configuration CreateConfiguration()
+{
+    Configuration tls;
+    tls.set("cert", "server.pem");
+    tls.set("enabled", Configuration::Value(true));
+
+    Configuration server;
+    server.set("hosts", std::vector<std::string>({"a.example.com", "b.example.com", "server.pem"}));
+    server.set("port", Configuration::Value(int64_t(8080)));
+    server.set("ratio", Configuration::Value(0.5));
+    server.set("timeout", Configuration::Value(std::chrono::nanoseconds(std::chrono::seconds(30))));
+    server.set("tls", tls);
+    server.set("buffer", Configuration::Value(uint64_t(65536)));
+
+    Configuration result;
+    result.set("name", "test");
+    result.set("server", server);
+    return result;
+}
+
+}
+
+ConfigurationSnapshotTests::ConfigurationSnapshotTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "ConfigurationSnapshot tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("Constructor test 2", ConstructorTest2);
+    append<HeapAllocationErrorsTest>("value test 1", ValueTest1);
+    append<HeapAllocationErrorsTest>("value test 2", ValueTest2);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 1", ValueOrDefaultTest1);
+    append<HeapAllocationErrorsTest>("valueOrNull test 1", ValueOrNullTest1);
+    append<HeapAllocationErrorsTest>("valueOrNull test 2", ValueOrNullTest2);
+    append<HeapAllocationErrorsTest>("toConfiguration test 1", ToConfigurationTest1);
+    append<HeapAllocationErrorsTest>("Write test 1", WriteTest1);
+}
+
+void ConfigurationSnapshotTests::ConstructorTest1(Test& test)
+{
+    ConfigurationSnapshot::Write(Configuration(), "ConfigurationSnapshotTests_ConstructorTest1.snapshot");
+
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ConstructorTest1.snapshot");
+
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.root().size(), 0);
+        ISHIKO_TEST_FAIL_IF(snapshot.valueOrNull("name"));
+    }
+
+    std::remove("ConfigurationSnapshotTests_ConstructorTest1.snapshot");
+
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ConstructorTest2(Test& test)
+{
+    // A file that isn't a snapshot, and a snapshot that was truncated
+    std::string content = ConfigurationSnapshot::Compile(CreateConfiguration());
+    std::vector<std::string> invalid_files = {"{\"name\": \"test\"}", content.substr(0, content.size() - 1)};
+
+    size_t errors = 0;
+    for (const std::string& invalid_file : invalid_files)
+    {
+        {
+            std::ofstream file("ConfigurationSnapshotTests_ConstructorTest2.snapshot",
+                std::ios::binary | std::ios::trunc);
+            file << invalid_file;
+        }
+        try
+        {
+            ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ConstructorTest2.snapshot");
+        }
+        catch (const std::runtime_error&)
+        {
+            ++errors;
+        }
+    }
+
+    std::remove("ConfigurationSnapshotTests_ConstructorTest2.snapshot");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, invalid_files.size());
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ValueTest1(Test& test)
+{
+    ConfigurationSnapshot::Write(CreateConfiguration(), "ConfigurationSnapshotTests_ValueTest1.snapshot");
+
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ValueTest1.snapshot");
+
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.root().size(), 2);
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.value("name").asString(), "test");
+
+        ConfigurationSnapshot::Table server = snapshot.value("server").asConfiguration();
+        ISHIKO_TEST_FAIL_IF_NEQ(server.size(), 6);
+        ISHIKO_TEST_FAIL_IF_NEQ(server.nameAt(0), "buffer");
+        ISHIKO_TEST_FAIL_IF_NEQ(server.value("buffer").asSize(), 65536);
+        ISHIKO_TEST_FAIL_IF_NEQ(server.value("port").asInt(), 8080);
+        ISHIKO_TEST_FAIL_IF_NEQ(server.value("ratio").asDouble(), 0.5);
+        ISHIKO_TEST_FAIL_IF(server.value("timeout").asDuration() != std::chrono::seconds(30));
+
+        ConfigurationSnapshot::StringArray hosts = server.value("hosts").asStringArray();
+        ISHIKO_TEST_FAIL_IF_NEQ(hosts.size(), 3);
+        ISHIKO_TEST_FAIL_IF_NEQ(hosts[0], "a.example.com");
+        ISHIKO_TEST_FAIL_IF_NEQ(hosts[1], "b.example.com");
+        ISHIKO_TEST_FAIL_IF_NEQ(hosts[2], "server.pem");
+
+        ConfigurationSnapshot::Table tls = server.value("tls").asConfiguration();
+        ISHIKO_TEST_FAIL_IF_NEQ(tls.value("cert").asString(), "server.pem");
+        ISHIKO_TEST_FAIL_IF_NOT(tls.value("enabled").asBool());
+    }
+
+    std::remove("ConfigurationSnapshotTests_ValueTest1.snapshot");
+
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ValueTest2(Test& test)
+{
+    ConfigurationSnapshot::Write(CreateConfiguration(), "ConfigurationSnapshotTests_ValueTest2.snapshot");
+
+    bool out_of_range_thrown = false;
+    bool bad_get_thrown = false;
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ValueTest2.snapshot");
+
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.value(Configuration::Path("server.tls.cert")).asString(), "server.pem");
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.value(Configuration::Path("server.port")).asInt(), 8080);
+
+        try
+        {
+            snapshot.value(Configuration::Path("server.port.number"));
+        }
+        catch (const std::out_of_range&)
+        {
+            out_of_range_thrown = true;
+        }
+        try
+        {
+            snapshot.value(Configuration::Path("server.port")).asString();
+        }
+        catch (const boost::bad_get&)
+        {
+            bad_get_thrown = true;
+        }
+    }
+
+    std::remove("ConfigurationSnapshotTests_ValueTest2.snapshot");
+
+    ISHIKO_TEST_FAIL_IF_NOT(out_of_range_thrown);
+    ISHIKO_TEST_FAIL_IF_NOT(bad_get_thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ValueOrDefaultTest1(Test& test)
+{
+    ConfigurationSnapshot::Write(CreateConfiguration(), "ConfigurationSnapshotTests_ValueOrDefaultTest1.snapshot");
+
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ValueOrDefaultTest1.snapshot");
+
+        ISHIKO_TEST_FAIL_IF_NEQ(std::string(snapshot.valueOrDefault("name", "default")), "test");
+        ISHIKO_TEST_FAIL_IF_NEQ(std::string(snapshot.valueOrDefault("missing", "default")), "default");
+        ISHIKO_TEST_FAIL_IF_NEQ(
+            std::string(snapshot.valueOrDefault(Configuration::Path("server.tls.cert"), "default")), "server.pem");
+        ISHIKO_TEST_FAIL_IF_NEQ(
+            std::string(snapshot.valueOrDefault(Configuration::Path("server.tls.key"), "default")), "default");
+    }
+
+    std::remove("ConfigurationSnapshotTests_ValueOrDefaultTest1.snapshot");
+
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ValueOrNullTest1(Test& test)
+{
+    ConfigurationSnapshot::Write(CreateConfiguration(), "ConfigurationSnapshotTests_ValueOrNullTest1.snapshot");
+
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ValueOrNullTest1.snapshot");
+
+        ConfigurationSnapshot::Value port = snapshot.valueOrNull(Configuration::Path("server.port"));
+        ISHIKO_TEST_FAIL_IF_NOT(port);
+        ISHIKO_TEST_FAIL_IF(port.type() != Configuration::Value::Type::integer);
+        ISHIKO_TEST_FAIL_IF(snapshot.valueOrNull("aaa"));
+        ISHIKO_TEST_FAIL_IF(snapshot.valueOrNull("zzz"));
+        ISHIKO_TEST_FAIL_IF(snapshot.valueOrNull(Configuration::Path("server.tls.key")));
+        ISHIKO_TEST_FAIL_IF(snapshot.valueOrNull(Configuration::Path("name.first")));
+    }
+
+    std::remove("ConfigurationSnapshotTests_ValueOrNullTest1.snapshot");
+
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ValueOrNullTest2(Test& test)
+{
+    ConfigurationSnapshot::Write(CreateConfiguration(), "ConfigurationSnapshotTests_ValueOrNullTest2.snapshot");
+
+    bool type_thrown = false;
+    bool to_value_thrown = false;
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ValueOrNullTest2.snapshot");
+
+        ConfigurationSnapshot::Value missing = snapshot.valueOrNull(Configuration::Path("server.missing"));
+        try
+        {
+            missing.type();
+        }
+        catch (const boost::bad_get&)
+        {
+            type_thrown = true;
+        }
+        try
+        {
+            missing.toValue();
+        }
+        catch (const boost::bad_get&)
+        {
+            to_value_thrown = true;
+        }
+    }
+
+    std::remove("ConfigurationSnapshotTests_ValueOrNullTest2.snapshot");
+
+    ISHIKO_TEST_FAIL_IF_NOT(type_thrown);
+    ISHIKO_TEST_FAIL_IF_NOT(to_value_thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::ToConfigurationTest1(Test& test)
+{
+    Configuration configuration = CreateConfiguration();
+    ConfigurationSnapshot::Write(configuration, "ConfigurationSnapshotTests_ToConfigurationTest1.snapshot");
+
+    Configuration copy;
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_ToConfigurationTest1.snapshot");
+        copy = snapshot.root().toConfiguration();
+    }
+
+    std::remove("ConfigurationSnapshotTests_ToConfigurationTest1.snapshot");
+
+    ISHIKO_TEST_FAIL_IF_NOT(ConfigurationPatch::Diff(configuration, copy).empty());
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSnapshotTests::WriteTest1(Test& test)
+{
+    ConfigurationSnapshot::Write(CreateConfiguration(), "ConfigurationSnapshotTests_WriteTest1.snapshot");
+
+    {
+        ConfigurationSnapshot snapshot("ConfigurationSnapshotTests_WriteTest1.snapshot");
+
+        // The snapshot that is open keeps its content when a new one is written over it
+        Configuration configuration;
+        configuration.set("name", "new");
+        ConfigurationSnapshot::Write(configuration, "ConfigurationSnapshotTests_WriteTest1.snapshot");
+        ConfigurationSnapshot new_snapshot("ConfigurationSnapshotTests_WriteTest1.snapshot");
+
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.value("name").asString(), "test");
+        ISHIKO_TEST_FAIL_IF_NEQ(snapshot.value(Configuration::Path("server.port")).asInt(), 8080);
+        ISHIKO_TEST_FAIL_IF_NEQ(new_snapshot.root().size(), 1);
+        ISHIKO_TEST_FAIL_IF_NEQ(new_snapshot.value("name").asString(), "new");
+    }
+
+    std::remove("ConfigurationSnapshotTests_WriteTest1.snapshot");
+
+    ISHIKO_TEST_PASS();
+}
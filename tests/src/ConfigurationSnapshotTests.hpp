@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONSNAPSHOTTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONSNAPSHOTTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class ConfigurationSnapshotTests : public Ishiko::TestSequence
+{
+public:
+    ConfigurationSnapshotTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void ConstructorTest2(Ishiko::Test& test);
+    static void ValueTest1(Ishiko::Test& test);
+    static void ValueTest2(Ishiko::Test& test);
+    static void ValueOrDefaultTest1(Ishiko::Test& test);
+    static void ValueOrNullTest1(Ishiko::Test& test);
+    static void ValueOrNullTest2(Ishiko::Test& test);
+    static void ToConfigurationTest1(Ishiko::Test& test);
+    static void WriteTest1(Ishiko::Test& test);
+};
+
+#endif
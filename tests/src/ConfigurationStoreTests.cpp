@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationStoreTests.hpp"
+#include "Ishiko/Configuration/ConfigurationStore.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Ishiko;
+
+ConfigurationStoreTests::ConfigurationStoreTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "ConfigurationStore tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("publish test 1", PublishTest1);
+    append<HeapAllocationErrorsTest>("publish test 2", PublishTest2);
+    append<HeapAllocationErrorsTest>("ReadHandle move test 1", ReadHandleMoveTest1);
+}
+
+void ConfigurationStoreTests::ConstructorTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+
+    ConfigurationStore store(configuration);
+    ConfigurationStore::ReadHandle handle = store.read();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(handle.version(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(handle->value("key1").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationStoreTests::PublishTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    ConfigurationStore store(configuration);
+
+    configuration.set("key1", "value2");
+    store.publish(configuration);
+    ConfigurationStore::ReadHandle handle = store.read();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(handle.version(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ((*handle).value("key1").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationStoreTests::PublishTest2(Test& test)
+{
+    Configuration configuration;
+    configuration.set("version", "1");
+    ConfigurationStore store(configuration);
+
+    // The readers check that each snapshot they see is consistent and that versions never go backwards
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        readers.emplace_back(
+            [&store, &stop, &errors]()
+            {
+                uint64_t last_version = 0;
+                while (!stop)
+                {
+                    ConfigurationStore::ReadHandle handle = store.read();
+                    if ((handle.version() < last_version)
+                        || (handle->value("version").asString() != std::to_string(handle.version())))
+                    {
+                        ++errors;
+                    }
+                    last_version = handle.version();
+                }
+            });
+    }
+
+    for (size_t version = 2; version <= 200; ++version)
+    {
+        Configuration new_configuration;
+        new_configuration.set("version", std::to_string(version));
+        store.publish(new_configuration);
+    }
+    stop = true;
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(store.read().version(), 200);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationStoreTests::ReadHandleMoveTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    ConfigurationStore store(configuration);
+
+    {
+        ConfigurationStore::ReadHandle handle1 = store.read();
+        ConfigurationStore::ReadHandle handle2(std::move(handle1));
+
+        ISHIKO_TEST_FAIL_IF_NEQ(handle2->value("key1").asString(), "value1");
+    }
+
+    // publish would wait forever if the moved handle had not been released exactly once
+    store.publish(Configuration());
+
+    ISHIKO_TEST_FAIL_IF_NEQ(store.read()->size(), 0);
+    ISHIKO_TEST_PASS();
+}
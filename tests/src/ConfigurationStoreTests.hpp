@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONSTORETESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONSTORETESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class ConfigurationStoreTests : public Ishiko::TestSequence
+{
+public:
+    ConfigurationStoreTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void PublishTest1(Ishiko::Test& test);
+    static void PublishTest2(Ishiko::Test& test);
+    static void ReadHandleMoveTest1(Ishiko::Test& test);
+};
+
+#endif
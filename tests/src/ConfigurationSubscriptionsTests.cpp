@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConfigurationSubscriptionsTests.hpp"
+#include "Ishiko/Configuration/ConfigurationSubscriptions.hpp"
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// Records the paths of the changes passed to each call
+struct Recorder
+{
+    void operator()(const Configuration&, const std::vector<const ConfigurationPatch::Change*>& changes)
+    {
+        std::vector<std::string> paths;
+        for (const ConfigurationPatch::Change* change : changes)
+        {
+            std::string path;
+            for (const std::string& segment : change->path)
+            {
+                path += (path.empty() ? "" : ".") + segment;
+            }
+            paths.push_back(path);
+        }
+        calls->push_back(paths);
+    }
+
+    std::vector<std::vector<std::string>>* calls;
+};
+
+}
+
+ConfigurationSubscriptionsTests::ConfigurationSubscriptionsTests(const TestNumber& number,
+    const TestContext& context)
+    : TestSequence(number, "ConfigurationSubscriptions tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("update test 1", UpdateTest1);
+    append<HeapAllocationErrorsTest>("update test 2", UpdateTest2);
+    append<HeapAllocationErrorsTest>("update test 3", UpdateTest3);
+    append<HeapAllocationErrorsTest>("update test 4", UpdateTest4);
+    append<HeapAllocationErrorsTest>("unsubscribe test 1", UnsubscribeTest1);
+}
+
+void ConfigurationSubscriptionsTests::ConstructorTest1(Test& test)
+{
+    ConfigurationSubscriptions subscriptions;
+
+    ISHIKO_TEST_FAIL_IF_NEQ(subscriptions.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSubscriptionsTests::UpdateTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set(Configuration::Path("cache.size"), "10");
+    configuration.set(Configuration::Path("server.port"), "80");
+    ConfigurationSubscriptions subscriptions(configuration);
+
+    std::vector<std::vector<std::string>> size_calls;
+    std::vector<std::vector<std::string>> port_calls;
+    subscriptions.subscribe("cache.size", Recorder{&size_calls});
+    subscriptions.subscribe("server.port", Recorder{&port_calls});
+
+    configuration.set(Configuration::Path("cache.size"), "20");
+    subscriptions.update(configuration);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(size_calls.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(size_calls[0], std::vector<std::string>({"cache.size"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(port_calls.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSubscriptionsTests::UpdateTest2(Test& test)
+{
+    // All the changes under the prefix are passed to a single call
+    Configuration configuration;
+    configuration.set(Configuration::Path("cache.size"), "10");
+    configuration.set(Configuration::Path("cache.ttl"), "60");
+    configuration.set(Configuration::Path("server.port"), "80");
+    ConfigurationSubscriptions subscriptions(configuration);
+
+    std::vector<std::vector<std::string>> cache_calls;
+    std::vector<std::vector<std::string>> all_calls;
+    subscriptions.subscribe("cache.*", Recorder{&cache_calls});
+    subscriptions.subscribe("*", Recorder{&all_calls});
+
+    configuration.set(Configuration::Path("cache.size"), "20");
+    configuration.set(Configuration::Path("cache.ttl"), "120");
+    configuration.set(Configuration::Path("server.port"), "8080");
+    subscriptions.update(configuration);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(cache_calls.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(cache_calls[0], std::vector<std::string>({"cache.size", "cache.ttl"}));
+    ISHIKO_TEST_ABORT_IF_NEQ(all_calls.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(all_calls[0], std::vector<std::string>({"cache.size", "cache.ttl", "server.port"}));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSubscriptionsTests::UpdateTest3(Test& test)
+{
+    // Removing a nested configuration as a whole notifies the subscribers to the options in it
+    Configuration configuration;
+    configuration.set(Configuration::Path("cache.size"), "10");
+    configuration.set(Configuration::Path("server.port"), "80");
+    ConfigurationSubscriptions subscriptions(configuration);
+
+    std::vector<std::vector<std::string>> size_calls;
+    std::vector<std::vector<std::string>> cache_calls;
+    std::vector<std::vector<std::string>> server_calls;
+    subscriptions.subscribe("cache.size", Recorder{&size_calls});
+    subscriptions.subscribe("cache", Recorder{&cache_calls});
+    subscriptions.subscribe("server", Recorder{&server_calls});
+
+    configuration.erase("cache");
+    configuration.set(Configuration::Path("server.port"), "8080");
+    subscriptions.update(configuration);
+
+    ISHIKO_TEST_ABORT_IF_NEQ(size_calls.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(size_calls[0], std::vector<std::string>({"cache"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(cache_calls.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(server_calls.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSubscriptionsTests::UpdateTest4(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    ConfigurationSubscriptions subscriptions(configuration);
+
+    std::vector<std::vector<std::string>> calls;
+    subscriptions.subscribe("key1", Recorder{&calls});
+
+    subscriptions.update(configuration);
+    configuration.set("key2", "value2");
+    subscriptions.update(configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(calls.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationSubscriptionsTests::UnsubscribeTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set(Configuration::Path("cache.size"), "10");
+    ConfigurationSubscriptions subscriptions(configuration);
+
+    std::vector<std::vector<std::string>> calls;
+    ConfigurationSubscriptions::SubscriptionId id = subscriptions.subscribe("cache.size", Recorder{&calls});
+    bool unsubscribed1 = subscriptions.unsubscribe(id);
+    bool unsubscribed2 = subscriptions.unsubscribe(id);
+
+    configuration.set(Configuration::Path("cache.size"), "20");
+    subscriptions.update(configuration);
+
+    ISHIKO_TEST_FAIL_IF_NOT(unsubscribed1);
+    ISHIKO_TEST_FAIL_IF(unsubscribed2);
+    ISHIKO_TEST_FAIL_IF_NEQ(subscriptions.size(), 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(calls.size(), 0);
+    ISHIKO_TEST_PASS();
+}
@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONSUBSCRIPTIONSTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_CONFIGURATIONSUBSCRIPTIONSTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class ConfigurationSubscriptionsTests : public Ishiko::TestSequence
+{
+public:
+    ConfigurationSubscriptionsTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void UpdateTest1(Ishiko::Test& test);
+    static void UpdateTest2(Ishiko::Test& test);
+    static void UpdateTest3(Ishiko::Test& test);
+    static void UpdateTest4(Ishiko::Test& test);
+    static void UnsubscribeTest1(Ishiko::Test& test);
+};
+
+#endif
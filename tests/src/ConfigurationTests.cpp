@@ -3,6 +3,7 @@
 
 #include "ConfigurationTests.hpp"
 #include "Ishiko/Configuration/Configuration.hpp"
+#include <stdexcept>
 #include <vector>
 #include <string>
 
@@ -26,6 +27,46 @@ ConfigurationTests::ConfigurationTests(const TestNumber& number, const TestConte
     append<HeapAllocationErrorsTest>("valueOrDefault test 3", ValueOrDefaultTest3);
     append<HeapAllocationErrorsTest>("valueOrDefault test 4", ValueOrDefaultTest4);
     append<HeapAllocationErrorsTest>("valueOrNull test 1", ValueOrNullTest1);
+    append<HeapAllocationErrorsTest>("set test 6", SetTest6);
+    append<HeapAllocationErrorsTest>("set test 7", SetTest7);
+    append<HeapAllocationErrorsTest>("begin test 1", BeginTest1);
+    append<HeapAllocationErrorsTest>("value test 1", ValueTest1);
+    append<HeapAllocationErrorsTest>("value test 2", ValueTest2);
+    append<HeapAllocationErrorsTest>("value test 3", ValueTest3);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 5", ValueOrDefaultTest5);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 6", ValueOrDefaultTest6);
+    append<HeapAllocationErrorsTest>("valueOrNull test 2", ValueOrNullTest2);
+    append<HeapAllocationErrorsTest>("Path constructor test 1", PathConstructorTest1);
+    append<HeapAllocationErrorsTest>("value test 4", ValueTest4);
+    append<HeapAllocationErrorsTest>("valueOrNull test 3", ValueOrNullTest3);
+    append<HeapAllocationErrorsTest>("set test 8", SetTest8);
+    append<HeapAllocationErrorsTest>("set test 9", SetTest9);
+    append<HeapAllocationErrorsTest>("Value constructor test 5", ValueConstructorTest5);
+    append<HeapAllocationErrorsTest>("Value constructor test 6", ValueConstructorTest6);
+    append<HeapAllocationErrorsTest>("Value::Parse test 1", ValueParseTest1);
+    append<HeapAllocationErrorsTest>("Value::Parse test 2", ValueParseTest2);
+    append<HeapAllocationErrorsTest>("Value::Parse test 3", ValueParseTest3);
+    append<HeapAllocationErrorsTest>("Value::Parse test 4", ValueParseTest4);
+    append<HeapAllocationErrorsTest>("Value::Parse test 5", ValueParseTest5);
+    append<HeapAllocationErrorsTest>("copy test 1", CopyTest1);
+    append<HeapAllocationErrorsTest>("copy test 2", CopyTest2);
+    append<HeapAllocationErrorsTest>("copy test 3", CopyTest3);
+    append<HeapAllocationErrorsTest>("Value constructor test 7", ValueConstructorTest7);
+    append<HeapAllocationErrorsTest>("set test 10", SetTest10);
+    append<HeapAllocationErrorsTest>("set test 11", SetTest11);
+    append<HeapAllocationErrorsTest>("emplace test 1", EmplaceTest1);
+    append<HeapAllocationErrorsTest>("tryEmplace test 1", TryEmplaceTest1);
+    append<HeapAllocationErrorsTest>("tryEmplace test 2", TryEmplaceTest2);
+    append<HeapAllocationErrorsTest>("tryEmplace test 3", TryEmplaceTest3);
+    append<HeapAllocationErrorsTest>("assign test 1", AssignTest1);
+    append<HeapAllocationErrorsTest>("assign test 2", AssignTest2);
+    append<HeapAllocationErrorsTest>("assign test 3", AssignTest3);
+    append<HeapAllocationErrorsTest>("erase test 1", EraseTest1);
+    append<HeapAllocationErrorsTest>("erase test 2", EraseTest2);
+    append<HeapAllocationErrorsTest>("Builder test 1", BuilderTest1);
+    append<HeapAllocationErrorsTest>("Value constructor test 8", ValueConstructorTest8);
+    append<HeapAllocationErrorsTest>("set test 12", SetTest12);
+    append<HeapAllocationErrorsTest>("Value::Parse test 6", ValueParseTest6);
 }
 
 void ConfigurationTests::ValueConstructorTest1(Test& test)
@@ -236,3 +277,662 @@ void ConfigurationTests::ValueOrNullTest1(Test& test)
     ISHIKO_TEST_FAIL_IF_NEQ(valuePointer2, nullptr);
     ISHIKO_TEST_PASS();
 }
+
+void ConfigurationTests::SetTest6(Test& test)
+{
+    Configuration configuration;
+
+    configuration.set("option3", "value3");
+    configuration.set("option1", "value1");
+    configuration.set("option2", "value2");
+    configuration.set("option1", "value4");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value4");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option2").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option3").asString(), "value3");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::SetTest7(Test& test)
+{
+    Configuration configuration;
+    configuration.set("option2", "value2");
+
+    // The value is a reference to an option of the configuration itself
+    configuration.set("option1", configuration.value("option2"));
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("option1").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::BeginTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("option2", "value2");
+    configuration.set("option3", "value3");
+    configuration.set("option1", "value1");
+
+    std::vector<std::string> names;
+    for (const Configuration::Entry& entry : configuration)
+    {
+        names.push_back(entry.first);
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(names.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(names[0], "option1");
+    ISHIKO_TEST_FAIL_IF_NEQ(names[1], "option2");
+    ISHIKO_TEST_FAIL_IF_NEQ(names[2], "option3");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("option1", "value1");
+
+    boost::string_view name("option1-suffix", 7);
+    bool thrown = false;
+    try
+    {
+        configuration.value("option2");
+    }
+    catch (const std::out_of_range&)
+    {
+        thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(name).asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NOT(thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueTest2(Test& test)
+{
+    Configuration configuration;
+    configuration.set("option1", "value1");
+    configuration.set("option2", "value2");
+
+    Configuration::Key key("option2");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(key).asString(), "value2");
+    // The second lookup uses the cached position
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(key).asString(), "value2");
+
+    // Shifts option2 to another position
+    configuration.set("option0", "value0");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(key).asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueTest3(Test& test)
+{
+    Configuration configuration1;
+    configuration1.set("option1", "value1");
+    configuration1.set("option2", "value2");
+    Configuration configuration2 = configuration1;
+    configuration2.set("option2", "value3");
+    Configuration configuration3;
+    configuration3.set("option2", "value4");
+
+    Configuration::Key key("option2");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value(key).asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.value(key).asString(), "value3");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration3.value(key).asString(), "value4");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value(key).asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueOrDefaultTest5(Test& test)
+{
+    Configuration configuration;
+    configuration.set("option1", "value1");
+
+    Configuration::Key key1("option1");
+    Configuration::Key key2("option2");
+
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault(key1, "default"), "value1");
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault(key2, "default"), "default");
+
+    configuration = Configuration();
+
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault(key1, "default"), "default");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueOrDefaultTest6(Test& test)
+{
+    Configuration server;
+    server.set("port", Configuration::Value(int64_t(80)));
+    Configuration configuration;
+    configuration.set("port", Configuration::Value(int64_t(80)));
+    configuration.set("server", server);
+
+    Configuration::Key key("port");
+    std::string default_value = "8080";
+
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault("port", "8080"), "8080");
+    ISHIKO_TEST_FAIL_IF_NEQ(&configuration.valueOrDefault("port", default_value), &default_value);
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault(key, "8080"), "8080");
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault(Configuration::Path("server.port"), "8080"), "8080");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault("port", Configuration()).size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueOrNullTest2(Test& test)
+{
+    Configuration configuration1;
+    configuration1.set("option1", "value1");
+
+    Configuration::Key key("option1");
+
+    ISHIKO_TEST_FAIL_IF_NOT(configuration1.valueOrNull(key));
+
+    Configuration configuration2 = std::move(configuration1);
+
+    ISHIKO_TEST_FAIL_IF_NOT(configuration2.valueOrNull(key));
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.valueOrNull(key)->asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::PathConstructorTest1(Test& test)
+{
+    Configuration::Path path("server.tls.cert");
+
+    ISHIKO_TEST_ABORT_IF_NEQ(path.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(path[0].name(), "server");
+    ISHIKO_TEST_FAIL_IF_NEQ(path[1].name(), "tls");
+    ISHIKO_TEST_FAIL_IF_NEQ(path[2].name(), "cert");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueTest4(Test& test)
+{
+    Configuration tls;
+    tls.set("cert", "server.pem");
+    Configuration server;
+    server.set("tls", tls);
+    Configuration configuration;
+    configuration.set("server", server);
+
+    Configuration::Path path("server.tls.cert");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(path).asString(), "server.pem");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(path).asString(), "server.pem");
+    ISHIKO_TEST_FAIL_IF_STR_NEQ(configuration.valueOrDefault(Configuration::Path("server.tls.key"), "default"),
+        "default");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueOrNullTest3(Test& test)
+{
+    Configuration configuration;
+    configuration.set("server", "value1");
+
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("server.tls")));
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("client.tls")));
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("")));
+    ISHIKO_TEST_FAIL_IF_NOT(configuration.valueOrNull(Configuration::Path("server")));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::SetTest8(Test& test)
+{
+    Configuration configuration;
+
+    configuration.set(Configuration::Path("server.tls.cert"), "server.pem");
+    configuration.set(Configuration::Path("server.port"), "443");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("server").asConfiguration().size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.cert")).asString(), "server.pem");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asString(), "443");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::SetTest9(Test& test)
+{
+    Configuration configuration;
+    configuration.set("server", "value1");
+
+    bool thrown = false;
+    try
+    {
+        configuration.set(Configuration::Path("server.port"), "443");
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(thrown);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("server").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueConstructorTest5(Test& test)
+{
+    Configuration::Value value("value1");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(value.type(), Configuration::Value::Type::string);
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueConstructorTest6(Test& test)
+{
+    Configuration::Value integer_value(int64_t(-5));
+    Configuration::Value double_value(0.5);
+    Configuration::Value bool_value(true);
+    Configuration::Value duration_value(std::chrono::nanoseconds(std::chrono::milliseconds(250)));
+    Configuration::Value size_value(uint64_t(4096));
+
+    ISHIKO_TEST_FAIL_IF_NEQ(integer_value.type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(integer_value.asInt(), -5);
+    ISHIKO_TEST_FAIL_IF_NEQ(double_value.type(), Configuration::Value::Type::floating_point);
+    ISHIKO_TEST_FAIL_IF_NEQ(double_value.asDouble(), 0.5);
+    ISHIKO_TEST_FAIL_IF_NEQ(bool_value.type(), Configuration::Value::Type::boolean);
+    ISHIKO_TEST_FAIL_IF_NOT(bool_value.asBool());
+    ISHIKO_TEST_FAIL_IF_NEQ(duration_value.type(), Configuration::Value::Type::duration);
+    ISHIKO_TEST_FAIL_IF_NEQ(duration_value.asDuration().count(), 250000000);
+    ISHIKO_TEST_FAIL_IF_NEQ(size_value.type(), Configuration::Value::Type::size);
+    ISHIKO_TEST_FAIL_IF_NEQ(size_value.asSize(), 4096);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueParseTest1(Test& test)
+{
+    Configuration::Value value;
+
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("-42", Configuration::Value::Type::integer, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asInt(), -42);
+    ISHIKO_TEST_ABORT_IF_NOT(
+        Configuration::Value::Parse("9223372036854775807", Configuration::Value::Type::integer, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asInt(), INT64_MAX);
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("9223372036854775808", Configuration::Value::Type::integer, value));
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("42a", Configuration::Value::Type::integer, value));
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("", Configuration::Value::Type::integer, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asInt(), INT64_MAX);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueParseTest2(Test& test)
+{
+    Configuration::Value value;
+
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("1.5", Configuration::Value::Type::floating_point, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asDouble(), 1.5);
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("1.5x", Configuration::Value::Type::floating_point, value));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueParseTest3(Test& test)
+{
+    Configuration::Value value;
+
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("Yes", Configuration::Value::Type::boolean, value));
+    ISHIKO_TEST_FAIL_IF_NOT(value.asBool());
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("off", Configuration::Value::Type::boolean, value));
+    ISHIKO_TEST_FAIL_IF(value.asBool());
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("maybe", Configuration::Value::Type::boolean, value));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueParseTest4(Test& test)
+{
+    Configuration::Value value;
+
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("250ms", Configuration::Value::Type::duration, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asDuration().count(), 250000000);
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("2min", Configuration::Value::Type::duration, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asDuration().count(), 120000000000);
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("250", Configuration::Value::Type::duration, value));
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("250days", Configuration::Value::Type::duration, value));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueParseTest5(Test& test)
+{
+    Configuration::Value value;
+
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("512", Configuration::Value::Type::size, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asSize(), 512);
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("64KiB", Configuration::Value::Type::size, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asSize(), 65536);
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("2G", Configuration::Value::Type::size, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asSize(), 2147483648);
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("-1", Configuration::Value::Type::size, value));
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("1X", Configuration::Value::Type::size, value));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::CopyTest1(Test& test)
+{
+    Configuration configuration1;
+    configuration1.set("option1", "value1");
+    Configuration configuration2 = configuration1;
+
+    // The copies share their options until one of them is modified
+    const Configuration& const_configuration1 = configuration1;
+    const Configuration& const_configuration2 = configuration2;
+
+    ISHIKO_TEST_FAIL_IF_NEQ(&const_configuration1.value("option1"), &const_configuration2.value("option1"));
+
+    configuration2.set("option1", "value2");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value("option1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.value("option1").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::CopyTest2(Test& test)
+{
+    Configuration nested1;
+    nested1.set("option1", "value1");
+    Configuration nested2;
+    nested2.set("option2", "value2");
+    Configuration configuration1;
+    configuration1.set("nested1", nested1);
+    configuration1.set("nested2", nested2);
+    Configuration configuration2 = configuration1;
+
+    configuration2.value("nested1").asConfiguration().set("option1", "value3");
+
+    const Configuration& const_configuration1 = configuration1;
+    const Configuration& const_configuration2 = configuration2;
+
+    ISHIKO_TEST_FAIL_IF_NEQ(const_configuration1.value(Configuration::Path("nested1.option1")).asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(const_configuration2.value(Configuration::Path("nested1.option1")).asString(), "value3");
+    // The configuration that is not on the path to the modified option is still shared
+    ISHIKO_TEST_FAIL_IF_NEQ(&const_configuration1.value(Configuration::Path("nested2.option2")),
+        &const_configuration2.value(Configuration::Path("nested2.option2")));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::CopyTest3(Test& test)
+{
+    Configuration configuration1;
+    configuration1.set(Configuration::Path("nested1.option1"), "value1");
+    Configuration configuration2 = configuration1;
+
+    configuration2.set(Configuration::Path("nested1.option1"), "value2");
+    configuration2.value(Configuration::Path("nested1.option1")) = Configuration::Value("value3");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value(Configuration::Path("nested1.option1")).asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration2.value(Configuration::Path("nested1.option1")).asString(), "value3");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueConstructorTest7(Test& test)
+{
+    std::vector<std::string> values = { "value1", "value2" };
+    const std::string* data = values.data();
+    Configuration::Value value(std::move(values));
+
+    ISHIKO_TEST_FAIL_IF_NEQ(value.type(), Configuration::Value::Type::string_array);
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asStringArray().size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asStringArray().data(), data);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::SetTest10(Test& test)
+{
+    Configuration nested_configuration;
+    nested_configuration.set("key1", "value1");
+
+    Configuration configuration;
+    configuration.set("key1", std::string("value1"));
+    configuration.set("key2", std::vector<std::string>({ "value2", "value3" }));
+    configuration.set("key3", std::move(nested_configuration));
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key2").asStringArray().size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key3").asConfiguration().value("key1").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::SetTest11(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    configuration.set("key2", "value2");
+
+    // Moving one of our own values into another option
+    configuration.set("key0", std::move(configuration.value("key2")));
+    configuration.set(Configuration::Path("key3.key4"), Configuration::Value(int64_t(4)));
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 4);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key0").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("key3.key4")).asInt(), 4);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::EmplaceTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+
+    Configuration::Value& value1 = configuration.emplace("key1", "value2");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(value1.asString(), "value2");
+
+    Configuration::Value& value2 = configuration.emplace("key2", Configuration());
+    value2.asConfiguration().set("key3", "value3");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key2").asConfiguration().value("key3").asString(), "value3");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::TryEmplaceTest1(Test& test)
+{
+    Configuration configuration;
+
+    std::pair<const Configuration::Value*, bool> result = configuration.tryEmplace("key1", "value1");
+
+    ISHIKO_TEST_FAIL_IF_NOT(result.second);
+    ISHIKO_TEST_FAIL_IF_NEQ(result.first->asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::TryEmplaceTest2(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+
+    std::pair<const Configuration::Value*, bool> result = configuration.tryEmplace("key1", "value2");
+
+    ISHIKO_TEST_FAIL_IF(result.second);
+    ISHIKO_TEST_FAIL_IF_NEQ(result.first->asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value1");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::TryEmplaceTest3(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    Configuration copy = configuration;
+    std::string value = "a value too long for the small string buffer";
+
+    std::pair<const Configuration::Value*, bool> result = configuration.tryEmplace("key1", std::move(value));
+
+    ISHIKO_TEST_FAIL_IF(result.second);
+    ISHIKO_TEST_FAIL_IF_NEQ(result.first->asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(value, "a value too long for the small string buffer");
+    ISHIKO_TEST_FAIL_IF_NOT(configuration.isSharedWith(copy));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::AssignTest1(Test& test)
+{
+    Configuration defaults;
+    defaults.set("key1", "a default value too long for the small buffer");
+    defaults.set("key2", "value2");
+
+    Configuration configuration;
+    configuration.set("key1", "a value that doesn't fit in the small string buffer either");
+    configuration.set("key3", "value3");
+    const char* buffer = configuration.value("key1").asString().data();
+
+    configuration.assign(defaults);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "a default value too long for the small buffer");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key2").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull("key3"));
+    // The string buffer was reused
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString().data(), buffer);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::AssignTest2(Test& test)
+{
+    Configuration defaults;
+    defaults.set(Configuration::Path("server.port"), "80");
+    defaults.set(Configuration::Path("server.host"), "localhost");
+
+    Configuration configuration;
+    configuration.set(Configuration::Path("server.port"), "443");
+    configuration.set(Configuration::Path("server.tls"), "true");
+    configuration.set("key1", Configuration::Value(int64_t(1)));
+    Configuration::Key port_key("port");
+
+    configuration.assign(defaults);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    const Configuration& server = configuration.value("server").asConfiguration();
+    ISHIKO_TEST_FAIL_IF_NEQ(server.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(server.value(port_key).asString(), "80");
+    ISHIKO_TEST_FAIL_IF_NEQ(server.value("host").asString(), "localhost");
+    ISHIKO_TEST_FAIL_IF(server.valueOrNull("tls"));
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::AssignTest3(Test& test)
+{
+    Configuration defaults;
+    defaults.set("key1", "value1");
+
+    Configuration configuration;
+    configuration.set("key1", "value2");
+    Configuration copy = configuration;
+
+    configuration.assign(defaults);
+
+    // The options shared with the copy are not modified
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(copy.value("key1").asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::EraseTest1(Test& test)
+{
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    configuration.set("key2", "value2");
+    Configuration::Key key2("key2");
+    ISHIKO_TEST_ABORT_IF_NEQ(configuration.value(key2).asString(), "value2");
+
+    bool erased1 = configuration.erase("key1");
+    bool erased2 = configuration.erase("key1");
+
+    ISHIKO_TEST_FAIL_IF_NOT(erased1);
+    ISHIKO_TEST_FAIL_IF(erased2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 1);
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull("key1"));
+    // The key cached the position of key2 before key1 was erased
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(key2).asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::EraseTest2(Test& test)
+{
+    Configuration configuration;
+    configuration.set(Configuration::Path("key1.key2"), "value2");
+    configuration.set(Configuration::Path("key1.key3"), "value3");
+    const Configuration copy = configuration;
+
+    bool erased1 = configuration.erase(Configuration::Path("key1.key2"));
+    bool erased2 = configuration.erase(Configuration::Path("key1.key4"));
+
+    ISHIKO_TEST_FAIL_IF_NOT(erased1);
+    ISHIKO_TEST_FAIL_IF(erased2);
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("key1.key2")));
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("key1.key3")).asString(), "value3");
+    ISHIKO_TEST_FAIL_IF_NEQ(copy.value(Configuration::Path("key1.key2")).asString(), "value2");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::BuilderTest1(Test& test)
+{
+    Configuration::Builder builder;
+    builder.add("key2", Configuration::Value("value2"));
+    builder.add("key1", Configuration::Value("value1"));
+    builder.add("key3", Configuration::Value("value3"));
+    builder.add("key1", Configuration::Value("new value1"));
+    Configuration::Key key1("key1");
+    Configuration configuration = builder.build();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(builder.size(), 0);
+    ISHIKO_TEST_ABORT_IF_NEQ(configuration.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.begin()->first, "key1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(key1).asString(), "new value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key2").asString(), "value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key3").asString(), "value3");
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueConstructorTest8(Test& test)
+{
+    Configuration::Value int_value(5);
+    Configuration::Value long_long_value(-5LL);
+    Configuration::Value unsigned_value(5u);
+    Configuration::Value unsigned_long_long_value(5ULL);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(int_value.type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(int_value.asInt(), 5);
+    ISHIKO_TEST_FAIL_IF_NEQ(long_long_value.type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(long_long_value.asInt(), -5);
+    ISHIKO_TEST_FAIL_IF_NEQ(unsigned_value.type(), Configuration::Value::Type::size);
+    ISHIKO_TEST_FAIL_IF_NEQ(unsigned_value.asSize(), 5);
+    ISHIKO_TEST_FAIL_IF_NEQ(unsigned_long_long_value.type(), Configuration::Value::Type::size);
+    ISHIKO_TEST_FAIL_IF_NEQ(unsigned_long_long_value.asSize(), 5);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::SetTest12(Test& test)
+{
+    Configuration configuration;
+    configuration.set("port", 8080);
+    configuration.set("ratio", 0.5);
+    configuration.set("enabled", true);
+    configuration.set(Configuration::Path("server.port"), 80);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("port").type(), Configuration::Value::Type::integer);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("port").asInt(), 8080);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("ratio").asDouble(), 0.5);
+    ISHIKO_TEST_FAIL_IF_NOT(configuration.value("enabled").asBool());
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asInt(), 80);
+    ISHIKO_TEST_PASS();
+}
+
+void ConfigurationTests::ValueParseTest6(Test& test)
+{
+    // Numbers too small to be normalized are subnormals, only numbers too large for a double are invalid
+    Configuration::Value value;
+    ISHIKO_TEST_ABORT_IF_NOT(Configuration::Value::Parse("1e-310", Configuration::Value::Type::floating_point,
+        value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asDouble(), 1e-310);
+    ISHIKO_TEST_FAIL_IF(Configuration::Value::Parse("1e999", Configuration::Value::Type::floating_point, value));
+    ISHIKO_TEST_FAIL_IF_NEQ(value.asDouble(), 1e-310);
+    ISHIKO_TEST_PASS();
+}
@@ -27,6 +27,46 @@ private:
     static void ValueOrDefaultTest3(Ishiko::Test& test);
     static void ValueOrDefaultTest4(Ishiko::Test& test);
     static void ValueOrNullTest1(Ishiko::Test& test);
+    static void SetTest6(Ishiko::Test& test);
+    static void SetTest7(Ishiko::Test& test);
+    static void BeginTest1(Ishiko::Test& test);
+    static void ValueTest1(Ishiko::Test& test);
+    static void ValueTest2(Ishiko::Test& test);
+    static void ValueTest3(Ishiko::Test& test);
+    static void ValueOrDefaultTest5(Ishiko::Test& test);
+    static void ValueOrDefaultTest6(Ishiko::Test& test);
+    static void ValueOrNullTest2(Ishiko::Test& test);
+    static void PathConstructorTest1(Ishiko::Test& test);
+    static void ValueTest4(Ishiko::Test& test);
+    static void ValueOrNullTest3(Ishiko::Test& test);
+    static void SetTest8(Ishiko::Test& test);
+    static void SetTest9(Ishiko::Test& test);
+    static void ValueConstructorTest5(Ishiko::Test& test);
+    static void ValueConstructorTest6(Ishiko::Test& test);
+    static void ValueParseTest1(Ishiko::Test& test);
+    static void ValueParseTest2(Ishiko::Test& test);
+    static void ValueParseTest3(Ishiko::Test& test);
+    static void ValueParseTest4(Ishiko::Test& test);
+    static void ValueParseTest5(Ishiko::Test& test);
+    static void CopyTest1(Ishiko::Test& test);
+    static void CopyTest2(Ishiko::Test& test);
+    static void CopyTest3(Ishiko::Test& test);
+    static void ValueConstructorTest7(Ishiko::Test& test);
+    static void SetTest10(Ishiko::Test& test);
+    static void SetTest11(Ishiko::Test& test);
+    static void EmplaceTest1(Ishiko::Test& test);
+    static void TryEmplaceTest1(Ishiko::Test& test);
+    static void TryEmplaceTest2(Ishiko::Test& test);
+    static void TryEmplaceTest3(Ishiko::Test& test);
+    static void AssignTest1(Ishiko::Test& test);
+    static void AssignTest2(Ishiko::Test& test);
+    static void AssignTest3(Ishiko::Test& test);
+    static void EraseTest1(Ishiko::Test& test);
+    static void EraseTest2(Ishiko::Test& test);
+    static void BuilderTest1(Ishiko::Test& test);
+    static void ValueConstructorTest8(Ishiko::Test& test);
+    static void SetTest12(Ishiko::Test& test);
+    static void ValueParseTest6(Ishiko::Test& test);
 };
 
 #endif
@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "DefaultedConfigurationTests.hpp"
+#include "Ishiko/Configuration/CommandLineParser.hpp"
+#include "Ishiko/Configuration/DefaultedConfiguration.hpp"
+#include <stdexcept>
+#include <string>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// A "build" command with a positional option that has a default, and a "run" command
+CommandLineSpecification CreateSpecification()
+{
+    CommandLineSpecification result;
+    CommandLineSpecification::OptionDetails port_details(CommandLineSpecification::OptionType::single_value, "8080");
+    port_details.setValueType(Configuration::Value::Type::integer);
+    result.addNamedOption("port", port_details);
+    result.addNamedOption("host", {CommandLineSpecification::OptionType::single_value});
+    result.addPositionalOption(1, "command", {CommandLineSpecification::OptionType::single_value});
+    CommandLineSpecification::CommandDetails& build_details = result.addCommand("command", "build");
+    build_details.addPositionalOption(2, "target", {CommandLineSpecification::OptionType::single_value, "all"});
+    result.addCommand("command", "run");
+    return result;
+}
+
+}
+
+DefaultedConfigurationTests::DefaultedConfigurationTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "DefaultedConfiguration tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("value test 1", ValueTest1);
+    append<HeapAllocationErrorsTest>("value test 2", ValueTest2);
+    append<HeapAllocationErrorsTest>("value test 3", ValueTest3);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 1", ValueOrDefaultTest1);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 2", ValueOrDefaultTest2);
+}
+
+void DefaultedConfigurationTests::ConstructorTest1(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    Configuration parsed;
+
+    DefaultedConfiguration configuration(spec, parsed);
+
+    ISHIKO_TEST_FAIL_IF_NOT(configuration.parsedConfiguration().isSharedWith(parsed));
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("port").asInt(), 8080);
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull("host"));
+    ISHIKO_TEST_PASS();
+}
+
+void DefaultedConfigurationTests::ValueTest1(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    const char* argv[] = {"dummy", "--port=9090", "--host=example.com"};
+    Configuration parsed;
+    CommandLineParser::parse(spec, 3, argv, parsed);
+
+    DefaultedConfiguration configuration(spec, parsed);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("port").asInt(), 9090);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("host").asString(), "example.com");
+
+    bool thrown = false;
+    try
+    {
+        configuration.value("missing");
+    }
+    catch (const std::out_of_range&)
+    {
+        thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void DefaultedConfigurationTests::ValueTest2(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    const char* argv[] = {"dummy", "build"};
+    Configuration parsed;
+    CommandLineParser::parse(spec, 2, argv, parsed);
+
+    DefaultedConfiguration configuration(spec, parsed);
+
+    // The default of the positional option of the selected command
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("command.name")).asString(), "build");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("command.target")).asString(), "all");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("port")).asInt(), 8080);
+    ISHIKO_TEST_PASS();
+}
+
+void DefaultedConfigurationTests::ValueTest3(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    const char* argv1[] = {"dummy", "build", "tests"};
+    Configuration parsed1;
+    CommandLineParser::parse(spec, 3, argv1, parsed1);
+    const char* argv2[] = {"dummy", "run"};
+    Configuration parsed2;
+    CommandLineParser::parse(spec, 2, argv2, parsed2);
+
+    DefaultedConfiguration configuration1(spec, parsed1);
+    DefaultedConfiguration configuration2(spec, parsed2);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration1.value(Configuration::Path("command.target")).asString(), "tests");
+    // The option belongs to a command that wasn't selected
+    ISHIKO_TEST_FAIL_IF(configuration2.valueOrNull(Configuration::Path("command.target")));
+    ISHIKO_TEST_FAIL_IF(configuration2.valueOrNull(Configuration::Path("build.target")));
+    ISHIKO_TEST_PASS();
+}
+
+void DefaultedConfigurationTests::ValueOrDefaultTest1(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    const char* argv[] = {"dummy", "build"};
+    Configuration parsed;
+    CommandLineParser::parse(spec, 2, argv, parsed);
+
+    DefaultedConfiguration configuration(spec, parsed);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault("host", "localhost")), "localhost");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault(Configuration::Path("command.target"), std::string("none")),
+        "all");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault(Configuration::Path("command.other"), std::string("none")),
+        "none");
+    ISHIKO_TEST_PASS();
+}
+
+void DefaultedConfigurationTests::ValueOrDefaultTest2(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    Configuration parsed;
+
+    DefaultedConfiguration configuration(spec, parsed);
+
+    // The default of the port is an integer so the string defaults are used
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault("port", "80")), "80");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault("port", std::string("80")), "80");
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault(Configuration::Path("port"), "80")), "80");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault(Configuration::Path("port"), std::string("80")), "80");
+    ISHIKO_TEST_PASS();
+}
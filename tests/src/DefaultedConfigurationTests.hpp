@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_DEFAULTEDCONFIGURATIONTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_DEFAULTEDCONFIGURATIONTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class DefaultedConfigurationTests : public Ishiko::TestSequence
+{
+public:
+    DefaultedConfigurationTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void ValueTest1(Ishiko::Test& test);
+    static void ValueTest2(Ishiko::Test& test);
+    static void ValueTest3(Ishiko::Test& test);
+    static void ValueOrDefaultTest1(Ishiko::Test& test);
+    static void ValueOrDefaultTest2(Ishiko::Test& test);
+};
+
+#endif
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnvironmentParserTests.hpp"
+#include "Ishiko/Configuration/EnvironmentParser.hpp"
+
+using namespace Ishiko;
+
+namespace
+{
+
+CommandLineSpecification CreateSpecification()
+{
+    CommandLineSpecification result;
+    result.addNamedOption("log-level", {CommandLineSpecification::OptionType::single_value});
+    result.addNamedOption("server.host", {CommandLineSpecification::OptionType::single_value});
+    CommandLineSpecification::OptionDetails port_details(CommandLineSpecification::OptionType::single_value);
+    port_details.setValueType(Configuration::Value::Type::integer);
+    result.addNamedOption("server.port", port_details);
+    return result;
+}
+
+}
+
+EnvironmentParserTests::EnvironmentParserTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "EnvironmentParser tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("VariableName test 1", VariableNameTest1);
+    append<HeapAllocationErrorsTest>("parse test 1", ParseTest1);
+    append<HeapAllocationErrorsTest>("parse test 2", ParseTest2);
+    append<HeapAllocationErrorsTest>("parse test 3", ParseTest3);
+}
+
+void EnvironmentParserTests::ConstructorTest1(Test& test)
+{
+    CompiledCommandLineSpecification spec;
+    EnvironmentParser parser(spec, "APP_");
+
+    const char* environment[] = {"APP_PORT=8080", nullptr};
+    Configuration configuration;
+    parser.parse(environment, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void EnvironmentParserTests::VariableNameTest1(Test& test)
+{
+    ISHIKO_TEST_FAIL_IF_NEQ(EnvironmentParser::VariableName("APP_", "server.port"), "APP_SERVER__PORT");
+    ISHIKO_TEST_FAIL_IF_NEQ(EnvironmentParser::VariableName("APP_", "log-level"), "APP_LOG_LEVEL");
+    ISHIKO_TEST_FAIL_IF_NEQ(EnvironmentParser::VariableName("", "tls.cert-file"), "TLS__CERT_FILE");
+    ISHIKO_TEST_PASS();
+}
+
+void EnvironmentParserTests::ParseTest1(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    EnvironmentParser parser(spec, "APP_");
+
+    const char* environment[] = {"PATH=/usr/bin", "APP_SERVER__PORT=8080", "HOME=/root", "APP_LOG_LEVEL=debug",
+        "APP_SERVER__HOST=example.com", nullptr};
+    Configuration configuration;
+    parser.parse(environment, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("log-level").asString(), "debug");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.host")).asString(), "example.com");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asInt(), 8080);
+    ISHIKO_TEST_PASS();
+}
+
+void EnvironmentParserTests::ParseTest2(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    EnvironmentParser parser(spec, "APP_");
+
+    // Variables without the prefix, with names that are not options, with the case of the option name or without a
+    // value are ignored
+    const char* environment[] = {"SERVER__PORT=1", "APP_SERVER__USER=admin", "APP_server__port=2", "APP_SERVER",
+        "APP_LOG_LEVEL=", nullptr};
+    Configuration configuration;
+    configuration.set("existing", "value");
+    parser.parse(environment, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("existing").asString(), "value");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("log-level").asString(), "");
+    ISHIKO_TEST_PASS();
+}
+
+void EnvironmentParserTests::ParseTest3(Test& test)
+{
+    CompiledCommandLineSpecification spec = CreateSpecification().compile();
+    EnvironmentParser parser(spec, "APP_");
+
+    // The later variables override the values set before
+    const char* environment[] = {"APP_SERVER__PORT=80", "APP_SERVER__PORT=8080", nullptr};
+    Configuration configuration;
+    configuration.set(Configuration::Path("server.port"), Configuration::Value(int64_t(1)));
+    parser.parse(environment, configuration);
+    parser.parse(nullptr, configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asInt(), 8080);
+    ISHIKO_TEST_PASS();
+}
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_ENVIRONMENTPARSERTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_ENVIRONMENTPARSERTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class EnvironmentParserTests : public Ishiko::TestSequence
+{
+public:
+    EnvironmentParserTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void VariableNameTest1(Ishiko::Test& test);
+    static void ParseTest1(Ishiko::Test& test);
+    static void ParseTest2(Ishiko::Test& test);
+    static void ParseTest3(Ishiko::Test& test);
+};
+
+#endif
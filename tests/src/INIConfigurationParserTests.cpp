@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "INIConfigurationParserTests.hpp"
+#include "Ishiko/Configuration/INIConfigurationParser.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+INIConfigurationParserTests::INIConfigurationParserTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "INIConfigurationParser tests", context)
+{
+    append<HeapAllocationErrorsTest>("parse test 1", ParseTest1);
+    append<HeapAllocationErrorsTest>("parse test 2", ParseTest2);
+    append<HeapAllocationErrorsTest>("parse test 3", ParseTest3);
+    append<HeapAllocationErrorsTest>("parse test 4", ParseTest4);
+    append<HeapAllocationErrorsTest>("parse test 5", ParseTest5);
+    append<HeapAllocationErrorsTest>("parse test 6", ParseTest6);
+    append<HeapAllocationErrorsTest>("parse test 7", ParseTest7);
+    append<HeapAllocationErrorsTest>("parseFile test 1", ParseFileTest1);
+}
+
+void INIConfigurationParserTests::ParseTest1(Test& test)
+{
+    Configuration configuration;
+    INIConfigurationParser::parse("\n# comment\n  ; another comment\r\n\n", configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseTest2(Test& test)
+{
+    Configuration configuration;
+    INIConfigurationParser::parse(
+        "name = value\n"
+        "[server]\n"
+        "port=8080\r\n"
+        "  host = localhost   # comment\n"
+        "url = http://example.com/#anchor\n"
+        "[server.tls]\n"
+        "enabled = true\n",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("name").asString(), "value");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asString(), "8080");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.host")).asString(), "localhost");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.url")).asString(),
+        "http://example.com/#anchor");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.enabled")).asString(), "true");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("server").asConfiguration().size(), 4);
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseTest3(Test& test)
+{
+    Configuration configuration;
+    INIConfigurationParser::parse(
+        "basic = \"a \\\"quoted\\\" # value\\n\"\n"
+        "literal = 'C:\\server'\n"
+        "empty = \"\"\n",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("basic").asString(), "a \"quoted\" # value\n");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("literal").asString(), "C:\\server");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("empty").asString(), "");
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseTest4(Test& test)
+{
+    // Repeated keys and arrays become string arrays, the section is opened twice
+    Configuration configuration;
+    INIConfigurationParser::parse(
+        "[hosts]\n"
+        "alias = one\n"
+        "ciphers = [\"a\", 'b', c]\n"
+        "single = [\"a\"]\n"
+        "none = []\n"
+        "[other]\n"
+        "[hosts]\n"
+        "alias = two\n",
+        configuration);
+
+    const Configuration& hosts = configuration.value("hosts").asConfiguration();
+    ISHIKO_TEST_FAIL_IF_NEQ(hosts.value("alias").asStringArray(), std::vector<std::string>({"one", "two"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(hosts.value("ciphers").asStringArray(), std::vector<std::string>({"a", "b", "c"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(hosts.value("single").asStringArray(), std::vector<std::string>({"a"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(hosts.value("none").asStringArray().size(), 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("other").asConfiguration().size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseTest5(Test& test)
+{
+    // Dotted keys are in nested sections, the sections are declared in any order
+    Configuration configuration;
+    INIConfigurationParser::parse(
+        "[server.tls]\n"
+        "enabled = true\n"
+        "[server]\n"
+        "tls.cert = server.pem\n"
+        "port = 80\n",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asString(), "80");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.enabled")).asString(), "true");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.cert")).asString(), "server.pem");
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseTest6(Test& test)
+{
+    Configuration configuration;
+    size_t line = 0;
+    size_t column = 0;
+    try
+    {
+        INIConfigurationParser::parse("[server]\nport = 80\nhost = \"localhost\n", configuration);
+    }
+    catch (const ConfigurationParseError& e)
+    {
+        line = e.line();
+        column = e.column();
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(line, 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(column, 8);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseTest7(Test& test)
+{
+    const char* invalid_documents[] = {"[server\n", "[server] key = value\n", "[server..tls]\n", "key\n", "= value\n",
+        "key = \"value\" extra\n", "key = \"\\x\"\n", "key = [a, b\n", "key = [a,, b]\n",
+        "server = value\n[server]\n", "[server]\ntls = value\n[server.tls]\n"};
+
+    size_t errors = 0;
+    for (const char* document : invalid_documents)
+    {
+        Configuration configuration;
+        try
+        {
+            INIConfigurationParser::parse(document, configuration);
+        }
+        catch (const ConfigurationParseError&)
+        {
+            ++errors;
+        }
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, sizeof(invalid_documents) / sizeof(invalid_documents[0]));
+    ISHIKO_TEST_PASS();
+}
+
+void INIConfigurationParserTests::ParseFileTest1(Test& test)
+{
+    {
+        std::ofstream file("INIConfigurationParserTests_ParseFileTest1.ini", std::ios::binary | std::ios::trunc);
+        file << "[server]\nport = 8080\n";
+    }
+
+    Configuration configuration;
+    INIConfigurationParser::parseFile("INIConfigurationParserTests_ParseFileTest1.ini", configuration);
+
+    std::remove("INIConfigurationParserTests_ParseFileTest1.ini");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asString(), "8080");
+    ISHIKO_TEST_PASS();
+}
@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "JSONConfigurationParserTests.hpp"
+#include "Ishiko/Configuration/JSONConfigurationParser.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace Ishiko;
+
+JSONConfigurationParserTests::JSONConfigurationParserTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "JSONConfigurationParser tests", context)
+{
+    append<HeapAllocationErrorsTest>("parse test 1", ParseTest1);
+    append<HeapAllocationErrorsTest>("parse test 2", ParseTest2);
+    append<HeapAllocationErrorsTest>("parse test 3", ParseTest3);
+    append<HeapAllocationErrorsTest>("parse test 4", ParseTest4);
+    append<HeapAllocationErrorsTest>("parse test 5", ParseTest5);
+    append<HeapAllocationErrorsTest>("parse test 6", ParseTest6);
+    append<HeapAllocationErrorsTest>("parse test 7", ParseTest7);
+    append<HeapAllocationErrorsTest>("parse test 8", ParseTest8);
+    append<HeapAllocationErrorsTest>("parse test 9", ParseTest9);
+    append<HeapAllocationErrorsTest>("parse test 10", ParseTest10);
+    append<HeapAllocationErrorsTest>("parseFile test 1", ParseFileTest1);
+    append<HeapAllocationErrorsTest>("parseFile test 2", ParseFileTest2);
+}
+
+void JSONConfigurationParserTests::ParseTest1(Test& test)
+{
+    Configuration configuration;
+    JSONConfigurationParser::parse("{}", configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest2(Test& test)
+{
+    Configuration configuration;
+    JSONConfigurationParser::parse(
+        "{\"string\": \"value\", \"integer\": -42, \"double\": 1.5e3, \"true\": true, \"false\": false,"
+        " \"null\": null}",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 5);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("string").asString(), "value");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("integer").asInt(), -42);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("double").asDouble(), 1500.0);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("true").asBool(), true);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("false").asBool(), false);
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull("null"));
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest3(Test& test)
+{
+    // The members are not in name order and "port" is repeated, the last value is kept
+    Configuration configuration;
+    JSONConfigurationParser::parse(
+        "{\n"
+        "    \"server\": {\n"
+        "        \"port\": 80,\n"
+        "        \"host\": \"localhost\",\n"
+        "        \"tls\": {\"enabled\": true},\n"
+        "        \"port\": 8080\n"
+        "    },\n"
+        "    \"hosts\": [\"a\", \"b\", 3, true],\n"
+        "    \"empty\": []\n"
+        "}\n",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asInt(), 8080);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.host")).asString(), "localhost");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.enabled")).asBool(), true);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server")).asConfiguration().size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("hosts").asStringArray(),
+        std::vector<std::string>({"a", "b", "3", "true"}));
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("empty").asStringArray().size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest4(Test& test)
+{
+    // The escape sequences are after the first 16 bytes so they are found by the vectorized scan if there is one
+    Configuration configuration;
+    JSONConfigurationParser::parse(
+        "{\"key\": \"a long string value with \\\"escapes\\\"\\n\\u00e9\\ud83d\\ude00 and more text after them\"}",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key").asString(),
+        "a long string value with \"escapes\"\n\xC3\xA9\xF0\x9F\x98\x80 and more text after them");
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest5(Test& test)
+{
+    // Integers that don't fit in 64 bits are converted to floating point
+    Configuration configuration;
+    JSONConfigurationParser::parse(
+        "{\"max\": 9223372036854775807, \"min\": -9223372036854775808, \"large\": 18446744073709551616}",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("max").asInt(), INT64_MAX);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("min").asInt(), INT64_MIN);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("large").asDouble(), 18446744073709551616.0);
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest6(Test& test)
+{
+    // The members replace the existing options with the same name
+    Configuration configuration;
+    configuration.set("key1", "value1");
+    configuration.set("key2", "value2");
+    JSONConfigurationParser::parse("{\"key2\": \"new value2\", \"key3\": \"value3\"}", configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key1").asString(), "value1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key2").asString(), "new value2");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("key3").asString(), "value3");
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest7(Test& test)
+{
+    Configuration configuration;
+    size_t line = 0;
+    size_t column = 0;
+    try
+    {
+        JSONConfigurationParser::parse("{\n    \"key1\": \"value1\",\n    \"key2\" \"value2\"\n}", configuration);
+    }
+    catch (const ConfigurationParseError& e)
+    {
+        line = e.line();
+        column = e.column();
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(line, 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(column, 12);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest8(Test& test)
+{
+    const char* invalid_documents[] = {"", "[]", "{", "{\"key\": }", "{\"key\": \"value}", "{\"key\": 01}",
+        "{\"key\": -}", "{\"key\": 1.}", "{\"key\": tru}", "{\"key\": \"\\x\"}", "{\"key\": \"\\ud83d\"}",
+        "{\"key\": [{}]}", "{\"key\": \"a\tb\"}", "{} {}", "{\"key\": 1,}"};
+
+    size_t errors = 0;
+    for (const char* document : invalid_documents)
+    {
+        Configuration configuration;
+        try
+        {
+            JSONConfigurationParser::parse(document, configuration);
+        }
+        catch (const ConfigurationParseError&)
+        {
+            ++errors;
+        }
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, sizeof(invalid_documents) / sizeof(invalid_documents[0]));
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest9(Test& test)
+{
+    // Numbers too large for a double are errors, at the position of the number
+    const char* documents[] = {"{\"key\": 1e999}", "{\"key\": -1e999}"};
+
+    size_t errors = 0;
+    for (const char* document : documents)
+    {
+        Configuration configuration;
+        try
+        {
+            JSONConfigurationParser::parse(document, configuration);
+        }
+        catch (const ConfigurationParseError& e)
+        {
+            if ((e.line() == 1) && (e.column() == 9))
+            {
+                ++errors;
+            }
+        }
+    }
+
+    ISHIKO_TEST_FAIL_IF_NEQ(errors, sizeof(documents) / sizeof(documents[0]));
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseTest10(Test& test)
+{
+    // Numbers too small to be normalized become subnormals, or 0
+    Configuration configuration;
+    JSONConfigurationParser::parse("{\"subnormal\": 1e-310, \"smallest\": 4.9e-324, \"zero\": 1e-999}",
+        configuration);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("subnormal").asDouble(), 1e-310);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("smallest").asDouble(), 4.9e-324);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("zero").asDouble(), 0.0);
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseFileTest1(Test& test)
+{
+    {
+        std::ofstream file("JSONConfigurationParserTests_ParseFileTest1.json", std::ios::binary | std::ios::trunc);
+        file << "{\"server\": {\"port\": 8080}}";
+    }
+
+    Configuration configuration;
+    JSONConfigurationParser::parseFile("JSONConfigurationParserTests_ParseFileTest1.json", configuration);
+
+    std::remove("JSONConfigurationParserTests_ParseFileTest1.json");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asInt(), 8080);
+    ISHIKO_TEST_PASS();
+}
+
+void JSONConfigurationParserTests::ParseFileTest2(Test& test)
+{
+    Configuration configuration;
+    bool thrown = false;
+    try
+    {
+        JSONConfigurationParser::parseFile("JSONConfigurationParserTests_ParseFileTest2_doesnotexist.json",
+            configuration);
+    }
+    catch (const std::system_error&)
+    {
+        thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(thrown);
+    ISHIKO_TEST_PASS();
+}
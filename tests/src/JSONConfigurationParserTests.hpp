@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_JSONCONFIGURATIONPARSERTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_JSONCONFIGURATIONPARSERTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class JSONConfigurationParserTests : public Ishiko::TestSequence
+{
+public:
+    JSONConfigurationParserTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ParseTest1(Ishiko::Test& test);
+    static void ParseTest2(Ishiko::Test& test);
+    static void ParseTest3(Ishiko::Test& test);
+    static void ParseTest4(Ishiko::Test& test);
+    static void ParseTest5(Ishiko::Test& test);
+    static void ParseTest6(Ishiko::Test& test);
+    static void ParseTest7(Ishiko::Test& test);
+    static void ParseTest8(Ishiko::Test& test);
+    static void ParseTest9(Ishiko::Test& test);
+    static void ParseTest10(Ishiko::Test& test);
+    static void ParseFileTest1(Ishiko::Test& test);
+    static void ParseFileTest2(Ishiko::Test& test);
+};
+
+#endif
@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "LayeredConfigurationTests.hpp"
+#include "Ishiko/Configuration/ConfigurationPatch.hpp"
+#include "Ishiko/Configuration/LayeredConfiguration.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+namespace
+{
+
+// The defaults, a configuration file and the command line
+std::vector<Configuration> CreateLayers()
+{
+    Configuration defaults;
+    defaults.set(Configuration::Path("log.level"), "info");
+    defaults.set(Configuration::Path("server.host"), "localhost");
+    defaults.set(Configuration::Path("server.port"), "80");
+    defaults.set(Configuration::Path("server.tls.cert"), "default.pem");
+
+    Configuration file;
+    file.set(Configuration::Path("server.port"), "8080");
+    file.set(Configuration::Path("server.tls.key"), "server.key");
+    file.set(Configuration::Path("workers"), "4");
+
+    Configuration command_line;
+    command_line.set(Configuration::Path("log"), "off");
+    command_line.set(Configuration::Path("server.port"), "9090");
+
+    return std::vector<Configuration>({defaults, file, command_line});
+}
+
+}
+
+LayeredConfigurationTests::LayeredConfigurationTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "LayeredConfiguration tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("push test 1", PushTest1);
+    append<HeapAllocationErrorsTest>("value test 1", ValueTest1);
+    append<HeapAllocationErrorsTest>("value test 2", ValueTest2);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 1", ValueOrDefaultTest1);
+    append<HeapAllocationErrorsTest>("valueOrDefault test 2", ValueOrDefaultTest2);
+    append<HeapAllocationErrorsTest>("subtree test 1", SubtreeTest1);
+    append<HeapAllocationErrorsTest>("subtree test 2", SubtreeTest2);
+    append<HeapAllocationErrorsTest>("flatten test 1", FlattenTest1);
+    append<HeapAllocationErrorsTest>("flatten test 2", FlattenTest2);
+}
+
+void LayeredConfigurationTests::ConstructorTest1(Test& test)
+{
+    LayeredConfiguration configuration;
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.layerCount(), 0);
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull("key"));
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.flatten().size(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::PushTest1(Test& test)
+{
+    LayeredConfiguration base(CreateLayers());
+
+    // A per-request layer on top of a copy of the base, the base isn't affected
+    LayeredConfiguration request = base;
+    Configuration overrides;
+    overrides.set(Configuration::Path("server.port"), "1234");
+    request.push(overrides);
+
+    ISHIKO_TEST_FAIL_IF_NEQ(request.layerCount(), 4);
+    ISHIKO_TEST_FAIL_IF_NEQ(request.value(Configuration::Path("server.port")).asString(), "1234");
+    ISHIKO_TEST_FAIL_IF_NEQ(base.value(Configuration::Path("server.port")).asString(), "9090");
+    ISHIKO_TEST_FAIL_IF_NOT(request.layer(0).isSharedWith(base.layer(0)));
+
+    request.pop();
+
+    ISHIKO_TEST_FAIL_IF_NEQ(request.layerCount(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(request.value(Configuration::Path("server.port")).asString(), "9090");
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::ValueTest1(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("workers").asString(), "4");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("log").asString(), "off");
+    // The highest layer that has the option, without merging
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value("server").asConfiguration().size(), 1);
+
+    bool thrown = false;
+    try
+    {
+        configuration.value("missing");
+    }
+    catch (const std::out_of_range&)
+    {
+        thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::ValueTest2(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.port")).asString(), "9090");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.host")).asString(), "localhost");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.cert")).asString(), "default.pem");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.value(Configuration::Path("server.tls.key")).asString(), "server.key");
+    // The command line value hides the log configuration of the defaults
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("log.level")));
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("server.missing")));
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::ValueOrDefaultTest1(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault("workers", "1")), "4");
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault("threads", "1")), "1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault(Configuration::Path("server.host"), std::string("none")),
+        "localhost");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault(Configuration::Path("log.level"), std::string("none")),
+        "none");
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::ValueOrDefaultTest2(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+    Configuration typed;
+    typed.set("workers", Configuration::Value(int64_t(8)));
+    typed.set(Configuration::Path("server.port"), Configuration::Value(int64_t(443)));
+    configuration.push(typed);
+
+    // The options of the top layer are integers so the string defaults are used
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault("workers", "1")), "1");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault("workers", std::string("1")), "1");
+    ISHIKO_TEST_FAIL_IF_NEQ(std::string(configuration.valueOrDefault(Configuration::Path("server.port"), "80")), "80");
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.valueOrDefault(Configuration::Path("server.port"), std::string("80")),
+        "80");
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::SubtreeTest1(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+
+    LayeredConfiguration server = configuration.subtree("server");
+
+    ISHIKO_TEST_FAIL_IF_NEQ(server.layerCount(), 3);
+    ISHIKO_TEST_FAIL_IF_NEQ(server.value("port").asString(), "9090");
+    ISHIKO_TEST_FAIL_IF_NEQ(server.value("host").asString(), "localhost");
+    ISHIKO_TEST_FAIL_IF_NEQ(server.subtree("tls").layerCount(), 2);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.subtree("log").layerCount(), 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.subtree(Configuration::Path("server.port")).layerCount(), 0);
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::SubtreeTest2(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+
+    // An empty path doesn't name any option
+    ISHIKO_TEST_FAIL_IF_NEQ(configuration.subtree(Configuration::Path("")).layerCount(), 0);
+    ISHIKO_TEST_FAIL_IF(configuration.valueOrNull(Configuration::Path("")));
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::FlattenTest1(Test& test)
+{
+    LayeredConfiguration configuration(CreateLayers());
+
+    Configuration flattened = configuration.flatten();
+
+    Configuration expected;
+    expected.set(Configuration::Path("log"), "off");
+    expected.set(Configuration::Path("server.host"), "localhost");
+    expected.set(Configuration::Path("server.port"), "9090");
+    expected.set(Configuration::Path("server.tls.cert"), "default.pem");
+    expected.set(Configuration::Path("server.tls.key"), "server.key");
+    expected.set(Configuration::Path("workers"), "4");
+
+    ISHIKO_TEST_FAIL_IF_NOT(ConfigurationPatch::Diff(expected, flattened).empty());
+    ISHIKO_TEST_PASS();
+}
+
+void LayeredConfigurationTests::FlattenTest2(Test& test)
+{
+    Configuration base;
+    base.set(Configuration::Path("database.host"), "db.example.com");
+    base.set(Configuration::Path("server.port"), "80");
+    Configuration overrides;
+    overrides.set(Configuration::Path("server.port"), "8080");
+
+    LayeredConfiguration configuration(std::vector<Configuration>({base, overrides}));
+    Configuration flattened = configuration.flatten();
+
+    // The nested configuration that only the base has is shared, not copied
+    ISHIKO_TEST_FAIL_IF_NOT(
+        flattened.value("database").asConfiguration().isSharedWith(base.value("database").asConfiguration()));
+    ISHIKO_TEST_FAIL_IF_NEQ(flattened.value(Configuration::Path("server.port")).asString(), "8080");
+
+    // A single layer is returned as is
+    LayeredConfiguration single(std::vector<Configuration>({base, Configuration()}));
+
+    ISHIKO_TEST_FAIL_IF_NOT(single.flatten().isSharedWith(base));
+    ISHIKO_TEST_PASS();
+}
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_LAYEREDCONFIGURATIONTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_LAYEREDCONFIGURATIONTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class LayeredConfigurationTests : public Ishiko::TestSequence
+{
+public:
+    LayeredConfigurationTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void PushTest1(Ishiko::Test& test);
+    static void ValueTest1(Ishiko::Test& test);
+    static void ValueTest2(Ishiko::Test& test);
+    static void ValueOrDefaultTest1(Ishiko::Test& test);
+    static void ValueOrDefaultTest2(Ishiko::Test& test);
+    static void SubtreeTest1(Ishiko::Test& test);
+    static void SubtreeTest2(Ishiko::Test& test);
+    static void FlattenTest1(Ishiko::Test& test);
+    static void FlattenTest2(Ishiko::Test& test);
+};
+
+#endif
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#include "PerfectHashIndexTests.hpp"
+#include "Ishiko/Configuration/PerfectHashIndex.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Ishiko;
+
+PerfectHashIndexTests::PerfectHashIndexTests(const TestNumber& number, const TestContext& context)
+    : TestSequence(number, "PerfectHashIndex tests", context)
+{
+    append<HeapAllocationErrorsTest>("Constructor test 1", ConstructorTest1);
+    append<HeapAllocationErrorsTest>("Constructor test 2", ConstructorTest2);
+    append<HeapAllocationErrorsTest>("find test 1", FindTest1);
+    append<HeapAllocationErrorsTest>("find test 2", FindTest2);
+}
+
+void PerfectHashIndexTests::ConstructorTest1(Test& test)
+{
+    PerfectHashIndex index;
+
+    ISHIKO_TEST_FAIL_IF_NEQ(index.find(PerfectHashIndex::Hash("key", index.seed())), PerfectHashIndex::npos);
+    ISHIKO_TEST_PASS();
+}
+
+void PerfectHashIndexTests::ConstructorTest2(Test& test)
+{
+    std::vector<std::string> keys = {"key1", "key1"};
+
+    bool thrown = false;
+    try
+    {
+        PerfectHashIndex index(keys.size(),
+            [&keys](size_t i, uint64_t seed)
+            {
+                return PerfectHashIndex::Hash(keys[i], seed);
+            });
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+
+    ISHIKO_TEST_FAIL_IF_NOT(thrown);
+    ISHIKO_TEST_PASS();
+}
+
+void PerfectHashIndexTests::FindTest1(Test& test)
+{
+    std::vector<std::string> keys = {"key1", "key2", "key3"};
+
+    PerfectHashIndex index(keys.size(),
+        [&keys](size_t i, uint64_t seed)
+        {
+            return PerfectHashIndex::Hash(keys[i], seed);
+        });
+
+    ISHIKO_TEST_FAIL_IF_NEQ(index.find(PerfectHashIndex::Hash("key1", index.seed())), 0);
+    ISHIKO_TEST_FAIL_IF_NEQ(index.find(PerfectHashIndex::Hash("key2", index.seed())), 1);
+    ISHIKO_TEST_FAIL_IF_NEQ(index.find(PerfectHashIndex::Hash("key3", index.seed())), 2);
+    ISHIKO_TEST_PASS();
+}
+
+void PerfectHashIndexTests::FindTest2(Test& test)
+{
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        keys.push_back("key" + std::to_string(i));
+    }
+
+    PerfectHashIndex index(keys.size(),
+        [&keys](size_t i, uint64_t seed)
+        {
+            return PerfectHashIndex::Hash(keys[i], seed);
+        });
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        ISHIKO_TEST_ABORT_IF_NEQ(index.find(PerfectHashIndex::Hash(keys[i], index.seed())), i);
+    }
+    ISHIKO_TEST_PASS();
+}
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2000-2024 Xavier Leclercq
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_PERFECTHASHINDEXTESTS_HPP
+#define GUARD_ISHIKO_CPP_CONFIGURATION_TESTS_PERFECTHASHINDEXTESTS_HPP
+
+#include <Ishiko/TestFramework/Core.hpp>
+
+class PerfectHashIndexTests : public Ishiko::TestSequence
+{
+public:
+    PerfectHashIndexTests(const Ishiko::TestNumber& number, const Ishiko::TestContext& context);
+
+private:
+    static void ConstructorTest1(Ishiko::Test& test);
+    static void ConstructorTest2(Ishiko::Test& test);
+    static void FindTest1(Ishiko::Test& test);
+    static void FindTest2(Ishiko::Test& test);
+};
+
+#endif
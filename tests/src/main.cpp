@@ -3,7 +3,20 @@
 
 #include "CommandLineParserTests.hpp"
 #include "CommandLineSpecificationTests.hpp"
+#include "CompiledCommandLineSpecificationTests.hpp"
+#include "ConfigurationArenaTests.hpp"
+#include "ConfigurationFileWatcherTests.hpp"
+#include "ConfigurationPatchTests.hpp"
+#include "ConfigurationSnapshotTests.hpp"
+#include "ConfigurationStoreTests.hpp"
+#include "ConfigurationSubscriptionsTests.hpp"
 #include "ConfigurationTests.hpp"
+#include "DefaultedConfigurationTests.hpp"
+#include "EnvironmentParserTests.hpp"
+#include "INIConfigurationParserTests.hpp"
+#include "JSONConfigurationParserTests.hpp"
+#include "LayeredConfigurationTests.hpp"
+#include "PerfectHashIndexTests.hpp"
 #include "Ishiko/Configuration/linkoptions.hpp"
 #include <Ishiko/TestFramework/Core.hpp>
 
@@ -15,8 +28,21 @@ int main(int argc, char* argv[])
 
     TestSequence& theTests = theTestHarness.tests();
     theTests.append<ConfigurationTests>();
+    theTests.append<ConfigurationArenaTests>();
+    theTests.append<ConfigurationStoreTests>();
+    theTests.append<ConfigurationFileWatcherTests>();
+    theTests.append<ConfigurationSubscriptionsTests>();
+    theTests.append<ConfigurationPatchTests>();
+    theTests.append<ConfigurationSnapshotTests>();
+    theTests.append<LayeredConfigurationTests>();
+    theTests.append<JSONConfigurationParserTests>();
+    theTests.append<INIConfigurationParserTests>();
+    theTests.append<PerfectHashIndexTests>();
     theTests.append<CommandLineSpecificationTests>();
+    theTests.append<CompiledCommandLineSpecificationTests>();
     theTests.append<CommandLineParserTests>();
+    theTests.append<DefaultedConfigurationTests>();
+    theTests.append<EnvironmentParserTests>();
 
     return theTestHarness.run();
 }